@@ -112,8 +112,16 @@ OATPP_MACRO_API_CONTROLLER_HEADER_INFO_CHOOSER_EXP(TYPE, NAME, PARAM_LIST, OATPP
 
 // PATH MACRO // ------------------------------------------------------
 
+// Slot of the variable in the endpoint path is resolved once and then read from the request's MatchMap by index.
+// Falls back to lookup by name if variable is not stored inline (see MatchMap::INLINE_CAPACITY).
+#define OATPP_MACRO_API_CONTROLLER_PATH_SLOT(NAME, LABEL) \
+static const v_int32 __param_slot_##NAME = \
+  oatpp::web::url::mapping::Pattern::parse(__endpointPath)->getVariableSlot(LABEL); \
+auto __param_str_val_##NAME = __param_slot_##NAME >= 0 ? \
+  __request->getPathVariableAt(__param_slot_##NAME) : __request->getPathVariable(LABEL);
+
 #define OATPP_MACRO_API_CONTROLLER_PATH_0(TYPE, NAME, PARAM_LIST) \
-auto __param_str_val_##NAME = __request->getPathVariable(#NAME); \
+OATPP_MACRO_API_CONTROLLER_PATH_SLOT(NAME, #NAME) \
 if(!__param_str_val_##NAME){ \
   return ApiController::handleError(Status::CODE_400, "Missing PATH parameter '" #NAME "'"); \
 } \
@@ -124,7 +132,7 @@ if(!__param_validation_check_##NAME){ \
 }
 
 #define OATPP_MACRO_API_CONTROLLER_PATH_1(TYPE, NAME, PARAM_LIST) \
-auto __param_str_val_##NAME = __request->getPathVariable(OATPP_MACRO_FIRSTARG PARAM_LIST); \
+OATPP_MACRO_API_CONTROLLER_PATH_SLOT(NAME, OATPP_MACRO_FIRSTARG PARAM_LIST) \
 if(!__param_str_val_##NAME){ \
   return ApiController::handleError(Status::CODE_400, \
   oatpp::String("Missing PATH parameter '") + OATPP_MACRO_FIRSTARG PARAM_LIST + "'"); \
@@ -296,6 +304,8 @@ OATPP_MACRO_API_CONTROLLER_ENDPOINT_DECL_1(NAME, METHOD, PATH, LIST) \
 std::shared_ptr<oatpp::web::protocol::http::outgoing::Response> \
 Z__PROXY_METHOD_##NAME(const std::shared_ptr<oatpp::web::protocol::http::incoming::Request>& __request) \
 { \
+  const oatpp::String& __endpointPath = Z__ENDPOINT_##NAME->info->path; \
+  (void) __endpointPath; \
   OATPP_MACRO_FOREACH(OATPP_MACRO_API_CONTROLLER_FOR_EACH_PARAM_PUT, LIST) \
   return NAME( \
     OATPP_MACRO_FOREACH_FIRST_AND_REST( \
@@ -51,6 +51,10 @@ public: \
   static ObjectWrapper createShared(){ \
     return ObjectWrapper(SHARED_DTO_OBJECT_POOL_##TYPE_NAME::allocateShared()); \
   } \
+\
+  static ObjectWrapper createShared(oatpp::base::memory::Arena& arena){ \
+    return ObjectWrapper(oatpp::base::memory::arenaAllocateShared<TYPE_NAME>(arena)); \
+  } \
 \
   static oatpp::data::mapping::type::Type::Properties* Z__CLASS_GET_FIELDS_MAP(){ \
     static oatpp::data::mapping::type::Type::Properties map = oatpp::data::mapping::type::Type::Properties(); \
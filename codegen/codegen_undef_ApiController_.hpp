@@ -63,6 +63,7 @@
 
 // PATH MACRO // ------------------------------------------------------
 
+#undef OATPP_MACRO_API_CONTROLLER_PATH_SLOT
 #undef OATPP_MACRO_API_CONTROLLER_PATH_0
 #undef OATPP_MACRO_API_CONTROLLER_PATH_1
 #undef OATPP_MACRO_API_CONTROLLER_PATH_CHOOSER
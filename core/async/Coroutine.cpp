@@ -26,6 +26,8 @@
 
 namespace oatpp { namespace async {
   
+const char* const Error::ERROR_TIMEOUT = "ERROR_TIMEOUT";
+  
 const Action Action::_WAIT_RETRY(TYPE_WAIT_RETRY, nullptr, nullptr);
 const Action Action::_REPEAT(TYPE_REPEAT, nullptr, nullptr);
 const Action Action::_FINISH(TYPE_FINISH, nullptr, nullptr);
@@ -38,6 +40,9 @@ Action::Action(v_int32 type,
   , m_coroutine(coroutine)
   , m_functionPtr(functionPtr)
   , m_error(Error(nullptr))
+  , m_ioHandle(-1)
+  , m_ioEventType(IO_EVENT_READ)
+  , m_timePoint(0)
 {}
 
 Action::Action(const Error& error)
@@ -45,11 +50,30 @@ Action::Action(const Error& error)
   , m_coroutine(nullptr)
   , m_functionPtr(nullptr)
   , m_error(error)
+  , m_ioHandle(-1)
+  , m_ioEventType(IO_EVENT_READ)
+  , m_timePoint(0)
 {}
 
 bool Action::isError(){
   return m_type == TYPE_ERROR;
 }
+  
+Action Action::createIOWaitAction(oatpp::os::io::Library::v_handle ioHandle,
+                                  v_int32 ioEventType,
+                                  v_int64 timeoutTimePoint) {
+  Action action(TYPE_IO_WAIT, nullptr, nullptr);
+  action.m_ioHandle = ioHandle;
+  action.m_ioEventType = ioEventType;
+  action.m_timePoint = timeoutTimePoint;
+  return action;
+}
+  
+Action Action::createWaitUntilAction(v_int64 timePoint) {
+  Action action(TYPE_WAIT_UNTIL, nullptr, nullptr);
+  action.m_timePoint = timePoint;
+  return action;
+}
 
 void Action::free() {
   if(m_coroutine != nullptr) {
@@ -28,13 +28,20 @@
 #include "oatpp/core/collection/FastQueue.hpp"
 #include "oatpp/core/base/memory/MemoryPool.hpp"
 #include "oatpp/core/base/Environment.hpp"
+#include "oatpp/core/os/io/Library.hpp"
 
 namespace oatpp { namespace async {
 
 class AbstractCoroutine; // FWD
 class Processor; // FWD
+class TimerWheel; // FWD
   
 class Error {
+public:
+  /**
+   * Message of the error passed to handleError() when coroutine wait deadline expired.
+   */
+  static const char* const ERROR_TIMEOUT;
 public:
 
   Error(const char* pMessage, bool pIsExceptionThrown = false)
@@ -60,6 +67,11 @@ public:
   static constexpr const v_int32 TYPE_FINISH = 4;
   static constexpr const v_int32 TYPE_ABORT = 5;
   static constexpr const v_int32 TYPE_ERROR = 6;
+  static constexpr const v_int32 TYPE_IO_WAIT = 7;
+  static constexpr const v_int32 TYPE_WAIT_UNTIL = 8;
+public:
+  static constexpr const v_int32 IO_EVENT_READ = 0;
+  static constexpr const v_int32 IO_EVENT_WRITE = 1;
 public:
   static const Action _WAIT_RETRY;
   static const Action _REPEAT;
@@ -70,6 +82,9 @@ private:
   AbstractCoroutine* m_coroutine;
   FunctionPtr m_functionPtr;
   Error m_error;
+  oatpp::os::io::Library::v_handle m_ioHandle;
+  v_int32 m_ioEventType;
+  v_int64 m_timePoint;
 protected:
   void free();
 public:
@@ -81,11 +96,29 @@ public:
   Action(const Error& error);
   bool isError();
   
+  /**
+   * Create action to suspend coroutine until OS reports that @ioHandle is ready for @ioEventType.
+   * ioEventType - one of (IO_EVENT_READ, IO_EVENT_WRITE).
+   * If Processor has no IO poller available such action is treated as WAIT_RETRY.
+   * timeoutTimePoint - absolute time in microseconds (see Environment::getMicroTickCount()), 0 - no timeout.
+   * If handle is not ready by timeoutTimePoint, coroutine receives Error::ERROR_TIMEOUT in handleError().
+   */
+  static Action createIOWaitAction(oatpp::os::io::Library::v_handle ioHandle,
+                                   v_int32 ioEventType,
+                                   v_int64 timeoutTimePoint = 0);
+  
+  /**
+   * Create action to suspend coroutine and call current function again
+   * not earlier than @timePoint (microseconds, see Environment::getMicroTickCount()).
+   */
+  static Action createWaitUntilAction(v_int64 timePoint);
+  
 };
   
 class AbstractCoroutine {
   friend oatpp::collection::FastQueue<AbstractCoroutine>;
   friend Processor;
+  friend TimerWheel;
 public:
   typedef oatpp::async::Action Action;
   typedef Action (AbstractCoroutine::*FunctionPtr)();
@@ -113,6 +146,14 @@ private:
   FunctionPtr _FP = &AbstractCoroutine::act;
   AbstractCoroutine* _ref = nullptr;
   
+  /* Processor bookkeeping for suspended coroutine */
+  AbstractCoroutine* _timerPrev = nullptr;
+  AbstractCoroutine* _timerNext = nullptr;
+  AbstractCoroutine** _timerSlot = nullptr;
+  v_int64 _timerTick = 0;
+  v_int64 _waitDeadline = 0;
+  oatpp::os::io::Library::v_handle _ioHandle = -1;
+  
   Action takeAction(const Action& action){
     
     switch (action.m_type) {
@@ -284,6 +325,24 @@ public:
     return Action::_WAIT_RETRY;
   }
   
+  Action ioWait(oatpp::os::io::Library::v_handle ioHandle, v_int32 ioEventType, v_int64 timeoutTimePoint = 0) const {
+    return Action::createIOWaitAction(ioHandle, ioEventType, timeoutTimePoint);
+  }
+  
+  /**
+   * Call current function again not earlier than @timePoint (microseconds)
+   */
+  Action waitUntil(v_int64 timePoint) const {
+    return Action::createWaitUntilAction(timePoint);
+  }
+  
+  /**
+   * Call current function again after @duration (microseconds)
+   */
+  Action waitFor(v_int64 duration) const {
+    return Action::createWaitUntilAction(oatpp::base::Environment::getMicroTickCount() + duration);
+  }
+  
   const Action& repeat() const {
     return Action::_REPEAT;
   }
@@ -338,6 +397,24 @@ public:
     return Action::_WAIT_RETRY;
   }
   
+  Action ioWait(oatpp::os::io::Library::v_handle ioHandle, v_int32 ioEventType, v_int64 timeoutTimePoint = 0) const {
+    return Action::createIOWaitAction(ioHandle, ioEventType, timeoutTimePoint);
+  }
+  
+  /**
+   * Call current function again not earlier than @timePoint (microseconds)
+   */
+  Action waitUntil(v_int64 timePoint) const {
+    return Action::createWaitUntilAction(timePoint);
+  }
+  
+  /**
+   * Call current function again after @duration (microseconds)
+   */
+  Action waitFor(v_int64 duration) const {
+    return Action::createWaitUntilAction(oatpp::base::Environment::getMicroTickCount() + duration);
+  }
+  
   const Action& repeat() const {
     return Action::_REPEAT;
   }
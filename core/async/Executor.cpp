@@ -26,14 +26,131 @@
 
 namespace oatpp { namespace async {
   
+void Executor::SubmissionProcessor::startTask(TaskSubmission* task) {
+  m_processor.addWaitingCoroutine(task->createCoroutine());
+  task->free();
+}
+  
 void Executor::SubmissionProcessor::consumeTasks() {
+  
+  TaskSubmission* task;
+  
+  if(!m_workStealing) {
+    while((task = m_pendingTasks.pop()) != nullptr) {
+      startTask(task);
+    }
+    return;
+  }
+  
+  /* Move submitted tasks to the list visible to other processors */
   oatpp::concurrency::SpinLock lock(m_atom);
-  auto curr = m_pendingTasks.getFirstNode();
-  while (curr != nullptr) {
-    m_processor.addWaitingCoroutine(curr->getData()->createCoroutine());
-    curr = curr->getNext();
+  while((task = m_pendingTasks.pop()) != nullptr) {
+    if(task->pinned) {
+      startTask(task);
+    } else {
+      m_stealableTasks.pushBack(task);
+      m_stealableTasksCount ++;
+    }
   }
-  m_pendingTasks.clear();
+  
+  v_int32 count = m_stealableTasksCount;
+  v_int32 take = count;
+  
+  if(m_isBusy && hasIdleSiblings()) {
+    /* Leave half of the tasks to idle processors. Tasks which were not stolen since last round are taken anyway */
+    take = count / 2;
+    if(take < m_tasksOffered) {
+      take = m_tasksOffered < count ? m_tasksOffered : count;
+    }
+  }
+  
+  for(v_int32 i = 0; i < take; i ++) {
+    startTask(m_stealableTasks.popFront());
+  }
+  m_stealableTasksCount -= take;
+  m_tasksOffered = count - take;
+  
+}
+  
+bool Executor::SubmissionProcessor::takeOfferedTasks() {
+  oatpp::concurrency::SpinLock lock(m_atom);
+  if(m_stealableTasksCount == 0) {
+    return false;
+  }
+  while (m_stealableTasks.first != nullptr) {
+    startTask(m_stealableTasks.popFront());
+  }
+  m_stealableTasksCount = 0;
+  m_tasksOffered = 0;
+  return true;
+}
+  
+bool Executor::SubmissionProcessor::hasIdleSiblings() {
+  for(v_int32 i = 1; i < m_siblingsCount; i ++) {
+    if(m_siblings[(m_index + i) % m_siblingsCount]->isIdle()) {
+      return true;
+    }
+  }
+  return false;
+}
+  
+v_int32 Executor::SubmissionProcessor::giveTasks(Tasks& toList) {
+  oatpp::concurrency::SpinLock lock(m_atom);
+  v_int32 count = (m_stealableTasksCount + 1) / 2;
+  for(v_int32 i = 0; i < count; i ++) {
+    toList.pushBack(m_stealableTasks.popFront());
+  }
+  m_stealableTasksCount -= count;
+  if(m_tasksOffered > m_stealableTasksCount) {
+    m_tasksOffered = m_stealableTasksCount;
+  }
+  return count;
+}
+  
+bool Executor::SubmissionProcessor::stealTasks() {
+  
+  Tasks stolenTasks;
+  for(v_int32 i = 1; i < m_siblingsCount; i ++) {
+    auto& victim = m_siblings[(m_index + i) % m_siblingsCount];
+    if(victim->giveTasks(stolenTasks) > 0) {
+      break;
+    }
+  }
+  
+  if(stolenTasks.first == nullptr) {
+    return false;
+  }
+  
+  /* Coroutines are created on the thief's thread, as coroutine memory is thread-local */
+  while (stolenTasks.first != nullptr) {
+    startTask(stolenTasks.popFront());
+  }
+  return true;
+  
+}
+  
+void Executor::SubmissionProcessor::waitForEvents() {
+  
+  if(m_processor.canWaitForIOEvents()) {
+    /* New task submission interrupts the wait via processor's eventfd.
+     * Slow queue may contain NON-IO tasks, so don't wait long while it's not empty */
+    m_processor.waitForIOEvents(m_processor.hasWaitingCoroutines() ? 10 : 500);
+    return;
+  }
+  
+  std::unique_lock<std::mutex> lock(m_taskMutex);
+  if(!m_pendingTasks.isEmpty()) {
+    return;
+  }
+  if(m_processor.isEmpty()) {
+    /* No tasks in the processor. Wait for incoming connections */
+    m_taskCondition.wait_for(lock, std::chrono::milliseconds(500));
+  } else {
+    /* There is still something in slow queue. Wait and get back to processing */
+    /* Waiting for IO is not Applicable here as slow queue may contain NON-IO tasks */
+    m_taskCondition.wait_for(lock, std::chrono::milliseconds(10));
+  }
+  
 }
 
 void Executor::SubmissionProcessor::run(){
@@ -44,21 +161,38 @@ void Executor::SubmissionProcessor::run(){
     consumeTasks();
     
     /* Process all, and check for incoming connections once in 1000 iterations */
-    while (m_processor.iterate(1000)) {
+    /* In work-stealing mode rounds start short and grow while processor is not busy */
+    v_int32 roundIterations = m_workStealing ? BUSY_ROUND_ITERATIONS : 1000;
+    v_int64 roundStart = oatpp::base::Environment::getMicroTickCount();
+    while (m_processor.iterate(roundIterations)) {
+      v_int64 now = oatpp::base::Environment::getMicroTickCount();
+      m_isBusy = (now - roundStart) * 1000 > BUSY_ROUND_MICROS * roundIterations;
+      if(m_workStealing) {
+        if(m_isBusy) {
+          roundIterations = BUSY_ROUND_ITERATIONS;
+        } else if(roundIterations < 1000) {
+          roundIterations *= 2;
+        }
+      }
+      roundStart = now;
       consumeTasks();
     }
+    m_isBusy = false;
     
-    std::unique_lock<std::mutex> lock(m_taskMutex);
-    if(m_processor.isEmpty()) {
-      /* No tasks in the processor. Wait for incoming connections */
-      m_taskCondition.wait_for(lock, std::chrono::milliseconds(500));
-    } else {
-      /* There is still something in slow queue. Wait and get back to processing */
-      /* Waiting for IO is not Applicable here as slow queue may contain NON-IO tasks */
-      //OATPP_LOGD("proc", "waiting slow queue");
-      m_taskCondition.wait_for(lock, std::chrono::milliseconds(10));
+    /* Tasks offered to siblings during busy rounds and not stolen yet are started here. Otherwise they would wait for the next event */
+    if(m_workStealing && (takeOfferedTasks() || stealTasks())) {
+      continue;
+    }
+    
+    m_isIdle = true;
+    
+    /* Producer checks m_isIdle after push. Check the queue after m_isIdle is set so that no wake up is missed */
+    if(m_pendingTasks.isEmpty()) {
+      waitForEvents();
     }
     
+    m_isIdle = false;
+    
   }
   
 }
@@ -30,9 +30,11 @@
 #include "oatpp/core/concurrency/SpinLock.hpp"
 #include "oatpp/core/concurrency/Thread.hpp"
 
-#include "oatpp/core/collection/LinkedList.hpp"
+#include "oatpp/core/collection/MPSCQueue.hpp"
+#include "oatpp/core/collection/FastQueue.hpp"
 
 #include <tuple>
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 
@@ -41,10 +43,22 @@ namespace oatpp { namespace async {
 class Executor {
 private:
   
-  class TaskSubmission {
+  class TaskSubmission : public oatpp::collection::MPSCQueue<TaskSubmission>::Node {
+    friend oatpp::collection::FastQueue<TaskSubmission>;
+  private:
+    TaskSubmission* _ref = nullptr;
+  public:
+    /**
+     * Pinned task is never stolen by other processors.
+     */
+    bool pinned = false;
   public:
     virtual ~TaskSubmission() {};
     virtual AbstractCoroutine* createCoroutine() = 0;
+    
+    void free() {
+      delete this;
+    }
   };
   
   /**
@@ -61,8 +75,70 @@ private:
     typedef IndexSequence<S...> type;
   };
   
+  /**
+   * Lock-free pool of submission entries of type T.
+   * Submitting thread obtains entries from its thread-local free list.
+   * Processor thread returns freed entries to the shared stack.
+   * When local list is empty, the submitting thread takes the whole shared stack with one exchange -
+   * entries are never popped from the shared stack one by one, so there is no ABA problem.
+   * Memory is never released, same as for other pools.
+   */
+  template<typename T>
+  class SubmissionPool {
+  private:
+    
+    struct FreeEntry {
+      FreeEntry* next;
+    };
+    
+    static std::atomic<FreeEntry*>& getReturnedEntries() {
+      static std::atomic<FreeEntry*> entries(nullptr);
+      return entries;
+    }
+    
+    static FreeEntry*& getLocalEntries() {
+      static thread_local FreeEntry* entries = nullptr;
+      return entries;
+    }
+    
+  public:
+    
+    static void* obtain() {
+      FreeEntry*& entries = getLocalEntries();
+      if(entries == nullptr) {
+        entries = getReturnedEntries().exchange(nullptr, std::memory_order_acquire);
+      }
+      if(entries != nullptr) {
+        FreeEntry* entry = entries;
+        entries = entry->next;
+        return entry;
+      }
+      return ::operator new(sizeof(T) > sizeof(FreeEntry) ? sizeof(T) : sizeof(FreeEntry));
+    }
+    
+    static void free(void* ptr) {
+      FreeEntry* entry = static_cast<FreeEntry*>(ptr);
+      auto& returned = getReturnedEntries();
+      FreeEntry* head = returned.load(std::memory_order_relaxed);
+      do {
+        entry->next = head;
+      } while(!returned.compare_exchange_weak(head, entry, std::memory_order_release, std::memory_order_relaxed));
+    }
+    
+  };
+  
   template<typename CoroutineType, typename ... Args>
   class SubmissionTemplate : public TaskSubmission {
+  public:
+    
+    static void* operator new(std::size_t) {
+      return SubmissionPool<SubmissionTemplate>::obtain();
+    }
+    
+    static void operator delete(void* ptr) {
+      SubmissionPool<SubmissionTemplate>::free(ptr);
+    }
+    
   private:
     std::tuple<Args...> m_params;
   public:
@@ -84,21 +160,48 @@ private:
   
   class SubmissionProcessor : public oatpp::concurrency::Runnable {
   private:
-    typedef oatpp::collection::LinkedList<std::shared_ptr<TaskSubmission>> Tasks;
+    typedef oatpp::collection::FastQueue<TaskSubmission> Tasks;
   private:
+    void startTask(TaskSubmission* task);
     void consumeTasks();
+    bool stealTasks();
+    bool takeOfferedTasks();
+    bool hasIdleSiblings();
+    v_int32 giveTasks(Tasks& toList);
+    void waitForEvents();
   private:
     oatpp::async::Processor m_processor;
+    oatpp::collection::MPSCQueue<TaskSubmission> m_pendingTasks;
     oatpp::concurrency::SpinLock::Atom m_atom;
-    Tasks m_pendingTasks;
+    Tasks m_stealableTasks;
+    v_int32 m_stealableTasksCount;
   private:
     bool m_isRunning;
     std::mutex m_taskMutex;
     std::condition_variable m_taskCondition;
+  private:
+    std::shared_ptr<SubmissionProcessor>* m_siblings;
+    v_int32 m_siblingsCount;
+    v_int32 m_index;
+    bool m_workStealing;
+    std::atomic<bool> m_isBusy;
+    std::atomic<bool> m_isIdle;
+    v_int32 m_tasksOffered;
   public:
-    SubmissionProcessor()
+    SubmissionProcessor(std::shared_ptr<SubmissionProcessor>* siblings,
+                        v_int32 siblingsCount,
+                        v_int32 index,
+                        bool workStealing)
       : m_atom(false)
+      , m_stealableTasksCount(0)
       , m_isRunning(true)
+      , m_siblings(siblings)
+      , m_siblingsCount(siblingsCount)
+      , m_index(index)
+      , m_workStealing(workStealing)
+      , m_isBusy(false)
+      , m_isIdle(false)
+      , m_tasksOffered(0)
     {}
   public:
     
@@ -108,30 +211,87 @@ private:
       m_isRunning = false;
     }
     
-    void addTaskSubmission(const std::shared_ptr<TaskSubmission>& task){
-      oatpp::concurrency::SpinLock lock(m_atom);
-      m_pendingTasks.pushBack(task);
-      m_taskCondition.notify_one();
+    /**
+     * Thread-safe. Lock-free unless processor is idle and OS has no eventfd (see wakeUp()).
+     */
+    void addTaskSubmission(TaskSubmission* task){
+      m_pendingTasks.push(task);
+      if(m_isIdle) {
+        wakeUp();
+      }
+    }
+    
+    /**
+     * Interrupt waiting processor. Uses eventfd of the processor's IO poller if available.
+     */
+    void wakeUp() {
+      if(m_processor.canWaitForIOEvents()) {
+        m_processor.wakeUp();
+      } else {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        m_taskCondition.notify_one();
+      }
+    }
+    
+    /**
+     * true if last processing round was slower than BUSY_ROUND_MICROS per 1000 iterations
+     */
+    bool isBusy() const {
+      return m_isBusy;
+    }
+    
+    /**
+     * true if processor has no runnable coroutines and waits for events
+     */
+    bool isIdle() const {
+      return m_isIdle;
     }
     
   };
   
+public:
+  /**
+   * Each new task is pinned to the next processor in turn.
+   */
+  static constexpr v_int32 BALANCER_ROUND_ROBIN = 0;
+  /**
+   * New tasks are queued to the next processor in turn.
+   * Busy processors leave part of their queued tasks to idle processors which steal them,
+   * and check for new tasks every BUSY_ROUND_ITERATIONS iterations.
+   * Coroutines are never moved between threads once started - only not yet started tasks are stolen.
+   * Coroutines already running on a loaded processor stay there, so a queue of long-running coroutines is not rebalanced.
+   */
+  static constexpr v_int32 BALANCER_WORK_STEALING = 1;
+  /**
+   * Processor is busy if 1000 iterations take longer than this value.
+   */
+  static constexpr v_int64 BUSY_ROUND_MICROS = 1000;
+  /**
+   * Number of iterations in a processing round of busy processor in work-stealing mode.
+   */
+  static constexpr v_int32 BUSY_ROUND_ITERATIONS = 10;
 private:
   v_int32 m_threadsCount;
+  v_int32 m_balancerType;
   std::shared_ptr<oatpp::concurrency::Thread>* m_threads;
   std::shared_ptr<SubmissionProcessor>* m_processors;
   std::atomic<v_word32> m_balancer;
 public:
   
-  Executor(v_int32 threadsCount)
+  Executor(v_int32 threadsCount, v_int32 balancerType = BALANCER_ROUND_ROBIN)
     : m_threadsCount(threadsCount)
+    , m_balancerType(balancerType)
     , m_threads(new std::shared_ptr<oatpp::concurrency::Thread>[m_threadsCount])
     , m_processors(new std::shared_ptr<SubmissionProcessor>[m_threadsCount])
+    , m_balancer(0)
   {
     for(v_int32 i = 0; i < m_threadsCount; i ++) {
-      auto processor = std::make_shared<SubmissionProcessor>();
-      m_processors[i] = processor;
-      m_threads[i] = oatpp::concurrency::Thread::createShared(processor);
+      m_processors[i] = std::make_shared<SubmissionProcessor>(m_processors, m_threadsCount, i,
+                                                              m_balancerType == BALANCER_WORK_STEALING);
+    }
+    /* All processors must be created before threads start as they may access each other */
+    for(v_int32 i = 0; i < m_threadsCount; i ++) {
+      m_threads[i] = oatpp::concurrency::Thread::createShared(m_processors[i]);
     }
   }
   
@@ -158,14 +318,35 @@ public:
     }
   }
   
+  /**
+   * Start coroutine on processor @processorIndex. Task is not balanced nor stolen.
+   * Used to keep connection on the thread which accepted it.
+   */
+  template<typename CoroutineType, typename ... Args>
+  void executeOn(v_int32 processorIndex, Args... params) {
+    auto task = new SubmissionTemplate<CoroutineType, Args...>(params...);
+    task->pinned = true;
+    m_processors[processorIndex % m_threadsCount]->addTaskSubmission(task);
+  }
+  
+  v_int32 getThreadsCount() const {
+    return m_threadsCount;
+  }
+  
   template<typename CoroutineType, typename ... Args>
   void execute(Args... params) {
-    auto processor = m_processors[m_balancer % m_threadsCount];
-    
-    auto submission = std::make_shared<SubmissionTemplate<CoroutineType, Args...>>(params...);
-    processor->addTaskSubmission(submission);
+    auto& processor = m_processors[(m_balancer ++) % m_threadsCount];
+    processor->addTaskSubmission(new SubmissionTemplate<CoroutineType, Args...>(params...));
     
-    m_balancer ++;
+    if(m_balancerType == BALANCER_WORK_STEALING && processor->isBusy()) {
+      /* Let idle processor steal the task */
+      for(v_int32 i = 0; i < m_threadsCount; i ++) {
+        if(m_processors[i]->isIdle()) {
+          m_processors[i]->wakeUp();
+          break;
+        }
+      }
+    }
   }
   
 };
@@ -0,0 +1,210 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "IOEventPoller.hpp"
+
+#if defined(__linux__)
+  #include <sys/epoll.h>
+  #include <sys/eventfd.h>
+  #include <unistd.h>
+  #include <errno.h>
+#endif
+
+namespace oatpp { namespace async {
+  
+#if defined(__linux__)
+
+IOEventPoller::IOEventPoller()
+  : m_pollerHandle(epoll_create1(EPOLL_CLOEXEC))
+  , m_wakeUpHandle(-1)
+  , m_count(0)
+{
+  if(m_pollerHandle < 0) {
+    OATPP_LOGD("[oatpp::async::IOEventPoller::IOEventPoller()]", "Warning. Can't create epoll instance. Falling back to WAIT_RETRY");
+    return;
+  }
+  m_wakeUpHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(m_wakeUpHandle >= 0) {
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = m_wakeUpHandle;
+    epoll_ctl(m_pollerHandle, EPOLL_CTL_ADD, m_wakeUpHandle, &event);
+  }
+}
+
+IOEventPoller::~IOEventPoller() {
+  for(auto coroutine : m_coroutines) {
+    if(coroutine != nullptr) {
+      coroutine->free();
+    }
+  }
+  if(m_wakeUpHandle >= 0) {
+    ::close(m_wakeUpHandle);
+  }
+  if(m_pollerHandle >= 0) {
+    ::close(m_pollerHandle);
+  }
+}
+  
+bool IOEventPoller::registerHandle(oatpp::os::io::Library::v_handle handle, v_int32 ioEventType) {
+  
+  struct epoll_event event;
+  event.events = EPOLLONESHOT | EPOLLRDHUP;
+  if(ioEventType == Action::IO_EVENT_WRITE) {
+    event.events |= EPOLLOUT;
+  } else {
+    event.events |= EPOLLIN;
+  }
+  event.data.fd = handle;
+  
+  /* Handle stays in the epoll set after ONESHOT event. Re-arm it with MOD. */
+  /* If handle was closed and its number reused by OS - it was silently removed from the set. Add it again */
+  if(m_registered[handle]) {
+    if(epoll_ctl(m_pollerHandle, EPOLL_CTL_MOD, handle, &event) == 0) {
+      return true;
+    }
+    if(errno != ENOENT) {
+      return false;
+    }
+  }
+  
+  if(epoll_ctl(m_pollerHandle, EPOLL_CTL_ADD, handle, &event) == 0 ||
+     (errno == EEXIST && epoll_ctl(m_pollerHandle, EPOLL_CTL_MOD, handle, &event) == 0))
+  {
+    m_registered[handle] = true;
+    return true;
+  }
+  
+  return false;
+  
+}
+  
+bool IOEventPoller::park(AbstractCoroutine* coroutine, oatpp::os::io::Library::v_handle handle, v_int32 ioEventType) {
+  
+  if(m_pollerHandle < 0 || handle < 0) {
+    return false;
+  }
+  
+  if(handle >= (v_int32) m_coroutines.size()) {
+    m_coroutines.resize(handle + 1, nullptr);
+    m_registered.resize(handle + 1, false);
+  }
+  
+  if(m_coroutines[handle] != nullptr) {
+    return false; // Another coroutine is already waiting on this handle.
+  }
+  
+  if(!registerHandle(handle, ioEventType)) {
+    return false;
+  }
+  
+  m_coroutines[handle] = coroutine;
+  ++ m_count;
+  return true;
+  
+}
+  
+AbstractCoroutine* IOEventPoller::unpark(oatpp::os::io::Library::v_handle handle) {
+  
+  if(handle < 0 || handle >= (v_int32) m_coroutines.size() || m_coroutines[handle] == nullptr) {
+    return nullptr;
+  }
+  
+  AbstractCoroutine* coroutine = m_coroutines[handle];
+  m_coroutines[handle] = nullptr;
+  -- m_count;
+  
+  struct epoll_event event; // non-null event pointer is required by older kernels
+  epoll_ctl(m_pollerHandle, EPOLL_CTL_DEL, handle, &event);
+  m_registered[handle] = false;
+  
+  return coroutine;
+  
+}
+  
+v_int32 IOEventPoller::poll(oatpp::collection::FastQueue<AbstractCoroutine>& readyQueue, v_int32 timeoutMillis) {
+  
+  if(m_pollerHandle < 0) {
+    return 0;
+  }
+  
+  struct epoll_event events[MAX_EVENTS];
+  v_int32 count = epoll_wait(m_pollerHandle, events, MAX_EVENTS, timeoutMillis);
+  
+  v_int32 result = 0;
+  for(v_int32 i = 0; i < count; i ++) {
+    auto handle = events[i].data.fd;
+    if(handle == m_wakeUpHandle) {
+      eventfd_t value;
+      eventfd_read(m_wakeUpHandle, &value);
+    } else if(handle < (v_int32) m_coroutines.size() && m_coroutines[handle] != nullptr) {
+      readyQueue.pushBack(m_coroutines[handle]);
+      m_coroutines[handle] = nullptr;
+      -- m_count;
+      ++ result;
+    }
+  }
+  
+  return result;
+  
+}
+  
+void IOEventPoller::wakeUp() {
+  if(m_wakeUpHandle >= 0) {
+    eventfd_write(m_wakeUpHandle, 1);
+  }
+}
+  
+#else
+  
+IOEventPoller::IOEventPoller()
+  : m_pollerHandle(-1)
+  , m_wakeUpHandle(-1)
+  , m_count(0)
+{}
+  
+IOEventPoller::~IOEventPoller() {}
+  
+bool IOEventPoller::registerHandle(oatpp::os::io::Library::v_handle handle, v_int32 ioEventType) {
+  return false;
+}
+  
+bool IOEventPoller::park(AbstractCoroutine* coroutine, oatpp::os::io::Library::v_handle handle, v_int32 ioEventType) {
+  return false;
+}
+
+AbstractCoroutine* IOEventPoller::unpark(oatpp::os::io::Library::v_handle handle) {
+  return nullptr;
+}
+  
+v_int32 IOEventPoller::poll(oatpp::collection::FastQueue<AbstractCoroutine>& readyQueue, v_int32 timeoutMillis) {
+  return 0;
+}
+
+void IOEventPoller::wakeUp() {}
+  
+#endif
+  
+}}
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_IOEventPoller_hpp
+#define oatpp_async_IOEventPoller_hpp
+
+#include "./Coroutine.hpp"
+#include "oatpp/core/collection/FastQueue.hpp"
+
+#include <vector>
+
+namespace oatpp { namespace async {
+
+/**
+ * Parks coroutines waiting for IO readiness of OS handles (epoll on Linux).
+ * Parked coroutines cost nothing until kernel reports the handle is ready.
+ * Not thread-safe except for wakeUp(). Each Processor owns its own poller.
+ * On platforms where polling is not available isAvailable() returns false,
+ * and park() always fails so that caller may fall back to WAIT_RETRY behaviour.
+ */
+class IOEventPoller {
+public:
+  static constexpr v_int32 MAX_EVENTS = 256;
+private:
+  oatpp::os::io::Library::v_handle m_pollerHandle;
+  oatpp::os::io::Library::v_handle m_wakeUpHandle;
+  std::vector<AbstractCoroutine*> m_coroutines; // parked coroutines indexed by OS handle
+  std::vector<bool> m_registered; // OS handles that were added to the poller set
+  v_int32 m_count;
+private:
+  bool registerHandle(oatpp::os::io::Library::v_handle handle, v_int32 ioEventType);
+public:
+  
+  IOEventPoller();
+  ~IOEventPoller();
+  
+  /**
+   * true if OS polling facility was successfully initialized
+   */
+  bool isAvailable() const {
+    return m_pollerHandle >= 0;
+  }
+  
+  /**
+   * Park coroutine until @handle is ready for @ioEventType.
+   * Returns false if coroutine can't be parked. Caller retains ownership of coroutine in this case.
+   */
+  bool park(AbstractCoroutine* coroutine, oatpp::os::io::Library::v_handle handle, v_int32 ioEventType);
+  
+  /**
+   * Remove parked coroutine waiting on @handle from the poller without freeing it.
+   * Returns coroutine or nullptr if nothing was parked on @handle.
+   */
+  AbstractCoroutine* unpark(oatpp::os::io::Library::v_handle handle);
+  
+  /**
+   * Wait up to @timeoutMillis for IO events (0 - don't wait, just check).
+   * Coroutines which handles are ready are pushed to @readyQueue.
+   * Returns number of coroutines woken up.
+   */
+  v_int32 poll(oatpp::collection::FastQueue<AbstractCoroutine>& readyQueue, v_int32 timeoutMillis);
+  
+  /**
+   * Interrupt poll() called from another thread. Thread-safe.
+   */
+  void wakeUp();
+  
+  v_int32 getParkedCount() const {
+    return m_count;
+  }
+  
+};
+  
+}}
+
+#endif /* oatpp_async_IOEventPoller_hpp */
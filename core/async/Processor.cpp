@@ -22,16 +22,33 @@
  *
  ***************************************************************************/
 
+
 #include "Processor.hpp"
 
 namespace oatpp { namespace async {
   
 bool Processor::checkWaitingQueue() {
   bool hasActions = false;
+  v_int64 now = 0;
   AbstractCoroutine* curr = m_waitingQueue.first;
   AbstractCoroutine* prev = nullptr;
   while (curr != nullptr) {
-    const Action& action = curr->iterate();
+    
+    Action action = Action::_WAIT_RETRY;
+    if(curr->_waitDeadline > 0) {
+      if(now == 0) {
+        now = oatpp::base::Environment::getMicroTickCount();
+      }
+      if(now >= curr->_waitDeadline) {
+        curr->_waitDeadline = 0;
+        action = curr->takeAction(Action(Error(Error::ERROR_TIMEOUT)));
+      } else {
+        action = curr->iterate();
+      }
+    } else {
+      action = curr->iterate();
+    }
+    
     if(action.m_type == Action::TYPE_ABORT) {
       m_waitingQueue.removeEntry(curr, prev);
       if(prev != nullptr) {
@@ -39,7 +56,21 @@ bool Processor::checkWaitingQueue() {
       } else {
         curr = m_waitingQueue.first;
       }
-    } else if(action.m_type != Action::TYPE_WAIT_RETRY) {
+    } else if(action.m_type == Action::TYPE_WAIT_RETRY ||
+              (action.m_type == Action::TYPE_IO_WAIT && !m_ioPoller.isAvailable()))
+    {
+      curr->_waitDeadline = action.m_timePoint;
+    } else if(action.m_type == Action::TYPE_IO_WAIT || action.m_type == Action::TYPE_WAIT_UNTIL) {
+      AbstractCoroutine* coroutine = curr;
+      m_waitingQueue.cutEntry(curr, prev);
+      schedule(coroutine, action);
+      if(prev != nullptr) {
+        curr = prev;
+      } else {
+        curr = m_waitingQueue.first;
+      }
+    } else {
+      curr->_waitDeadline = 0;
       oatpp::collection::FastQueue<AbstractCoroutine>::moveEntry(m_waitingQueue, m_activeQueue, curr, prev);
       hasActions = true;
       if(prev != nullptr) {
@@ -56,13 +87,73 @@ bool Processor::checkWaitingQueue() {
   }
   return hasActions;
 }
+  
+bool Processor::checkTimers() {
+  
+  if(m_timers.getCount() == 0) {
+    return false;
+  }
+  
+  oatpp::collection::FastQueue<AbstractCoroutine> expiredQueue;
+  if(m_timers.advance(oatpp::base::Environment::getMicroTickCount(), expiredQueue) == 0) {
+    return false;
+  }
+  
+  while (expiredQueue.first != nullptr) {
+    AbstractCoroutine* coroutine = expiredQueue.popFront();
+    if(coroutine->_ioHandle >= 0) {
+      /* IO wait timed out */
+      m_ioPoller.unpark(coroutine->_ioHandle);
+      coroutine->_ioHandle = -1;
+      schedule(coroutine, coroutine->takeAction(Action(Error(Error::ERROR_TIMEOUT))));
+    } else {
+      m_activeQueue.pushBack(coroutine);
+    }
+  }
+  
+  return true;
+  
+}
+  
+bool Processor::pollIOEvents(v_int32 timeoutMillis) {
+  
+  oatpp::collection::FastQueue<AbstractCoroutine> readyQueue;
+  if(m_ioPoller.poll(readyQueue, timeoutMillis) == 0) {
+    return false;
+  }
+  
+  while (readyQueue.first != nullptr) {
+    AbstractCoroutine* coroutine = readyQueue.popFront();
+    coroutine->_ioHandle = -1;
+    m_timers.remove(coroutine);
+    m_activeQueue.pushBack(coroutine);
+  }
+  
+  return true;
+  
+}
 
 bool Processor::considerContinueImmediately() {
   
-  bool hasAction = checkWaitingQueue();
+  bool hasAction = false;
+  if(m_ioPoller.getParkedCount() > 0) {
+    hasAction = pollIOEvents(0);
+  }
+  
+  if(checkTimers()) {
+    hasAction = true;
+  }
+  
+  if(checkWaitingQueue()) {
+    hasAction = true;
+  }
   
   if(hasAction) {
     m_inactivityTick = 0;
+  } else if(m_waitingQueue.first == nullptr) {
+    /* Nothing to re-check. Parked coroutines will be woken by the IO poller or by the timer */
+    m_inactivityTick = 0;
+    return m_activeQueue.first != nullptr;
   } else if(m_inactivityTick == 0) {
     m_inactivityTick = oatpp::base::Environment::getMicroTickCount();
   } else if(oatpp::base::Environment::getMicroTickCount() - m_inactivityTick > 1000 * 100 /* 100 millis */) {
@@ -73,6 +164,36 @@ bool Processor::considerContinueImmediately() {
   
 }
   
+void Processor::schedule(AbstractCoroutine* coroutine, const Action& action) {
+  switch (action.m_type) {
+    case Action::TYPE_WAIT_RETRY:
+      coroutine->_waitDeadline = 0;
+      m_waitingQueue.pushBack(coroutine);
+      break;
+    case Action::TYPE_IO_WAIT:
+      waitIO(coroutine, action);
+      break;
+    case Action::TYPE_WAIT_UNTIL:
+      m_timers.add(coroutine, action.m_timePoint);
+      break;
+    default:
+      m_activeQueue.pushBack(coroutine);
+  }
+}
+  
+void Processor::waitIO(AbstractCoroutine* coroutine, const Action& action) {
+  if(m_ioPoller.park(coroutine, action.m_ioHandle, action.m_ioEventType)) {
+    coroutine->_ioHandle = action.m_ioHandle;
+    if(action.m_timePoint > 0) {
+      m_timers.add(coroutine, action.m_timePoint);
+    }
+  } else {
+    /* Timeout is checked in checkWaitingQueue() */
+    coroutine->_waitDeadline = action.m_timePoint;
+    m_waitingQueue.pushBack(coroutine);
+  }
+}
+  
 void Processor::addCoroutine(AbstractCoroutine* coroutine) {
   m_activeQueue.pushBack(coroutine);
 }
@@ -91,8 +212,11 @@ bool Processor::iterate(v_int32 numIterations) {
     }
     if(!CP->finished()) {
       const Action& action = CP->iterate();
-      if(action.m_type == Action::TYPE_WAIT_RETRY) {
-        m_waitingQueue.pushBack(m_activeQueue.popFront());
+      if(action.m_type == Action::TYPE_WAIT_RETRY ||
+         action.m_type == Action::TYPE_IO_WAIT ||
+         action.m_type == Action::TYPE_WAIT_UNTIL)
+      {
+        schedule(m_activeQueue.popFront(), action);
       } else {
         m_activeQueue.round();
       }
@@ -105,4 +229,13 @@ bool Processor::iterate(v_int32 numIterations) {
   
 }
   
+bool Processor::waitForIOEvents(v_int32 timeoutMillis) {
+  if(!m_ioPoller.isAvailable()) {
+    return false;
+  }
+  timeoutMillis = m_timers.getMillisToNextExpiry(oatpp::base::Environment::getMicroTickCount(), timeoutMillis);
+  pollIOEvents(timeoutMillis);
+  return true;
+}
+  
 }}
@@ -26,6 +26,8 @@
 #define oatpp_async_Processor_hpp
 
 #include "./Coroutine.hpp"
+#include "./IOEventPoller.hpp"
+#include "./TimerWheel.hpp"
 #include "oatpp/core/collection/FastQueue.hpp"
 
 namespace oatpp { namespace async {
@@ -34,11 +36,25 @@ class Processor {
 private:
   
   bool checkWaitingQueue();
+  bool checkTimers();
+  bool pollIOEvents(v_int32 timeoutMillis);
   bool considerContinueImmediately();
   
+  /**
+   * Put coroutine, which is not in any queue, to the queue corresponding to the @action it returned.
+   */
+  void schedule(AbstractCoroutine* coroutine, const Action& action);
+  
+  /**
+   * Park coroutine in the IO poller or put it to the waiting queue if it can't be parked.
+   */
+  void waitIO(AbstractCoroutine* coroutine, const Action& action);
+  
 private:
   oatpp::collection::FastQueue<AbstractCoroutine> m_activeQueue;
   oatpp::collection::FastQueue<AbstractCoroutine> m_waitingQueue;
+  IOEventPoller m_ioPoller;
+  TimerWheel m_timers; // should be destroyed before m_ioPoller
 private:
   v_int64 m_inactivityTick = 0;
 public:
@@ -46,8 +62,34 @@ public:
   void addCoroutine(AbstractCoroutine* coroutine);
   void addWaitingCoroutine(AbstractCoroutine* coroutine);
   bool iterate(v_int32 numIterations);
+  
+  /**
+   * Block until one of parked coroutines is ready for IO, next timer is due, @timeoutMillis elapsed, or wakeUp() called.
+   * Returns false if IO polling is not available and nothing was done.
+   */
+  bool waitForIOEvents(v_int32 timeoutMillis);
+  
+  /**
+   * true if waitForIOEvents() is available on this platform.
+   */
+  bool canWaitForIOEvents() const {
+    return m_ioPoller.isAvailable();
+  }
+  
+  /**
+   * Interrupt waitForIOEvents() from another thread.
+   */
+  void wakeUp() {
+    m_ioPoller.wakeUp();
+  }
+  
+  bool hasWaitingCoroutines() {
+    return m_waitingQueue.first != nullptr;
+  }
+  
   bool isEmpty() {
-    return m_activeQueue.first == nullptr && m_waitingQueue.first == nullptr;
+    return m_activeQueue.first == nullptr && m_waitingQueue.first == nullptr &&
+           m_ioPoller.getParkedCount() == 0 && m_timers.getCount() == 0;
   }
   
 };
@@ -0,0 +1,204 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "TimerWheel.hpp"
+
+namespace oatpp { namespace async {
+  
+TimerWheel::TimerWheel()
+  : m_currentTick(oatpp::base::Environment::getMicroTickCount() / TICK_MICROS)
+  , m_count(0)
+{
+  for(v_int32 level = 0; level < LEVELS_COUNT; level ++) {
+    for(v_int32 i = 0; i < SLOTS_COUNT; i ++) {
+      m_slots[level][i] = nullptr;
+    }
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  for(v_int32 level = 0; level < LEVELS_COUNT; level ++) {
+    for(v_int32 i = 0; i < SLOTS_COUNT; i ++) {
+      AbstractCoroutine* curr = m_slots[level][i];
+      while (curr != nullptr) {
+        AbstractCoroutine* next = curr->_timerNext;
+        /* Coroutines parked on IO are owned (and freed) by IOEventPoller */
+        if(curr->_ioHandle < 0) {
+          curr->free();
+        }
+        curr = next;
+      }
+    }
+  }
+}
+  
+void TimerWheel::insert(AbstractCoroutine* coroutine) {
+  
+  v_int64 tick = coroutine->_timerTick;
+  if(tick < m_currentTick) {
+    tick = m_currentTick;
+  }
+  
+  v_int64 delta = tick - m_currentTick;
+  v_int32 level = 0;
+  while(level < LEVELS_COUNT - 1 && delta >= ((v_int64) 1 << (SLOT_BITS * (level + 1)))) {
+    level ++;
+  }
+  
+  v_int64 levelSpan = (v_int64) 1 << (SLOT_BITS * (level + 1));
+  if(delta >= levelSpan) {
+    /* Too far in future. Park in the last slot of the top level. Will be re-inserted on cascade */
+    tick = m_currentTick + levelSpan - 1;
+  }
+  
+  AbstractCoroutine** slot = &m_slots[level][(tick >> (SLOT_BITS * level)) & (SLOTS_COUNT - 1)];
+  
+  coroutine->_timerSlot = slot;
+  coroutine->_timerPrev = nullptr;
+  coroutine->_timerNext = *slot;
+  if(*slot != nullptr) {
+    (*slot)->_timerPrev = coroutine;
+  }
+  *slot = coroutine;
+  
+}
+
+void TimerWheel::cascade(v_int32 level, v_int32 slot) {
+  AbstractCoroutine* curr = m_slots[level][slot];
+  m_slots[level][slot] = nullptr;
+  while (curr != nullptr) {
+    AbstractCoroutine* next = curr->_timerNext;
+    insert(curr);
+    curr = next;
+  }
+}
+  
+void TimerWheel::add(AbstractCoroutine* coroutine, v_int64 timePoint) {
+  if(m_count == 0) {
+    /* Wheel is not turned while empty. Catch up here, so that next advance() doesn't walk every idle tick */
+    v_int64 tick = oatpp::base::Environment::getMicroTickCount() / TICK_MICROS;
+    if(tick > m_currentTick) {
+      m_currentTick = tick;
+    }
+  }
+  coroutine->_timerTick = (timePoint + TICK_MICROS - 1) / TICK_MICROS;
+  insert(coroutine);
+  ++ m_count;
+}
+
+void TimerWheel::remove(AbstractCoroutine* coroutine) {
+  
+  if(coroutine->_timerSlot == nullptr) {
+    return;
+  }
+  
+  if(coroutine->_timerPrev != nullptr) {
+    coroutine->_timerPrev->_timerNext = coroutine->_timerNext;
+  } else {
+    *coroutine->_timerSlot = coroutine->_timerNext;
+  }
+  if(coroutine->_timerNext != nullptr) {
+    coroutine->_timerNext->_timerPrev = coroutine->_timerPrev;
+  }
+  
+  coroutine->_timerSlot = nullptr;
+  coroutine->_timerPrev = nullptr;
+  coroutine->_timerNext = nullptr;
+  -- m_count;
+  
+}
+  
+v_int32 TimerWheel::advance(v_int64 timePoint, oatpp::collection::FastQueue<AbstractCoroutine>& expiredQueue) {
+  
+  v_int64 tick = timePoint / TICK_MICROS;
+  v_int32 result = 0;
+  
+  while(m_currentTick <= tick) {
+    
+    if(m_count == 0) {
+      m_currentTick = tick + 1;
+      break;
+    }
+    
+    v_int32 index = m_currentTick & (SLOTS_COUNT - 1);
+    
+    if(index == 0) {
+      for(v_int32 level = 1; level < LEVELS_COUNT; level ++) {
+        v_int32 levelIndex = (m_currentTick >> (SLOT_BITS * level)) & (SLOTS_COUNT - 1);
+        cascade(level, levelIndex);
+        if(levelIndex != 0) {
+          break;
+        }
+      }
+    }
+    
+    AbstractCoroutine* curr = m_slots[0][index];
+    m_slots[0][index] = nullptr;
+    while (curr != nullptr) {
+      AbstractCoroutine* next = curr->_timerNext;
+      curr->_timerSlot = nullptr;
+      curr->_timerPrev = nullptr;
+      curr->_timerNext = nullptr;
+      expiredQueue.pushBack(curr);
+      -- m_count;
+      ++ result;
+      curr = next;
+    }
+    
+    ++ m_currentTick;
+    
+  }
+  
+  return result;
+  
+}
+  
+v_int32 TimerWheel::getMillisToNextExpiry(v_int64 timePoint, v_int32 maxMillis) const {
+  
+  if(m_count == 0) {
+    return maxMillis;
+  }
+  
+  /* Find next non-empty slot of the first level, or next cascade point */
+  v_int64 tick = m_currentTick;
+  for(v_int32 i = 0; i < SLOTS_COUNT; i ++) {
+    if(m_slots[0][tick & (SLOTS_COUNT - 1)] != nullptr || (i > 0 && (tick & (SLOTS_COUNT - 1)) == 0)) {
+      break;
+    }
+    tick ++;
+  }
+  
+  v_int64 millis = (tick * TICK_MICROS - timePoint + 999) / 1000;
+  if(millis < 0) {
+    return 0;
+  }
+  if(millis > maxMillis) {
+    return maxMillis;
+  }
+  return (v_int32) millis;
+  
+}
+  
+}}
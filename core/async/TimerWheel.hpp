@@ -0,0 +1,88 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_TimerWheel_hpp
+#define oatpp_async_TimerWheel_hpp
+
+#include "./Coroutine.hpp"
+#include "oatpp/core/collection/FastQueue.hpp"
+
+namespace oatpp { namespace async {
+
+/**
+ * Hierarchical timer wheel for suspended coroutines. Each Processor owns its own wheel.
+ * Resolution is TICK_MICROS. Level N slot covers SLOTS_COUNT^N ticks.
+ * Entries of the upper levels are cascaded down as the wheel turns.
+ * Add, remove - O(1). Not thread-safe.
+ */
+class TimerWheel {
+public:
+  static constexpr v_int64 TICK_MICROS = 1000;
+  static constexpr v_int32 SLOT_BITS = 6;
+  static constexpr v_int32 SLOTS_COUNT = 1 << SLOT_BITS;
+  static constexpr v_int32 LEVELS_COUNT = 4;
+private:
+  AbstractCoroutine* m_slots[LEVELS_COUNT][SLOTS_COUNT];
+  v_int64 m_currentTick;
+  v_int32 m_count;
+private:
+  void insert(AbstractCoroutine* coroutine);
+  void cascade(v_int32 level, v_int32 slot);
+public:
+  
+  TimerWheel();
+  ~TimerWheel();
+  
+  /**
+   * Schedule coroutine to expire at @timePoint (microseconds).
+   */
+  void add(AbstractCoroutine* coroutine, v_int64 timePoint);
+  
+  /**
+   * Remove coroutine from the wheel. Does nothing if coroutine is not scheduled.
+   */
+  void remove(AbstractCoroutine* coroutine);
+  
+  /**
+   * Turn the wheel up to @timePoint (microseconds).
+   * Expired coroutines are pushed to @expiredQueue.
+   * Returns number of expired coroutines.
+   */
+  v_int32 advance(v_int64 timePoint, oatpp::collection::FastQueue<AbstractCoroutine>& expiredQueue);
+  
+  /**
+   * Milliseconds until next slot that needs processing, but not more than @maxMillis.
+   */
+  v_int32 getMillisToNextExpiry(v_int64 timePoint, v_int32 maxMillis) const;
+  
+  v_int32 getCount() const {
+    return m_count;
+  }
+  
+};
+  
+}}
+
+#endif /* oatpp_async_TimerWheel_hpp */
@@ -56,6 +56,39 @@
   #define OATPP_THREAD_DISTRIBUTED_MEM_POOL_SHARDS_COUNT 10
 #endif
 
+/**
+ * Max number of free entries each thread keeps per MemoryPool in its thread cache (magazine).
+ * Entries are moved between thread cache and pool in batches of this size.
+ * Actual magazine size is also limited by the chunk size of the pool.
+ */
+#ifndef OATPP_MEMORY_POOL_MAGAZINE_SIZE
+  #define OATPP_MEMORY_POOL_MAGAZINE_SIZE 32
+#endif
+
+/**
+ * MemoryPool chunks of this size (in bytes) and bigger are mapped with mmap directly,
+ * so that memory of chunks released by MemoryPool::trim() is returned to the OS right away.
+ * Smaller chunks are allocated on the heap.
+ */
+#ifndef OATPP_MEMORY_POOL_MMAP_THRESHOLD
+  #define OATPP_MEMORY_POOL_MMAP_THRESHOLD 65536
+#endif
+
+/**
+ * Size of huge page. Chunks of MemoryPool with BACKING_HUGE_PAGES are rounded up to this size.
+ */
+#ifndef OATPP_MEMORY_POOL_HUGE_PAGE_SIZE
+  #define OATPP_MEMORY_POOL_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#endif
+
+/**
+ * Define this to back IOBuffer and ChunkedBuffer pools with huge pages.
+ * Each pool shard then takes at least one huge page (OATPP_MEMORY_POOL_HUGE_PAGE_SIZE).
+ * MAP_HUGETLB requires reserved huge pages (vm.nr_hugepages). If none are available,
+ * pools fall back to regular pages with transparent huge pages hint.
+ */
+//#define OATPP_BUFFER_POOLS_HUGE_PAGES
+
 /**
  * AsyncHttpConnectionHandler default number of threads
  */
@@ -63,6 +96,13 @@
   #define OATPP_ASYNC_HTTP_CONNECTION_HANDLER_THREAD_NUM_DEFAULT 2
 #endif
 
+/**
+ * HttpConnectionHandler default size of accepted-connections queue in worker-pool mode
+ */
+#ifndef OATPP_HTTP_CONNECTION_HANDLER_QUEUE_SIZE_DEFAULT
+  #define OATPP_HTTP_CONNECTION_HANDLER_QUEUE_SIZE_DEFAULT 1024
+#endif
+
 /**
  * DISABLE logs level V
  */
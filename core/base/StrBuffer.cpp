@@ -94,6 +94,17 @@ std::shared_ptr<StrBuffer> StrBuffer::createShared(v_int32 size) {
   return allocShared(nullptr, size, true);
 }
 
+std::shared_ptr<StrBuffer> StrBuffer::createShared(memory::Arena& arena, v_int32 size) {
+  return createShared(arena, nullptr, size);
+}
+
+std::shared_ptr<StrBuffer> StrBuffer::createShared(memory::Arena& arena, const void* data, v_int32 size) {
+  memory::AllocationExtras extras(size + 1);
+  auto ptr = memory::arenaAllocateSharedWithExtras<StrBuffer>(extras, arena);
+  ptr->setAndCopy(extras.extraPtr, data, size);
+  return ptr;
+}
+
 std::shared_ptr<StrBuffer> StrBuffer::createSharedConcatenated(const void* data1, v_int32 size1, const void* data2, v_int32 size2) {
   const auto& ptr = allocShared(nullptr, size1 + size2, true);
   std::memcpy(ptr->m_data, data1, size1);
@@ -26,6 +26,7 @@
 #define oatpp_base_StrBuffer_hpp
 
 #include "memory/ObjectPool.hpp"
+#include "memory/Arena.hpp"
 #include "./Controllable.hpp"
 
 #include <cstring> // c
@@ -90,6 +91,13 @@ public:
   static std::shared_ptr<StrBuffer> createShared(const char* data, bool copyAsOwnData = true);
   static std::shared_ptr<StrBuffer> createShared(StrBuffer* other, bool copyAsOwnData = true);
   
+  /**
+   * Allocate buffer together with its data on the arena.
+   * Memory goes back to the arena block once the last reference to buffer is released.
+   */
+  static std::shared_ptr<StrBuffer> createShared(memory::Arena& arena, v_int32 size);
+  static std::shared_ptr<StrBuffer> createShared(memory::Arena& arena, const void* data, v_int32 size);
+  
   static std::shared_ptr<StrBuffer> createSharedConcatenated(const void* data1, v_int32 size1, const void* data2, v_int32 size2);
   
   static std::shared_ptr<StrBuffer> createFromCString(const char* data, bool copyAsOwnData = true) {
@@ -0,0 +1,107 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "Arena.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace oatpp { namespace base { namespace memory {
+
+static_assert(sizeof(std::atomic<v_int32>) <= 16, "Arena block header doesn't fit HEADER_SIZE");
+
+Arena::Block* Arena::allocBlock(v_int32 size) {
+  void* mem;
+  if(posix_memalign(&mem, BLOCK_SIZE, size) != 0) {
+    throw std::bad_alloc();
+  }
+  return new (mem) Block();
+}
+
+void Arena::releaseBlock(Block* block) {
+  if(block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    block->~Block();
+    std::free(block);
+  }
+}
+
+Arena::Arena()
+  : m_block(nullptr)
+  , m_position(0)
+  , m_blocksCount(0)
+{}
+
+Arena::~Arena() {
+  if(m_block != nullptr) {
+    releaseBlock(m_block);
+  }
+}
+
+void* Arena::allocate(v_int32 size) {
+  
+  size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  
+  if(size > MAX_INLINE_ALLOCATION) {
+    /* Object pointer stays within first BLOCK_SIZE bytes so deallocate() finds the header */
+    Block* block = allocBlock(HEADER_SIZE + size);
+    block->refs.store(1, std::memory_order_relaxed);
+    m_blocksCount ++;
+    return &((p_char8) block)[HEADER_SIZE];
+  }
+  
+  if(m_block == nullptr || m_position + size > BLOCK_SIZE) {
+    if(m_block != nullptr) {
+      releaseBlock(m_block);
+    }
+    m_block = allocBlock(BLOCK_SIZE);
+    m_block->refs.store(1, std::memory_order_relaxed); // arena's own reference
+    m_position = HEADER_SIZE;
+    m_blocksCount ++;
+  }
+  
+  void* result = &((p_char8) m_block)[m_position];
+  m_position += size;
+  m_block->refs.fetch_add(1, std::memory_order_relaxed);
+  return result;
+  
+}
+
+void Arena::deallocate(void* ptr) {
+  releaseBlock((Block*)((std::uintptr_t) ptr & ~((std::uintptr_t) BLOCK_SIZE - 1)));
+}
+
+void Arena::reset() {
+  if(m_block != nullptr) {
+    /* Only arena can add references, so block held by arena alone stays free */
+    if(m_block->refs.load(std::memory_order_acquire) == 1) {
+      m_position = HEADER_SIZE;
+    } else {
+      releaseBlock(m_block);
+      m_block = nullptr;
+    }
+  }
+}
+
+}}}
@@ -0,0 +1,203 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_base_memory_Arena_hpp
+#define oatpp_base_memory_Arena_hpp
+
+#include "./Allocator.hpp"
+
+#include <atomic>
+
+namespace oatpp { namespace base { namespace memory {
+
+/**
+ * Bump-pointer allocator for objects sharing one lifetime (ex.: objects of one http request).
+ * Memory is taken from blocks of BLOCK_SIZE. Each block counts allocations made from it,
+ * so object may be freed in any order and from any thread - block is released once all its
+ * objects are freed and arena moved on.
+ * reset() rewinds the current block if all objects of the previous cycle are already freed,
+ * otherwise it leaves the block to its objects and starts a new one.
+ * Arena itself is not thread-safe - allocate from one thread at a time.
+ */
+class Arena {
+public:
+  static constexpr v_int32 BLOCK_SIZE = 64 * 1024;
+  static constexpr v_int32 ALIGNMENT = 16;
+  /* allocations bigger than this get separate block */
+  static constexpr v_int32 MAX_INLINE_ALLOCATION = BLOCK_SIZE / 4;
+private:
+  
+  /**
+   * Header placed at the beginning of block memory.
+   * Blocks are aligned by BLOCK_SIZE so header is found by masking object address.
+   */
+  class Block {
+  public:
+    std::atomic<v_int32> refs;
+  };
+  
+  static constexpr v_int32 HEADER_SIZE = ALIGNMENT;
+  
+  static Block* allocBlock(v_int32 size);
+  static void releaseBlock(Block* block);
+  
+private:
+  Block* m_block;
+  v_int32 m_position;
+  v_int64 m_blocksCount;
+public:
+  
+  Arena();
+  ~Arena();
+  
+  Arena(const Arena&) = delete;
+  Arena& operator = (const Arena&) = delete;
+  
+  /**
+   * Allocate memory of size bytes aligned by ALIGNMENT.
+   * Memory must be freed with Arena::deallocate().
+   */
+  void* allocate(v_int32 size);
+  
+  /**
+   * Free memory obtained with allocate() of any arena. May be called from any thread
+   * and after the arena is destroyed.
+   */
+  static void deallocate(void* ptr);
+  
+  /**
+   * Start new allocations cycle. Call it when objects of the previous cycle are released.
+   */
+  void reset();
+  
+  /**
+   * Number of blocks allocated by this arena (including blocks for big allocations).
+   * Stays the same from cycle to cycle once arena is warmed up.
+   */
+  v_int64 getBlocksCount() const {
+    return m_blocksCount;
+  }
+  
+};
+
+/**
+ * Allocator for std containers and std::allocate_shared.
+ */
+template<class T>
+class ArenaAllocator {
+public:
+  typedef T value_type;
+public:
+  Arena* m_arena;
+public:
+  
+  ArenaAllocator(Arena& arena)
+    : m_arena(&arena)
+  {};
+  
+  template<typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other)
+    : m_arena(other.m_arena)
+  {};
+  
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(m_arena->allocate((v_int32)(sizeof(T) * n)));
+  }
+  
+  void deallocate(T* ptr, size_t /* n */) {
+    Arena::deallocate(ptr);
+  }
+  
+};
+
+template <typename T, typename U>
+inline bool operator == (const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.m_arena == b.m_arena;
+}
+
+template <typename T, typename U>
+inline bool operator != (const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return !(a == b);
+}
+
+template<class T>
+class ArenaSharedObjectAllocator {
+public:
+  typedef T value_type;
+public:
+  AllocationExtras& m_info;
+  Arena* m_arena;
+public:
+  
+  ArenaSharedObjectAllocator(AllocationExtras& info, Arena& arena)
+    : m_info(info)
+    , m_arena(&arena)
+  {};
+  
+  template<typename U>
+  ArenaSharedObjectAllocator(const ArenaSharedObjectAllocator<U>& other)
+    : m_info(other.m_info)
+    , m_arena(other.m_arena)
+  {};
+  
+  T* allocate(std::size_t /* n */) {
+    void* mem = m_arena->allocate(sizeof(T) + m_info.extraWanted);
+    m_info.baseSize = sizeof(T);
+    m_info.extraPtr = &((p_char8) mem)[sizeof(T)];
+    return static_cast<T*>(mem);
+  }
+  
+  void deallocate(T* ptr, size_t /* n */) {
+    Arena::deallocate(ptr);
+  }
+  
+};
+
+template <typename T, typename U>
+inline bool operator == (const ArenaSharedObjectAllocator<T>& a, const ArenaSharedObjectAllocator<U>& b) {
+  return a.m_arena == b.m_arena;
+}
+
+template <typename T, typename U>
+inline bool operator != (const ArenaSharedObjectAllocator<T>& a, const ArenaSharedObjectAllocator<U>& b) {
+  return !(a == b);
+}
+
+template<typename T, typename ... Args>
+static std::shared_ptr<T> arenaAllocateShared(Arena& arena, Args... args){
+  typedef ArenaAllocator<T> _Allocator;
+  _Allocator allocator(arena);
+  return std::allocate_shared<T, _Allocator>(allocator, args...);
+}
+
+template<typename T, typename ... Args>
+static std::shared_ptr<T> arenaAllocateSharedWithExtras(AllocationExtras& extras, Arena& arena, Args... args){
+  typedef ArenaSharedObjectAllocator<T> _Allocator;
+  _Allocator allocator(extras, arena);
+  return std::allocate_shared<T, _Allocator>(allocator, args...);
+}
+
+}}}
+
+#endif /* oatpp_base_memory_Arena_hpp */
@@ -26,39 +26,370 @@
 #include "oatpp/core/utils/ConversionUtils.hpp"
 #include "oatpp/core/concurrency/Thread.hpp"
 
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+  #include <sys/syscall.h>
+#endif
+
 namespace oatpp { namespace base { namespace  memory {
 
+namespace {
+  
+/*
+ * Prefer pages of mapped memory on the NUMA node. Best effort - memory stays where kernel puts it if mbind fails.
+ */
+void bindToNumaNode(void* mem, v_int32 size, v_int32 numaNode) {
+#if defined(__linux__) && defined(SYS_mbind)
+  if(numaNode >= 0 && numaNode < 64) {
+    static constexpr int MPOL_PREFERRED_MODE = 1;
+    unsigned long nodeMask = 1UL << numaNode;
+    syscall(SYS_mbind, mem, (unsigned long) size, MPOL_PREFERRED_MODE, &nodeMask, sizeof(nodeMask) * 8 + 1, 0);
+  }
+#endif
+}
+  
+void* mapHugePages(v_int32 size) {
+  void* mem = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+  mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if(mem != MAP_FAILED) {
+    return mem;
+  }
+#endif
+  static std::atomic<bool> warned(false);
+  if(!warned.exchange(true)) {
+    OATPP_LOGD("[oatpp::base::memory::MemoryPool]", "Huge pages are unavailable. Using regular pages with transparent huge pages hint");
+  }
+  mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#if defined(MADV_HUGEPAGE)
+  if(mem != MAP_FAILED) {
+    madvise(mem, size, MADV_HUGEPAGE);
+  }
+#endif
+  return mem;
+}
+  
+p_char8 allocChunkMemory(v_int32 size, v_int32 backing, v_int32 numaNode, bool& mapped) {
+  if(backing != MemoryPool::BACKING_DEFAULT || size >= OATPP_MEMORY_POOL_MMAP_THRESHOLD) {
+    void* mem;
+    if(backing == MemoryPool::BACKING_HUGE_PAGES) {
+      mem = mapHugePages(size);
+    } else {
+      mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if(mem != MAP_FAILED) {
+      /* bind before chunk entries are written - pages are placed on first touch */
+      bindToNumaNode(mem, size, numaNode);
+      mapped = true;
+      return (p_char8) mem;
+    }
+  }
+  mapped = false;
+  return new v_char8[size];
+}
+  
+/*
+ * SpinLock which counts how many times the lock was found busy.
+ */
+class CountingSpinLock {
+private:
+  oatpp::concurrency::SpinLock::Atom& m_atom;
+public:
+  
+  CountingSpinLock(oatpp::concurrency::SpinLock::Atom& atom, std::atomic<v_int64>& contendedCount)
+    : m_atom(atom)
+  {
+    if(std::atomic_exchange_explicit(&m_atom, true, std::memory_order_acquire)) {
+      contendedCount.fetch_add(1, std::memory_order_relaxed);
+      oatpp::concurrency::SpinLock::lock(m_atom);
+    }
+  }
+  
+  ~CountingSpinLock() {
+    oatpp::concurrency::SpinLock::unlock(m_atom);
+  }
+  
+};
+  
+}
+
+class MemoryPool::ThreadCache {
+public:
+  
+  class Magazine {
+  public:
+    MemoryPool* pool;
+    v_int64 poolId;
+    EntryHeader* head;
+    EntryHeader* tail;
+    v_int32 count;
+    /* objects obtained minus objects freed through this magazine - not yet added to pool objects count */
+    v_int32 objectsCountDelta;
+    /* max value of objectsCountDelta since last sync - for pool high-water mark */
+    v_int32 objectsCountDeltaPeak;
+    /* objects obtained through this magazine - not yet added to pool allocations count */
+    v_int32 allocationsCountDelta;
+  };
+  
+private:
+  static constexpr v_int32 STATE_NONE = 0;
+  static constexpr v_int32 STATE_ALIVE = 1;
+  static constexpr v_int32 STATE_DESTROYED = 2;
+  static thread_local v_int32 STATE;
+private:
+  
+  /*
+   * Return cached entries to the pool they belong to - on thread exit.
+   * Pool may be already destroyed - then entries are dropped together with pool chunks.
+   */
+  static void release(Magazine& magazine) {
+    if(magazine.head != nullptr || magazine.objectsCountDelta != 0 || magazine.objectsCountDeltaPeak > 0 ||
+       magazine.allocationsCountDelta != 0)
+    {
+      oatpp::concurrency::SpinLock lock(POOLS_ATOM);
+      auto it = POOLS.find(magazine.poolId);
+      if(it != POOLS.end() && it->second == magazine.pool) {
+        if(magazine.head != nullptr) {
+          magazine.pool->pushFreeEntries(magazine.head, magazine.tail);
+        }
+        syncCounters(magazine);
+      }
+    }
+    reset(magazine);
+  }
+  
+  static void reset(Magazine& magazine) {
+    magazine.head = nullptr;
+    magazine.tail = nullptr;
+    magazine.count = 0;
+    magazine.objectsCountDelta = 0;
+    magazine.objectsCountDeltaPeak = 0;
+    magazine.allocationsCountDelta = 0;
+  }
+  
+private:
+  
+  static ThreadCache& getInstance() {
+    static thread_local ThreadCache cache;
+    return cache;
+  }
+  
+private:
+  /* indexed by pool slot. Grows when thread uses pool with bigger slot */
+  std::vector<Magazine> m_slots;
+public:
+  
+  ThreadCache() {
+    STATE = STATE_ALIVE;
+  }
+  
+  ~ThreadCache() {
+    for(Magazine& magazine : m_slots) {
+      release(magazine);
+    }
+    STATE = STATE_DESTROYED;
+  }
+  
+  /**
+   * Get magazine of the calling thread for the pool.
+   * @param pool
+   * @return - magazine or `nullptr` if thread cache of the calling thread is already destroyed (thread exit).
+   */
+  static Magazine* getMagazine(MemoryPool* pool) {
+    if(STATE == STATE_DESTROYED) {
+      return nullptr;
+    }
+    auto& slots = getInstance().m_slots;
+    if(pool->m_slot >= (v_int32) slots.size()) {
+      slots.resize(pool->m_slot + 1, Magazine());
+    }
+    Magazine& magazine = slots[pool->m_slot];
+    if(magazine.poolId != pool->m_id) {
+      /* slot is reused only after its previous pool is destroyed - its entries are gone with its chunks */
+      reset(magazine);
+      magazine.pool = pool;
+      magazine.poolId = pool->m_id;
+    }
+    return &magazine;
+  }
+  
+  /**
+   * Add counters of the magazine to the pool counters.
+   * Done in batches to not touch shared counters on each obtain/free.
+   * @param magazine
+   */
+  static void syncCounters(Magazine& magazine) {
+    if(magazine.objectsCountDelta != 0 || magazine.objectsCountDeltaPeak > 0) {
+      magazine.pool->addObjectsCount(magazine.objectsCountDelta, magazine.objectsCountDeltaPeak);
+      magazine.objectsCountDelta = 0;
+    }
+    magazine.objectsCountDeltaPeak = 0;
+    if(magazine.allocationsCountDelta != 0) {
+      magazine.pool->m_allocationsCount.fetch_add(magazine.allocationsCountDelta, std::memory_order_relaxed);
+      magazine.allocationsCountDelta = 0;
+    }
+  }
+  
+  /**
+   * Sync counters of the calling thread for the pool, if thread has magazine for this pool.
+   * @param pool
+   */
+  static void syncCounters(MemoryPool* pool) {
+    if(STATE != STATE_ALIVE) {
+      return;
+    }
+    auto& slots = getInstance().m_slots;
+    if(pool->m_slot < (v_int32) slots.size() && slots[pool->m_slot].poolId == pool->m_id) {
+      syncCounters(slots[pool->m_slot]);
+    }
+  }
+  
+};
+
+thread_local v_int32 MemoryPool::ThreadCache::STATE = MemoryPool::ThreadCache::STATE_NONE;
+  
+/* keep entries aligned the same way as chunk memory is */
+const v_int32 MemoryPool::CHUNK_HEADER_SIZE = (sizeof(Chunk) + 15) & ~15;
+  
+v_int32 MemoryPool::acquireSlot() {
+  if(freeSlots.empty()) {
+    return slotsCounter ++;
+  }
+  v_int32 slot = freeSlots.back();
+  freeSlots.pop_back();
+  return slot;
+}
+  
+void MemoryPool::releaseSlot(v_int32 slot) {
+  freeSlots.push_back(slot);
+}
+  
+v_int32 MemoryPool::getBackingPageSize(v_int32 backing) {
+  if(backing == BACKING_HUGE_PAGES) {
+    return OATPP_MEMORY_POOL_HUGE_PAGE_SIZE;
+  }
+  static v_int32 pageSize = (v_int32) sysconf(_SC_PAGESIZE);
+  return pageSize;
+}
+  
 void MemoryPool::allocChunk() {
   v_int32 entryBlockSize = sizeof(EntryHeader) + m_entrySize;
-  v_int32 chunkMemSize = entryBlockSize * m_chunkSize;
-  p_char8 mem = new v_char8[chunkMemSize];
-  m_chunks.push_back(mem);
+  bool mapped;
+  p_char8 mem = allocChunkMemory(m_chunkMemSize, m_backing, m_numaNode, mapped);
+  Chunk* chunk = new (mem) Chunk(m_chunkSize, oatpp::base::Environment::getMicroTickCount(), mapped);
+  m_chunks.push_back(chunk);
+  p_char8 entries = mem + CHUNK_HEADER_SIZE;
   for(v_int32 i = 0; i < m_chunkSize; i++){
-    EntryHeader* entry = new (mem + i * entryBlockSize) EntryHeader(this, m_id, m_rootEntry);
+    EntryHeader* entry = new (entries + i * entryBlockSize) EntryHeader(this, m_id, chunk, m_rootEntry);
     m_rootEntry = entry;
   }
 }
   
+void MemoryPool::freeChunk(Chunk* chunk) {
+  if(chunk->mapped) {
+    munmap(chunk, m_chunkMemSize);
+  } else {
+    delete [] ((p_char8) chunk);
+  }
+}
+
+void MemoryPool::drainFreeStack() {
+  EntryHeader* returned = m_freeStack.exchange(nullptr, std::memory_order_acquire);
+  if(returned == nullptr) {
+    return;
+  }
+  v_int64 now = 0;
+  EntryHeader* last = returned;
+  while(true) {
+    if(++ last->chunk->freeEntries == m_chunkSize) {
+      if(now == 0) {
+        now = oatpp::base::Environment::getMicroTickCount();
+      }
+      last->chunk->freeSince = now;
+    }
+    if(last->next == nullptr) {
+      break;
+    }
+    last = last->next;
+  }
+  /* Recently freed entries go first - their memory is more likely to be in cache */
+  last->next = m_rootEntry;
+  m_rootEntry = returned;
+}
+
+void MemoryPool::addObjectsCount(v_int32 delta, v_int32 peakDelta) {
+  v_int32 peak = m_objectsCount.fetch_add(delta, std::memory_order_relaxed) + peakDelta;
+  if(peakDelta > 0) {
+    v_int32 highWaterMark = m_objectsCountHighWaterMark.load(std::memory_order_relaxed);
+    while(peak > highWaterMark &&
+          !m_objectsCountHighWaterMark.compare_exchange_weak(highWaterMark, peak, std::memory_order_relaxed)) {}
+  }
+}
+
+v_int32 MemoryPool::takeEntries(v_int32 count, EntryHeader*& head, EntryHeader*& tail) {
+  
+  drainFreeStack();
+  if(m_rootEntry == nullptr) {
+    allocChunk();
+    if(m_rootEntry == nullptr) {
+      throw std::runtime_error("[oatpp::base::memory::MemoryPool:takeEntries()]: Unable to allocate entry");
+    }
+  }
+  
+  head = m_rootEntry;
+  tail = head;
+  -- tail->chunk->freeEntries;
+  v_int32 taken = 1;
+  while(taken < count && tail->next != nullptr) {
+    tail = tail->next;
+    -- tail->chunk->freeEntries;
+    ++ taken;
+  }
+  m_rootEntry = tail->next;
+  tail->next = nullptr;
+  return taken;
+  
+}
+
+void MemoryPool::pushFreeEntries(EntryHeader* first, EntryHeader* last) {
+  EntryHeader* top = m_freeStack.load(std::memory_order_relaxed);
+  do {
+    last->next = top;
+  } while(!m_freeStack.compare_exchange_weak(top, first, std::memory_order_release, std::memory_order_relaxed));
+}
+  
 void* MemoryPool::obtain() {
 #ifdef OATPP_DISABLE_POOL_ALLOCATIONS
   return new v_char8[m_entrySize];
 #else
-  oatpp::concurrency::SpinLock lock(m_atom);
-  if(m_rootEntry != nullptr) {
-    auto entry = m_rootEntry;
-    m_rootEntry = m_rootEntry->next;
-    ++ m_objectsCount;
-    return ((p_char8) entry) + sizeof(EntryHeader);
+  EntryHeader* entry;
+  ThreadCache::Magazine* magazine = ThreadCache::getMagazine(this);
+  if(magazine != nullptr) {
+    if(magazine->head == nullptr) {
+      ThreadCache::syncCounters(*magazine);
+      CountingSpinLock lock(m_atom, m_contendedLocksCount);
+      magazine->count = takeEntries(m_magazineSize, magazine->head, magazine->tail);
+    }
+    entry = magazine->head;
+    magazine->head = entry->next;
+    -- magazine->count;
+    if(++ magazine->objectsCountDelta > magazine->objectsCountDeltaPeak) {
+      magazine->objectsCountDeltaPeak = magazine->objectsCountDelta;
+    }
+    ++ magazine->allocationsCountDelta;
   } else {
-    allocChunk();
-    if(m_rootEntry == nullptr) {
-      throw std::runtime_error("[oatpp::base::memory::MemoryPool:obtain()]: Unable to allocate entry");
+    EntryHeader* tail;
+    {
+      CountingSpinLock lock(m_atom, m_contendedLocksCount);
+      takeEntries(1, entry, tail);
     }
-    auto entry = m_rootEntry;
-    m_rootEntry = m_rootEntry->next;
-    ++ m_objectsCount;
-    return ((p_char8) entry) + sizeof(EntryHeader);
+    m_allocationsCount.fetch_add(1, std::memory_order_relaxed);
+    addObjectsCount(1, 1);
   }
+  return ((p_char8) entry) + sizeof(EntryHeader);
 #endif
 }
   
@@ -66,33 +397,43 @@ void* MemoryPool::obtainLockFree() {
 #ifdef OATPP_DISABLE_POOL_ALLOCATIONS
   return new v_char8[m_entrySize];
 #else
-  if(m_rootEntry != nullptr) {
-    auto entry = m_rootEntry;
-    m_rootEntry = m_rootEntry->next;
-    ++ m_objectsCount;
-    return ((p_char8) entry) + sizeof(EntryHeader);
-  } else {
-    allocChunk();
-    if(m_rootEntry == nullptr) {
-      throw std::runtime_error("[oatpp::base::memory::MemoryPool:obtainLockFree()]: Unable to allocate entry");
-    }
-    auto entry = m_rootEntry;
-    m_rootEntry = m_rootEntry->next;
-    ++ m_objectsCount;
-    return ((p_char8) entry) + sizeof(EntryHeader);
-  }
+  EntryHeader* entry;
+  EntryHeader* tail;
+  takeEntries(1, entry, tail);
+  m_allocationsCount.fetch_add(1, std::memory_order_relaxed);
+  addObjectsCount(1, 1);
+  return ((p_char8) entry) + sizeof(EntryHeader);
 #endif
 }
 
 void MemoryPool::freeByEntryHeader(EntryHeader* entry) {
-  if(entry->poolId == m_id) {
-    oatpp::concurrency::SpinLock lock(m_atom);
-    entry->next = m_rootEntry;
-    m_rootEntry = entry;
-    -- m_objectsCount;
-  } else {
+  if(entry->poolId != m_id) {
     throw std::runtime_error("oatpp::base::memory::MemoryPool: Invalid EntryHeader");
   }
+  ThreadCache::Magazine* magazine = ThreadCache::getMagazine(this);
+  if(magazine == nullptr) {
+    m_objectsCount.fetch_sub(1, std::memory_order_relaxed);
+    pushFreeEntries(entry, entry);
+    return;
+  }
+  entry->next = magazine->head;
+  if(magazine->head == nullptr) {
+    magazine->tail = entry;
+  }
+  magazine->head = entry;
+  -- magazine->objectsCountDelta;
+  if(++ magazine->count == m_magazineSize * 2) {
+    ThreadCache::syncCounters(*magazine);
+    /* keep recently freed half in the magazine, return the older half to the pool in one batch */
+    EntryHeader* last = magazine->head;
+    for(v_int32 i = 1; i < m_magazineSize; i++) {
+      last = last->next;
+    }
+    pushFreeEntries(last->next, magazine->tail);
+    last->next = nullptr;
+    magazine->tail = last;
+    magazine->count = m_magazineSize;
+  }
 }
 
 void MemoryPool::free(void* entry) {
@@ -113,25 +454,129 @@ v_int32 MemoryPool::getEntrySize(){
 }
 
 v_int64 MemoryPool::getSize(){
+  oatpp::concurrency::SpinLock lock(m_atom);
   return m_chunks.size() * m_chunkSize;
 }
 
 v_int32 MemoryPool::getObjectsCount(){
-  return m_objectsCount;
+#ifndef OATPP_DISABLE_POOL_ALLOCATIONS
+  ThreadCache::syncCounters(this);
+#endif
+  return m_objectsCount.load(std::memory_order_relaxed);
 }
   
   
   
+MemoryPool::Stats MemoryPool::getStats() {
+  
+  Stats stats;
+  stats.name = m_name;
+  stats.entrySize = m_entrySize;
+  stats.objectsCount = getObjectsCount();
+  stats.objectsCountHighWaterMark = m_objectsCountHighWaterMark.load(std::memory_order_relaxed);
+  stats.allocationsCount = m_allocationsCount.load(std::memory_order_relaxed);
+  stats.contendedLocksCount = m_contendedLocksCount.load(std::memory_order_relaxed);
+  
+  stats.timestamp = oatpp::base::Environment::getMicroTickCount();
+  
+  {
+    oatpp::concurrency::SpinLock lock(m_atom);
+    stats.chunksCount = m_chunks.size();
+  }
+  
+  stats.capacity = stats.chunksCount * m_chunkSize;
+  return stats;
+  
+}
+  
+std::vector<MemoryPool::Stats> MemoryPool::getAllStats() {
+  std::vector<Stats> result;
+  oatpp::concurrency::SpinLock lock(POOLS_ATOM);
+  result.reserve(POOLS.size());
+  for(auto& pair : POOLS) {
+    result.push_back(pair.second->getStats());
+  }
+  return result;
+}
+  
+v_int32 MemoryPool::trim(v_int64 minIdleMicroseconds) {
+  
+  std::vector<Chunk*> released;
+  
+  {
+    
+    CountingSpinLock lock(m_atom, m_contendedLocksCount);
+    drainFreeStack();
+    
+    v_int64 now = oatpp::base::Environment::getMicroTickCount();
+    auto it = m_chunks.begin();
+    while(it != m_chunks.end()) {
+      Chunk* chunk = *it;
+      if(chunk->freeEntries == m_chunkSize && now - chunk->freeSince >= minIdleMicroseconds) {
+        chunk->released = true;
+        released.push_back(chunk);
+        it = m_chunks.erase(it);
+      } else {
+        it ++;
+      }
+    }
+    
+    if(released.empty()) {
+      return 0;
+    }
+    
+    EntryHeader** link = &m_rootEntry;
+    while(*link != nullptr) {
+      if((*link)->chunk->released) {
+        *link = (*link)->next;
+      } else {
+        link = &(*link)->next;
+      }
+    }
+    
+  }
+  
+  for(Chunk* chunk : released) {
+    freeChunk(chunk);
+  }
+  
+  return (v_int32) released.size();
+  
+}
+  
+v_int64 MemoryPool::trimAll(v_int64 minIdleMicroseconds) {
+  v_int64 result = 0;
+  oatpp::concurrency::SpinLock lock(POOLS_ATOM);
+  for(auto& pair : POOLS) {
+    result += pair.second->trim(minIdleMicroseconds);
+  }
+  return result;
+}
+  
 oatpp::concurrency::SpinLock::Atom MemoryPool::POOLS_ATOM(false);
 std::unordered_map<v_int64, MemoryPool*> MemoryPool::POOLS;
 std::atomic<v_int64> MemoryPool::poolIdCounter(0);
+std::vector<v_int32> MemoryPool::freeSlots;
+v_int32 MemoryPool::slotsCounter = 0;
   
-ThreadDistributedMemoryPool::ThreadDistributedMemoryPool(const std::string& name, v_int32 entrySize, v_int32 chunkSize, v_int32 shardsCount)
-  : m_shardsCount(shardsCount)
+ThreadDistributedMemoryPool::ThreadDistributedMemoryPool(const std::string& name, v_int32 entrySize, v_int32 chunkSize,
+                                                         v_int32 shardsCount, v_int32 backing, bool numaLocal)
+  : m_name(name)
+  , m_shardsCount(shardsCount)
+  , m_numaNodesCount(1)
+  , m_shardsPerNode(shardsCount)
   , m_shards(new MemoryPool*[m_shardsCount])
 {
+  if(numaLocal) {
+    m_numaNodesCount = oatpp::concurrency::Thread::getNumaNodesCount();
+    if(m_numaNodesCount > m_shardsCount) {
+      m_numaNodesCount = m_shardsCount;
+    }
+    m_shardsPerNode = m_shardsCount / m_numaNodesCount;
+  }
   for(v_int32 i = 0; i < m_shardsCount; i++){
-    m_shards[i] = new MemoryPool(name + "_" + oatpp::utils::conversion::int32ToStdStr(i), entrySize, chunkSize);
+    v_int32 numaNode = m_numaNodesCount > 1 ? i % m_numaNodesCount : -1;
+    m_shards[i] = new MemoryPool(name + "_" + oatpp::utils::conversion::int32ToStdStr(i), entrySize, chunkSize, backing, numaNode);
   }
 }
 
@@ -143,9 +588,40 @@ ThreadDistributedMemoryPool::~ThreadDistributedMemoryPool(){
 }
 
 void* ThreadDistributedMemoryPool::obtain() {
+  if(m_numaNodesCount > 1) {
+    /* node is taken once per thread - threads are expected to stay on their node */
+    static std::atomic<v_int32> threadsCounter(0);
+    static thread_local v_int32 threadNumber = threadsCounter++;
+    static thread_local v_int32 numaNode = oatpp::concurrency::Thread::getCurrentNumaNode();
+    v_int32 index = (threadNumber % m_shardsPerNode) * m_numaNodesCount + numaNode % m_numaNodesCount;
+    return m_shards[index]->obtain();
+  }
   static std::atomic<v_word16> base(0);
   static thread_local v_int16 index = (++base) % m_shardsCount;
   return m_shards[index]->obtain();
 }
+
+v_int32 ThreadDistributedMemoryPool::trim(v_int64 minIdleMicroseconds) {
+  v_int32 result = 0;
+  for(v_int32 i = 0; i < m_shardsCount; i++){
+    result += m_shards[i]->trim(minIdleMicroseconds);
+  }
+  return result;
+}
+
+MemoryPool::Stats ThreadDistributedMemoryPool::getStats() {
+  MemoryPool::Stats result = m_shards[0]->getStats();
+  result.name = m_name;
+  for(v_int32 i = 1; i < m_shardsCount; i++){
+    MemoryPool::Stats stats = m_shards[i]->getStats();
+    result.capacity += stats.capacity;
+    result.objectsCount += stats.objectsCount;
+    result.objectsCountHighWaterMark += stats.objectsCountHighWaterMark;
+    result.chunksCount += stats.chunksCount;
+    result.allocationsCount += stats.allocationsCount;
+    result.contendedLocksCount += stats.contendedLocksCount;
+  }
+  return result;
+}
   
 }}}
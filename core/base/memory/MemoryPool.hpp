@@ -30,6 +30,7 @@
 
 #include <atomic>
 #include <list>
+#include <vector>
 #include <unordered_map>
 #include <cstring>
 //#define OATPP_DISABLE_POOL_ALLOCATIONS
@@ -37,64 +38,219 @@
 namespace oatpp { namespace base { namespace  memory {
   
 class MemoryPool {
+public:
+  
+  /**
+   * Chunks are allocated on the heap, or mapped with mmap if chunk size is at least OATPP_MEMORY_POOL_MMAP_THRESHOLD.
+   */
+  static constexpr v_int32 BACKING_DEFAULT = 0;
+  
+  /**
+   * Chunks are mapped with mmap and rounded up to whole pages.
+   */
+  static constexpr v_int32 BACKING_MMAP = 1;
+  
+  /**
+   * Chunks are mapped with MAP_HUGETLB and rounded up to OATPP_MEMORY_POOL_HUGE_PAGE_SIZE.
+   * Falls back to regular pages with transparent huge pages hint (MADV_HUGEPAGE) when huge pages are unavailable.
+   */
+  static constexpr v_int32 BACKING_HUGE_PAGES = 2;
+  
+  /**
+   * Backing of IOBuffer and ChunkedBuffer pools. See OATPP_BUFFER_POOLS_HUGE_PAGES.
+   */
+#if defined(OATPP_BUFFER_POOLS_HUGE_PAGES)
+  static constexpr v_int32 BACKING_BUFFERS = BACKING_HUGE_PAGES;
+#else
+  static constexpr v_int32 BACKING_BUFFERS = BACKING_MMAP;
+#endif
+  
+public:
+  
+  /**
+   * Snapshot of pool statistics. Taking a snapshot doesn't change the pool - any number of readers may take them.
+   * Threads sync their cached counters in batches, so objects count and high-water mark
+   * may lag behind by a few magazines while other threads are running.
+   */
+  class Stats {
+  public:
+    std::string name;
+    v_int32 entrySize;
+    /* total entries in all chunks of the pool */
+    v_int64 capacity;
+    /* objects currently obtained from the pool */
+    v_int32 objectsCount;
+    /* max objects count observed */
+    v_int32 objectsCountHighWaterMark;
+    v_int64 chunksCount;
+    /* total number of allocations made from the pool. Monotonic */
+    v_int64 allocationsCount;
+    /* times pool lock was found busy */
+    v_int64 contendedLocksCount;
+    /* micro tick when the snapshot was taken */
+    v_int64 timestamp;
+  public:
+    
+    /**
+     * Allocations per second between @previous snapshot of the same pool and this one.
+     * Each reader keeps its own previous snapshot - readers don't affect each other.
+     * @param previous - earlier snapshot of the same pool.
+     * @return - allocations per second. 0 if no time has passed.
+     */
+    v_float64 getAllocationRate(const Stats& previous) const {
+      v_int64 elapsed = timestamp - previous.timestamp;
+      if(elapsed <= 0) {
+        return 0;
+      }
+      return (allocationsCount - previous.allocationsCount) * 1000000.0 / elapsed;
+    }
+    
+  };
+  
 public:
   static oatpp::concurrency::SpinLock::Atom POOLS_ATOM;
   static std::unordered_map<v_int64, MemoryPool*> POOLS;
 private:
   static std::atomic<v_int64> poolIdCounter;
+  /* guarded by POOLS_ATOM - thread cache slots of destroyed pools, reused by new pools */
+  static std::vector<v_int32> freeSlots;
+  static v_int32 slotsCounter;
 private:
   
+  /**
+   * Header placed at the beginning of chunk memory.
+   */
+  class Chunk {
+  public:
+    
+    Chunk(v_int32 pFreeEntries, v_int64 pFreeSince, bool pMapped)
+      : freeEntries(pFreeEntries)
+      , freeSince(pFreeSince)
+      , mapped(pMapped)
+      , released(false)
+    {}
+    
+    /* number of chunk entries in the pool free-list. Entries in thread magazines are counted as used */
+    v_int32 freeEntries;
+    /* micro tick when all entries of the chunk became free */
+    v_int64 freeSince;
+    bool mapped;
+    bool released;
+    
+  };
+  
   class EntryHeader {
   public:
     
-    EntryHeader(MemoryPool* pPool, v_int64 pPoolId, EntryHeader* pNext)
+    EntryHeader(MemoryPool* pPool, v_int64 pPoolId, Chunk* pChunk, EntryHeader* pNext)
       : pool(pPool)
       , poolId(pPoolId)
+      , chunk(pChunk)
       , next(pNext)
     {}
     
     MemoryPool* pool;
     v_int64 poolId;
+    Chunk* chunk;
     EntryHeader* next;
     
   };
   
+  /**
+   * Per-thread cache of free entries. Holds one magazine (short free-list) per pool used by the thread.
+   * Defined in MemoryPool.cpp.
+   */
+  class ThreadCache;
+  
+private:
+  static const v_int32 CHUNK_HEADER_SIZE;
+  static v_int32 getBackingPageSize(v_int32 backing);
+  /* called under POOLS_ATOM */
+  static v_int32 acquireSlot();
+  static void releaseSlot(v_int32 slot);
 private:
   void allocChunk();
+  void freeChunk(Chunk* chunk);
+  void drainFreeStack();
+  void addObjectsCount(v_int32 delta, v_int32 peakDelta);
+  v_int32 takeEntries(v_int32 count, EntryHeader*& head, EntryHeader*& tail);
+  void pushFreeEntries(EntryHeader* first, EntryHeader* last);
 private:
   std::string m_name;
   v_int32 m_entrySize;
   v_int32 m_chunkSize;
+  v_int32 m_magazineSize;
+  v_int32 m_chunkMemSize;
+  v_int32 m_backing;
+  v_int32 m_numaNode;
   v_int64 m_id;
-  std::list<p_char8> m_chunks;
+  /* index of pool magazine in thread caches - unique among live pools */
+  v_int32 m_slot;
+  std::list<Chunk*> m_chunks;
   EntryHeader* m_rootEntry;
+  /* Lock-free stack of entries returned from thread caches */
+  std::atomic<EntryHeader*> m_freeStack;
   oatpp::concurrency::SpinLock::Atom m_atom;
-  v_int32 m_objectsCount;
+  std::atomic<v_int32> m_objectsCount;
+  std::atomic<v_int32> m_objectsCountHighWaterMark;
+  std::atomic<v_int64> m_allocationsCount;
+  std::atomic<v_int64> m_contendedLocksCount;
 public:
   
-  MemoryPool(const std::string& name, v_int32 entrySize, v_int32 chunkSize)
+  /**
+   * Constructor.
+   * @param name - pool name.
+   * @param entrySize - size of one entry.
+   * @param chunkSize - entries per chunk. With mmap backings chunk is extended to fill its last page.
+   * @param backing - one of `BACKING_DEFAULT`, `BACKING_MMAP`, `BACKING_HUGE_PAGES`.
+   * @param numaNode - NUMA node to place mapped chunks on (best effort, Linux only). -1 - no preference.
+   */
+  MemoryPool(const std::string& name, v_int32 entrySize, v_int32 chunkSize,
+             v_int32 backing = BACKING_DEFAULT, v_int32 numaNode = -1)
     : m_name(name)
     , m_entrySize(entrySize)
     , m_chunkSize(chunkSize)
+    , m_chunkMemSize(CHUNK_HEADER_SIZE + (v_int32)(sizeof(EntryHeader) + entrySize) * chunkSize)
+    , m_backing(backing)
+    , m_numaNode(numaNode)
     , m_id(++poolIdCounter)
+    , m_slot(-1)
     , m_rootEntry(nullptr)
+    , m_freeStack(nullptr)
     , m_atom(false)
     , m_objectsCount(0)
+    , m_objectsCountHighWaterMark(0)
+    , m_allocationsCount(0)
+    , m_contendedLocksCount(0)
   {
+    if(m_backing != BACKING_DEFAULT) {
+      v_int32 pageSize = getBackingPageSize(m_backing);
+      m_chunkMemSize = ((m_chunkMemSize + pageSize - 1) / pageSize) * pageSize;
+      m_chunkSize = (m_chunkMemSize - CHUNK_HEADER_SIZE) / (v_int32)(sizeof(EntryHeader) + entrySize);
+    }
+    m_magazineSize = m_chunkSize < OATPP_MEMORY_POOL_MAGAZINE_SIZE ? m_chunkSize : OATPP_MEMORY_POOL_MAGAZINE_SIZE;
+    if(m_magazineSize < 1) {
+      m_magazineSize = 1;
+    }
     allocChunk();
     oatpp::concurrency::SpinLock lock(POOLS_ATOM);
     POOLS[m_id] = this;
+    m_slot = acquireSlot();
   }
   
   virtual ~MemoryPool() {
+    {
+      /* Unregister first - thread caches return entries only to registered pools.
+       * Slot is reused by new pools only after that - magazines of other pools found in the slot are stale. */
+      oatpp::concurrency::SpinLock lock(POOLS_ATOM);
+      POOLS.erase(m_id);
+      releaseSlot(m_slot);
+    }
     auto it = m_chunks.begin();
     while (it != m_chunks.end()) {
-      p_char8 chunk = *it;
-      delete [] chunk;
+      freeChunk(*it);
       it++;
     }
-    oatpp::concurrency::SpinLock lock(POOLS_ATOM);
-    POOLS.erase(m_id);
   }
   
   void* obtain();
@@ -108,17 +264,77 @@ public:
   v_int64 getSize();
   v_int32 getObjectsCount();
   
+  /**
+   * Get statistics snapshot of this pool.
+   * @return - `MemoryPool::Stats`.
+   */
+  Stats getStats();
+  
+  /**
+   * Get statistics snapshots of all registered pools. Can be exposed by a metrics endpoint.
+   * @return - `std::vector` of `MemoryPool::Stats`.
+   */
+  static std::vector<Stats> getAllStats();
+  
+  /**
+   * Release chunks which had all their entries free for at least `minIdleMicroseconds`.
+   * Memory of mapped chunks is unmapped, heap chunks are deleted.
+   * Walks the whole pool free-list under the pool lock - call it from maintenance tasks, not on hot paths.
+   * @param minIdleMicroseconds - min time all chunk entries should stay free for the chunk to be released.
+   * @return - number of released chunks.
+   */
+  v_int32 trim(v_int64 minIdleMicroseconds);
+  
+  /**
+   * Call `MemoryPool::trim()` for each registered pool.
+   * Can be triggered from a background maintenance task or from an admin endpoint.
+   * @param minIdleMicroseconds - min time all chunk entries should stay free for the chunk to be released.
+   * @return - total number of released chunks.
+   */
+  static v_int64 trimAll(v_int64 minIdleMicroseconds);
+  
 };
   
 class ThreadDistributedMemoryPool {
 private:
+  std::string m_name;
   v_int32 m_shardsCount;
+  /* shard `i` is bound to node `i % m_numaNodesCount`. 1 if pool is not NUMA-local */
+  v_int32 m_numaNodesCount;
+  v_int32 m_shardsPerNode;
   MemoryPool** m_shards;
 public:
+  
+  /**
+   * Constructor.
+   * @param name - pool name.
+   * @param entrySize - size of one entry.
+   * @param chunkSize - entries per chunk of each shard.
+   * @param shardsCount - number of shards.
+   * @param backing - backing of shards. See `MemoryPool::BACKING_DEFAULT`.
+   * @param numaLocal - bind shards to NUMA nodes (round-robin) and obtain from shards of the node
+   * the calling thread runs on. Takes effect only on machines with more than one NUMA node.
+   */
   ThreadDistributedMemoryPool(const std::string& name, v_int32 entrySize, v_int32 chunkSize,
-                              v_int32 shardsCount = OATPP_THREAD_DISTRIBUTED_MEM_POOL_SHARDS_COUNT);
+                              v_int32 shardsCount = OATPP_THREAD_DISTRIBUTED_MEM_POOL_SHARDS_COUNT,
+                              v_int32 backing = MemoryPool::BACKING_DEFAULT,
+                              bool numaLocal = false);
   virtual ~ThreadDistributedMemoryPool();
   void* obtain();
+  
+  /**
+   * Call `MemoryPool::trim()` on each shard.
+   * @param minIdleMicroseconds
+   * @return - total number of released chunks.
+   */
+  v_int32 trim(v_int64 minIdleMicroseconds);
+  
+  /**
+   * Get statistics of all shards summed up.
+   * High-water mark is a sum of shards high-water marks.
+   * @return - `MemoryPool::Stats`.
+   */
+  MemoryPool::Stats getStats();
 };
   
 template<typename T>
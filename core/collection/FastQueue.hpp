@@ -104,6 +104,22 @@ public:
     }
   }
   
+  /**
+   * Remove entry from the queue without freeing it.
+   */
+  void cutEntry(T* entry, T* prevEntry){
+
+    if(prevEntry == nullptr) {
+      popFront();
+    } else if(entry->_ref == nullptr) {
+      prevEntry->_ref = nullptr;
+      last = prevEntry;
+    } else {
+      prevEntry->_ref = entry->_ref;
+    }
+    entry->_ref = nullptr;
+  }
+
   static void moveEntry(FastQueue& fromQueue, FastQueue& toQueue, T* entry, T* prevEntry){
 
     if(prevEntry == nullptr) {
@@ -0,0 +1,130 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_collection_MPSCQueue_hpp
+#define oatpp_collection_MPSCQueue_hpp
+
+#include "oatpp/core/base/Environment.hpp"
+
+#include <atomic>
+
+namespace oatpp { namespace collection {
+  
+/**
+ * Intrusive lock-free multi-producer single-consumer queue.
+ * T should extend MPSCQueue<T>::Node and have free() method (same as for FastQueue).
+ * push() is thread-safe and wait-free. pop(), isEmpty() - should be called from consumer thread only.
+ */
+template<typename T>
+class MPSCQueue {
+public:
+  
+  class Node {
+    friend MPSCQueue;
+  private:
+    std::atomic<Node*> _next;
+  public:
+    Node()
+      : _next(nullptr)
+    {}
+  };
+  
+private:
+  std::atomic<Node*> m_head; // last pushed. Producers side
+  Node* m_tail; // next to pop. Consumer side
+  Node m_stub;
+private:
+  
+  void pushNode(Node* node) {
+    node->_next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = m_head.exchange(node);
+    prev->_next.store(node);
+  }
+  
+public:
+  
+  MPSCQueue()
+    : m_head(&m_stub)
+    , m_tail(&m_stub)
+  {}
+  
+  ~MPSCQueue() {
+    T* entry;
+    while((entry = pop()) != nullptr) {
+      entry->free();
+    }
+  }
+  
+  void push(T* entry) {
+    pushNode(entry);
+  }
+  
+  /**
+   * Returns nullptr if queue is empty or if producer has not finished push yet.
+   */
+  T* pop() {
+    
+    Node* tail = m_tail;
+    Node* next = tail->_next.load(std::memory_order_acquire);
+    
+    if(tail == &m_stub) {
+      if(next == nullptr) {
+        return nullptr;
+      }
+      m_tail = next;
+      tail = next;
+      next = next->_next.load(std::memory_order_acquire);
+    }
+    
+    if(next != nullptr) {
+      m_tail = next;
+      return static_cast<T*>(tail);
+    }
+    
+    if(tail != m_head.load(std::memory_order_acquire)) {
+      return nullptr; // producer is in the middle of push
+    }
+    
+    pushNode(&m_stub);
+    
+    next = tail->_next.load(std::memory_order_acquire);
+    if(next != nullptr) {
+      m_tail = next;
+      return static_cast<T*>(tail);
+    }
+    
+    return nullptr;
+    
+  }
+  
+  bool isEmpty() {
+    return m_tail == &m_stub && m_stub._next.load() == nullptr;
+  }
+  
+};
+  
+}}
+
+#endif /* oatpp_collection_MPSCQueue_hpp */
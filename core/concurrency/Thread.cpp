@@ -28,6 +28,13 @@
   #include <pthread.h>
 #endif
 
+#if defined(__linux__)
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+#include <fstream>
+
 namespace oatpp { namespace concurrency {
 
 v_int32 Thread::setThreadAffinityToOneCpu(std::thread::native_handle_type nativeHandle, v_int32 cpuIndex) {
@@ -74,5 +81,43 @@ v_int32 Thread::getHardwareConcurrency() {
   return concurrency;
 }
   
+v_int32 Thread::calcNumaNodesCount() {
+  /* node list format: "0", "0-1", "0,2-3" */
+  std::ifstream file("/sys/devices/system/node/online");
+  v_int32 maxNode = 0;
+  v_int32 number = 0;
+  char c;
+  while(file.get(c)) {
+    if(c >= '0' && c <= '9') {
+      number = number * 10 + (c - '0');
+    } else {
+      if(number > maxNode) {
+        maxNode = number;
+      }
+      number = 0;
+    }
+  }
+  if(number > maxNode) {
+    maxNode = number;
+  }
+  return maxNode + 1;
+}
+  
+v_int32 Thread::getNumaNodesCount() {
+  static v_int32 count = calcNumaNodesCount();
+  return count;
+}
+  
+v_int32 Thread::getCurrentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu;
+  unsigned node;
+  if(syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 && (v_int32) node < getNumaNodesCount()) {
+    return node;
+  }
+#endif
+  return 0;
+}
+  
 }}
 
@@ -40,6 +40,7 @@ public:
   SHARED_OBJECT_POOL(Shared_Thread_Pool, Thread, 32)
 private:
   static v_int32 calcHardwareConcurrency();
+  static v_int32 calcNumaNodesCount();
 public:
   
   /**
@@ -60,6 +61,18 @@ public:
    */
   static v_int32 getHardwareConcurrency();
   
+  /**
+   * Number of NUMA nodes (highest online node index + 1) as reported by /sys/devices/system/node/online.
+   * Returns 1 if NUMA topology is not available.
+   */
+  static v_int32 getNumaNodesCount();
+  
+  /**
+   * NUMA node of the cpu the calling thread currently runs on.
+   * Returns 0 if NUMA topology is not available.
+   */
+  static v_int32 getCurrentNumaNode();
+  
 private:
   std::thread m_thread;
 public:
@@ -40,7 +40,10 @@ public:
 private:
   // TODO FastAlloc
   static oatpp::base::memory::ThreadDistributedMemoryPool& getBufferPool(){
-    static oatpp::base::memory::ThreadDistributedMemoryPool pool("IOBuffer_Buffer_Pool", BUFFER_SIZE, 32);
+    static oatpp::base::memory::ThreadDistributedMemoryPool pool("IOBuffer_Buffer_Pool", BUFFER_SIZE, 32,
+                                                                 OATPP_THREAD_DISTRIBUTED_MEM_POOL_SHARDS_COUNT,
+                                                                 oatpp::base::memory::MemoryPool::BACKING_BUFFERS,
+                                                                 true);
     return pool;
   }
 private:
@@ -32,6 +32,7 @@
 #include "./List.hpp"
 
 #include "oatpp/core/base/memory/ObjectPool.hpp"
+#include "oatpp/core/base/memory/Arena.hpp"
 #include "oatpp/core/base/Controllable.hpp"
 
 namespace oatpp { namespace data { namespace mapping { namespace type {
@@ -120,6 +120,8 @@ public:
 class StringKeyLabelCI_FAST : public MemoryLabel {
 public:
   
+  StringKeyLabelCI_FAST() : MemoryLabel() {};
+  
   StringKeyLabelCI_FAST(const std::shared_ptr<base::StrBuffer>& memHandle, p_char8 data, v_int32 size);
   StringKeyLabelCI_FAST(const char* constText);
   StringKeyLabelCI_FAST(const oatpp::String& str);
@@ -288,6 +288,21 @@ std::shared_ptr<ChunkedBuffer::Chunks> ChunkedBuffer::getChunks() {
   return chunks;
 }
 
+void ChunkedBuffer::appendToVector(IOVector& vector) {
+  os::io::Library::v_size pos = m_size;
+  auto curr = m_firstEntry;
+  while (pos > 0) {
+    if(pos > CHUNK_ENTRY_SIZE) {
+      vector.add(curr->chunk, CHUNK_ENTRY_SIZE);
+      pos -= CHUNK_ENTRY_SIZE;
+    } else {
+      vector.add(curr->chunk, pos);
+      pos = 0;
+    }
+    curr = curr->next;
+  }
+}
+
 os::io::Library::v_size ChunkedBuffer::getSize(){
   return m_size;
 }
@@ -27,6 +27,8 @@
 
 #include "Stream.hpp"
 
+#include "./IOVector.hpp"
+
 #include "oatpp/core/collection/LinkedList.hpp"
 #include "oatpp/core/async/Coroutine.hpp"
 
@@ -49,7 +51,10 @@ public:
   static oatpp::base::memory::ThreadDistributedMemoryPool& getSegemntPool(){
     static oatpp::base::memory::ThreadDistributedMemoryPool pool(CHUNK_POOL_NAME,
                                                                  (v_int32) CHUNK_ENTRY_SIZE,
-                                                                 (v_int32) CHUNK_CHUNK_SIZE);
+                                                                 (v_int32) CHUNK_CHUNK_SIZE,
+                                                                 OATPP_THREAD_DISTRIBUTED_MEM_POOL_SHARDS_COUNT,
+                                                                 oatpp::base::memory::MemoryPool::BACKING_BUFFERS,
+                                                                 true);
     return pool;
   }
   
@@ -167,6 +172,12 @@ public:
                                            const std::shared_ptr<OutputStream>& stream);
   
   std::shared_ptr<Chunks> getChunks();
+  
+  /**
+   * Add data of all chunks to @vector - no copy.
+   * Buffer must not be modified until vector is written.
+   */
+  void appendToVector(IOVector& vector);
 
   os::io::Library::v_size getSize();
   void clear();
@@ -0,0 +1,112 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "IOVector.hpp"
+
+namespace oatpp { namespace data{ namespace stream {
+  
+IOVector::IOVector()
+  : m_vectors(m_inline)
+  , m_count(0)
+  , m_capacity(INLINE_CAPACITY)
+  , m_pos(0)
+  , m_size(0)
+{}
+
+IOVector::~IOVector() {
+  if(m_vectors != m_inline) {
+    delete [] m_vectors;
+  }
+}
+
+void IOVector::grow() {
+  v_int32 capacity = m_capacity * 2;
+  v_iovec* vectors = new v_iovec[capacity];
+  std::memcpy(vectors, m_vectors, m_count * sizeof(v_iovec));
+  if(m_vectors != m_inline) {
+    delete [] m_vectors;
+  }
+  m_vectors = vectors;
+  m_capacity = capacity;
+}
+
+void IOVector::advance(v_size count) {
+  m_size -= count;
+  while(count > 0 && m_pos < m_count) {
+    v_iovec& curr = m_vectors[m_pos];
+    if(count < (v_size) curr.iov_len) {
+      curr.iov_base = &((p_char8) curr.iov_base)[count];
+      curr.iov_len -= count;
+      return;
+    }
+    count -= curr.iov_len;
+    m_pos ++;
+  }
+}
+
+IOVector::v_size IOVector::writeToStream(OutputStream* stream) {
+  v_size progress = 0;
+  while(m_size > 0) {
+    auto res = stream->writeVector(&m_vectors[m_pos], m_count - m_pos);
+    if(res > 0) {
+      advance(res);
+      progress += res;
+    } else { // if res == 0 then probably stream handles write() error incorrectly. return.
+      if(res == Errors::ERROR_IO_RETRY || res == Errors::ERROR_IO_WAIT_RETRY) {
+        continue;
+      }
+      return progress;
+    }
+  }
+  return progress;
+}
+
+oatpp::async::Action IOVector::writeAsyncInline(OutputStream* stream, const oatpp::async::Action& nextAction) {
+  if(m_size == 0) {
+    return nextAction;
+  }
+  auto res = stream->writeVector(&m_vectors[m_pos], m_count - m_pos);
+  if(res == Errors::ERROR_IO_WAIT_RETRY) {
+    return stream->getWriteWaitAction();
+  } else if(res == Errors::ERROR_IO_RETRY) {
+    return oatpp::async::Action::_REPEAT;
+  } else if(res == Errors::ERROR_IO_PIPE) {
+    return oatpp::async::Action::_ABORT;
+  } else if(res <= 0) {
+    return oatpp::async::Action(oatpp::async::Error(Errors::ERROR_ASYNC_FAILED_TO_WRITE_DATA));
+  }
+  advance(res);
+  if(m_size > 0) {
+    return oatpp::async::Action::_REPEAT;
+  }
+  return nextAction;
+}
+
+void IOVector::clear() {
+  m_count = 0;
+  m_pos = 0;
+  m_size = 0;
+}
+  
+}}}
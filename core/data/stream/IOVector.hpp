@@ -0,0 +1,112 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_data_stream_IOVector_hpp
+#define oatpp_data_stream_IOVector_hpp
+
+#include "./Stream.hpp"
+
+namespace oatpp { namespace data{ namespace stream {
+  
+/**
+ * List of memory regions to be written to stream with one gather write - OutputStream::writeVector().
+ * Data is not copied - regions must stay valid until written.
+ * Partially written vector keeps its position, so write may be resumed.
+ */
+class IOVector {
+public:
+  typedef os::io::Library::v_iovec v_iovec;
+  typedef os::io::Library::v_size v_size;
+public:
+  static constexpr v_int32 INLINE_CAPACITY = 64;
+private:
+  v_iovec m_inline[INLINE_CAPACITY];
+  v_iovec* m_vectors;
+  v_int32 m_count;
+  v_int32 m_capacity;
+  v_int32 m_pos;
+  v_size m_size;
+private:
+  void grow();
+public:
+  
+  IOVector();
+  ~IOVector();
+  
+  IOVector(const IOVector& other) = delete;
+  IOVector& operator=(const IOVector& other) = delete;
+  
+  /**
+   * Add memory region to the end of the vector. Empty regions are skipped.
+   */
+  void add(const void* data, v_size size) {
+    if(size > 0) {
+      if(m_count == m_capacity) {
+        grow();
+      }
+      m_vectors[m_count].iov_base = const_cast<void*>(data);
+      m_vectors[m_count].iov_len = size;
+      m_count ++;
+      m_size += size;
+    }
+  }
+  
+  /**
+   * Mark @count bytes as written.
+   */
+  void advance(v_size count);
+  
+  /**
+   * Write all regions left. Returns number of bytes written.
+   * return result can be < getSize() only in case of some disaster like broken pipe
+   */
+  v_size writeToStream(OutputStream* stream);
+  
+  /**
+   *  Async write without starting new Coroutine.
+   *  Should be called from a separate Coroutine method - method is repeated until all regions are written.
+   */
+  oatpp::async::Action writeAsyncInline(OutputStream* stream, const oatpp::async::Action& nextAction);
+  
+  /**
+   * Number of bytes left to write.
+   */
+  v_size getSize() const {
+    return m_size;
+  }
+  
+  /**
+   * Number of regions left to write.
+   */
+  v_int32 getCount() const {
+    return m_count - m_pos;
+  }
+  
+  void clear();
+  
+};
+  
+}}}
+
+#endif /* oatpp_data_stream_IOVector_hpp */
@@ -25,6 +25,8 @@
 #include "./Stream.hpp"
 #include "oatpp/core/utils/ConversionUtils.hpp"
 
+#include <unistd.h>
+
 namespace oatpp { namespace data{ namespace stream {
   
 const char* const Errors::ERROR_ASYNC_FAILED_TO_WRITE_DATA = "ERROR_ASYNC_FAILED_TO_WRITE_DATA";
@@ -74,6 +76,49 @@ os::io::Library::v_size OutputStream::writeAsString(bool value) {
   }
 }
   
+os::io::Library::v_size OutputStream::writeVector(const os::io::Library::v_iovec* vectors, v_int32 count) {
+  os::io::Library::v_size progress = 0;
+  for(v_int32 i = 0; i < count; i ++) {
+    os::io::Library::v_size size = vectors[i].iov_len;
+    auto res = write(vectors[i].iov_base, size);
+    if(res < 0) {
+      return progress > 0 ? progress : res;
+    }
+    progress += res;
+    if(res < size) {
+      break;
+    }
+  }
+  return progress;
+}
+  
+os::io::Library::v_size OutputStream::writeFile(os::io::Library::v_handle fileHandle,
+                                               os::io::Library::v_size& offset,
+                                               os::io::Library::v_size count)
+{
+  v_char8 buffer[oatpp::data::buffer::IOBuffer::BUFFER_SIZE];
+  if(count > oatpp::data::buffer::IOBuffer::BUFFER_SIZE) {
+    count = oatpp::data::buffer::IOBuffer::BUFFER_SIZE;
+  }
+  auto readCount = pread(fileHandle, buffer, count, offset);
+  if(readCount <= 0) {
+    return -1;
+  }
+  auto res = write(buffer, readCount);
+  if(res > 0) {
+    offset += res;
+  }
+  return res;
+}
+  
+oatpp::async::Action OutputStream::getWriteWaitAction() {
+  return oatpp::async::Action::_WAIT_RETRY;
+}
+  
+oatpp::async::Action InputStream::getReadWaitAction() {
+  return oatpp::async::Action::_WAIT_RETRY;
+}
+  
 // Functions
   
 const std::shared_ptr<OutputStream>& operator <<
@@ -214,6 +259,12 @@ oatpp::async::Action transferAsync(oatpp::async::AbstractCoroutine* parentCorout
     }
     
     Action prepareWrite() {
+      if(m_bytesLeft == m_desiredReadCount) { // nothing read - end of stream
+        if(m_transferSize == 0) {
+          return finish();
+        }
+        return error(Errors::ERROR_ASYNC_FAILED_TO_READ_DATA);
+      }
       m_bytesLeft = m_desiredReadCount - m_bytesLeft;
       m_progress += m_bytesLeft;
       return yieldTo(&TransferCoroutine::doWrite);
@@ -247,7 +298,7 @@ oatpp::async::Action writeSomeDataAsyncInline(oatpp::data::stream::OutputStream*
                                               const oatpp::async::Action& nextAction) {
   auto res = stream->write(data, size);
   if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
-    return oatpp::async::Action::_WAIT_RETRY;
+    return stream->getWriteWaitAction();
   } else if(res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
     return oatpp::async::Action::_REPEAT;
   } else if(res == oatpp::data::stream::Errors::ERROR_IO_PIPE) {
@@ -269,7 +320,7 @@ oatpp::async::Action writeExactSizeDataAsyncInline(oatpp::data::stream::OutputSt
                                               const oatpp::async::Action& nextAction) {
   auto res = stream->write(data, size);
   if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
-    return oatpp::async::Action::_WAIT_RETRY;
+    return stream->getWriteWaitAction();
   } else if(res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
     return oatpp::async::Action::_REPEAT;
   } else if(res == oatpp::data::stream::Errors::ERROR_IO_PIPE) {
@@ -281,7 +332,7 @@ oatpp::async::Action writeExactSizeDataAsyncInline(oatpp::data::stream::OutputSt
   }
   data = &((p_char8) data)[res];
   size = size - res;
-  if(res < size) {
+  if(size > 0) {
     return oatpp::async::Action::_REPEAT;
   }
   return nextAction;
@@ -293,7 +344,7 @@ oatpp::async::Action readSomeDataAsyncInline(oatpp::data::stream::InputStream* s
                                              const oatpp::async::Action& nextAction) {
   auto res = stream->read(data, bytesLeftToRead);
   if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
-    return oatpp::async::Action::_WAIT_RETRY;
+    return stream->getReadWaitAction();
   } else if(res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
     return oatpp::async::Action::_REPEAT;
   } else if( res < 0) {
@@ -311,7 +362,7 @@ oatpp::async::Action readExactSizeDataAsyncInline(oatpp::data::stream::InputStre
                                                   const oatpp::async::Action& nextAction) {
   auto res = stream->read(data, bytesLeftToRead);
   if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
-    return oatpp::async::Action::_WAIT_RETRY;
+    return stream->getReadWaitAction();
   } else if(res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
     return oatpp::async::Action::_REPEAT;
   } else if(res == oatpp::data::stream::Errors::ERROR_IO_PIPE) {
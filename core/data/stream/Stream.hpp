@@ -68,12 +68,36 @@ public:
     return write(&c, 1);
   }
   
+  /**
+   * Write @count memory regions in order, and return number of bytes actually written.
+   * It is a legal case if return result < total size. Caller should handle this!
+   * Default implementation writes regions one by one and stops on the first incomplete write.
+   * Streams backed by OS handle write all regions with one system call.
+   */
+  virtual os::io::Library::v_size writeVector(const os::io::Library::v_iovec* vectors, v_int32 count);
+  
+  /**
+   * Write up to @count bytes of file @fileHandle starting at @offset, and return number of bytes actually written.
+   * @offset is advanced by the number of bytes written.
+   * Default implementation reads the file portion by portion and writes it.
+   * Streams backed by OS handle copy data in kernel - sendfile().
+   */
+  virtual os::io::Library::v_size writeFile(os::io::Library::v_handle fileHandle,
+                                            os::io::Library::v_size& offset,
+                                            os::io::Library::v_size count);
+  
   os::io::Library::v_size writeAsString(v_int32 value);
   os::io::Library::v_size writeAsString(v_int64 value);
   os::io::Library::v_size writeAsString(v_float32 value);
   os::io::Library::v_size writeAsString(v_float64 value);
   os::io::Library::v_size writeAsString(bool value);
   
+  /**
+   * Action to return from coroutine when write() returned ERROR_IO_WAIT_RETRY.
+   * Default is WAIT_RETRY. Streams backed by OS handle return IO_WAIT action.
+   */
+  virtual oatpp::async::Action getWriteWaitAction();
+  
 };
   
 class InputStream {
@@ -83,6 +107,13 @@ public:
    * It is a legal case if return result < count. Caller should handle this!
    */
   virtual os::io::Library::v_size read(void *data, os::io::Library::v_size count) = 0;
+  
+  /**
+   * Action to return from coroutine when read() returned ERROR_IO_WAIT_RETRY.
+   * Default is WAIT_RETRY. Streams backed by OS handle return IO_WAIT action.
+   */
+  virtual oatpp::async::Action getReadWaitAction();
+  
 };
   
 class IOStream : public InputStream, public OutputStream {
@@ -114,9 +145,27 @@ public:
     return m_outputStream->write(data, count);
   }
   
+  os::io::Library::v_size writeVector(const os::io::Library::v_iovec* vectors, v_int32 count) override {
+    return m_outputStream->writeVector(vectors, count);
+  }
+  
+  os::io::Library::v_size writeFile(os::io::Library::v_handle fileHandle,
+                                    os::io::Library::v_size& offset,
+                                    os::io::Library::v_size count) override {
+    return m_outputStream->writeFile(fileHandle, offset, count);
+  }
+  
   os::io::Library::v_size read(void *data, os::io::Library::v_size count) override {
     return m_inputStream->read(data, count);
   }
+  
+  oatpp::async::Action getWriteWaitAction() override {
+    return m_outputStream->getWriteWaitAction();
+  }
+  
+  oatpp::async::Action getReadWaitAction() override {
+    return m_inputStream->getReadWaitAction();
+  }
     
 };
   
@@ -87,6 +87,46 @@ os::io::Library::v_size OutputStreamBufferedProxy::write(const void *data, os::i
   }
 }
 
+os::io::Library::v_size OutputStreamBufferedProxy::writeVector(const os::io::Library::v_iovec* vectors, v_int32 count) {
+  if(m_batching && m_pos == 0) {
+    os::io::Library::v_size size = 0;
+    for(v_int32 i = 0; i < count; i ++) {
+      size += vectors[i].iov_len;
+    }
+    if(size <= m_bufferSize - m_posEnd) {
+      for(v_int32 i = 0; i < count; i ++) {
+        std::memcpy(&m_buffer[m_posEnd], vectors[i].iov_base, vectors[i].iov_len);
+        m_posEnd += (v_bufferSize) vectors[i].iov_len;
+      }
+      return size;
+    }
+  }
+  if(m_pos == 0 && m_posEnd == 0) {
+    return m_outputStream->writeVector(vectors, count);
+  }
+  return OutputStream::writeVector(vectors, count);
+}
+
+os::io::Library::v_size OutputStreamBufferedProxy::writeFile(os::io::Library::v_handle fileHandle,
+                                                             os::io::Library::v_size& offset,
+                                                             os::io::Library::v_size count)
+{
+  auto amount = m_posEnd - m_pos;
+  if(amount > 0) {
+    os::io::Library::v_size result = m_outputStream->write(&m_buffer[m_pos], amount);
+    if(result < 0) {
+      return result;
+    }
+    if(result < amount) {
+      m_pos += (v_bufferSize) result;
+      return Errors::ERROR_IO_RETRY;
+    }
+  }
+  m_pos = 0;
+  m_posEnd = 0;
+  return m_outputStream->writeFile(fileHandle, offset, count);
+}
+
 os::io::Library::v_size OutputStreamBufferedProxy::flush() {
   auto amount = m_posEnd - m_pos;
   if(amount > 0){
@@ -123,7 +163,7 @@ oatpp::async::Action OutputStreamBufferedProxy::flushAsync(oatpp::async::Abstrac
           m_stream->m_posEnd = 0;
           return finish();
         } else if(result == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
-          return oatpp::async::Action::_WAIT_RETRY;
+          return m_stream->m_outputStream->getWriteWaitAction();
         } else if(result == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
           return oatpp::async::Action::_REPEAT;
         } else if(result == oatpp::data::stream::Errors::ERROR_IO_PIPE) {
@@ -188,11 +228,9 @@ os::io::Library::v_size InputStreamBufferedProxy::read(void *data, os::io::Libra
       os::io::Library::v_size bigResult = read(&((p_char8) data) [result], count - result);
       if(bigResult > 0){
         return bigResult + result;
-      } else if(bigResult < 0) {
-        return bigResult;
       }
       
-      return result;
+      return result; // buffered bytes are already copied - error (if any) is returned on next read
       
     } else {
       std::memcpy(data, &m_buffer[m_pos], count);
@@ -207,4 +245,16 @@ os::io::Library::v_size InputStreamBufferedProxy::read(void *data, os::io::Libra
   
 }
   
+os::io::Library::v_size InputStreamBufferedProxy::fillBuffer() {
+  if(m_pos == m_posEnd) {
+    m_pos = 0;
+    m_posEnd = 0;
+  }
+  auto res = m_inputStream->read(&m_buffer[m_posEnd], m_bufferSize - m_posEnd);
+  if(res > 0) {
+    m_posEnd += (v_bufferSize) res;
+  }
+  return res;
+}
+  
 }}}
@@ -44,6 +44,7 @@ private:
   v_bufferSize m_bufferSize;
   v_bufferSize m_pos;
   v_bufferSize m_posEnd;
+  bool m_batching;
 public:
   OutputStreamBufferedProxy(const std::shared_ptr<OutputStream>& outputStream,
                             const std::shared_ptr<oatpp::data::buffer::IOBuffer>& bufferPtr,
@@ -55,6 +56,7 @@ public:
     , m_bufferSize(bufferSize)
     , m_pos(0)
     , m_posEnd(0)
+    , m_batching(false)
   {}
 public:
   
@@ -78,15 +80,42 @@ public:
   }
   
   os::io::Library::v_size write(const void *data, os::io::Library::v_size count) override;
+  
+  /**
+   * Bypass the buffer when it is empty - vector goes to the underlying stream as is.
+   * In batching mode vector fitting the free buffer space is copied to the buffer.
+   */
+  os::io::Library::v_size writeVector(const os::io::Library::v_iovec* vectors, v_int32 count) override;
+  
+  /**
+   * Buffered data is written first, then file goes to the underlying stream.
+   * Returns ERROR_IO_RETRY if buffered data was written partially.
+   */
+  os::io::Library::v_size writeFile(os::io::Library::v_handle fileHandle,
+                                    os::io::Library::v_size& offset,
+                                    os::io::Library::v_size count) override;
+  
   os::io::Library::v_size flush();
   oatpp::async::Action flushAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
                                    const oatpp::async::Action& actionOnFinish);
   
+  oatpp::async::Action getWriteWaitAction() override {
+    return m_outputStream->getWriteWaitAction();
+  }
+  
   void setBufferPosition(v_bufferSize pos, v_bufferSize posEnd){
     m_pos = pos;
     m_posEnd = posEnd;
   }
   
+  /**
+   * Batching mode - small vectors are kept in the buffer to be sent by flush() together with following data.
+   * Used to send responses to several pipelined requests at once.
+   */
+  void setBatching(bool batching) {
+    m_batching = batching;
+  }
+  
 };
   
 class InputStreamBufferedProxy : public oatpp::base::Controllable, public InputStream {
@@ -168,11 +197,43 @@ public:
   
   os::io::Library::v_size read(void *data, os::io::Library::v_size count) override;
   
+  oatpp::async::Action getReadWaitAction() override {
+    return m_inputStream->getReadWaitAction();
+  }
+  
   void setBufferPosition(v_bufferSize pos, v_bufferSize posEnd){
     m_pos = pos;
     m_posEnd = posEnd;
   }
   
+  /**
+   * Data read from the underlying stream but not consumed yet.
+   */
+  p_char8 getBufferedData() {
+    return &m_buffer[m_pos];
+  }
+  
+  v_bufferSize getBufferedSize() {
+    return m_posEnd - m_pos;
+  }
+  
+  /**
+   * Mark @count bytes of buffered data as consumed. Parsers reading straight from getBufferedData() use it.
+   */
+  void consumeBuffered(v_bufferSize count) {
+    m_pos += count;
+    if(m_pos == m_posEnd) {
+      m_pos = 0;
+      m_posEnd = 0;
+    }
+  }
+  
+  /**
+   * Read from the underlying stream to the free space at the end of the buffer.
+   * Returns number of bytes buffered or error (as read() does).
+   */
+  os::io::Library::v_size fillBuffer();
+  
 };
   
 }}}
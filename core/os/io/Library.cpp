@@ -25,8 +25,15 @@
 #include "Library.hpp"
 
 #include <memory>
+#include <cstring>
 #include <unistd.h>
 #include <sys/socket.h>
+#include <climits>
+#include <cerrno>
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
 
 namespace oatpp { namespace os { namespace io {
   
@@ -45,5 +52,32 @@ Library::v_size Library::handle_write(v_handle handle, const void *buf, v_size c
 #endif
   return send(handle, buf, count, flags);
 }
+  
+Library::v_size Library::handle_writev(v_handle handle, const v_iovec* vectors, v_int32 count){
+  v_int32 flags = 0;
+#ifdef MSG_NOSIGNAL
+  flags |= MSG_NOSIGNAL;
+#endif
+  if(count > IOV_MAX) {
+    count = IOV_MAX;
+  }
+  struct msghdr message;
+  std::memset(&message, 0, sizeof(message));
+  message.msg_iov = const_cast<v_iovec*>(vectors);
+  message.msg_iovlen = count;
+  return sendmsg(handle, &message, flags);
+}
+  
+Library::v_size Library::handle_sendfile(v_handle handle, v_handle fileHandle, v_size& offset, v_size count){
+#if defined(__linux__)
+  off_t fileOffset = offset;
+  auto result = sendfile(handle, fileHandle, &fileOffset, count);
+  offset = fileOffset;
+  return result;
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
 
 }}}
@@ -27,12 +27,15 @@
 
 #include "oatpp/core/base/Environment.hpp"
 
+#include <sys/uio.h>
+
 namespace oatpp { namespace os { namespace io {
   
 class Library{
 public:
   typedef v_int32 v_handle;
   typedef ssize_t v_size;
+  typedef struct iovec v_iovec;
 public:
   
   static v_int32 handle_close(v_handle handle);
@@ -40,6 +43,19 @@ public:
   static v_size handle_read(v_handle handle, void *buf, v_size count);
   static v_size handle_write(v_handle handle, const void *buf, v_size count);
   
+  /**
+   * Gather write - write @count memory regions with one system call.
+   * Regions beyond IOV_MAX are left for the next call.
+   */
+  static v_size handle_writev(v_handle handle, const v_iovec* vectors, v_int32 count);
+  
+  /**
+   * Copy @count bytes of file @fileHandle starting at @offset to @handle in kernel - sendfile().
+   * @offset is advanced by the number of bytes written.
+   * Returns -1 with errno ENOSYS where not supported.
+   */
+  static v_size handle_sendfile(v_handle handle, v_handle fileHandle, v_size& offset, v_size count);
+  
 };
   
 }}}
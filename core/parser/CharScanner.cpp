@@ -0,0 +1,280 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "CharScanner.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  #define OATPP_CHAR_SCANNER_X86
+  #include <immintrin.h>
+#endif
+
+namespace oatpp { namespace parser {
+
+namespace {
+  
+v_int32 findRN_scalar(p_char8 data, v_int32 size) {
+  for(v_int32 i = 0; i + 1 < size; i ++) {
+    if(data[i] == '\r' && data[i + 1] == '\n') {
+      return i;
+    }
+  }
+  return -1;
+}
+
+v_int32 findRNRN_scalar(p_char8 data, v_int32 size) {
+  for(v_int32 i = 0; i + 3 < size; i ++) {
+    if(data[i] == '\r' && data[i + 1] == '\n' && data[i + 2] == '\r' && data[i + 3] == '\n') {
+      return i;
+    }
+  }
+  return -1;
+}
+
+v_int32 findOneOf2_scalar(p_char8 data, v_int32 size, v_char8 a, v_char8 b) {
+  for(v_int32 i = 0; i < size; i ++) {
+    if(data[i] == a || data[i] == b) {
+      return i;
+    }
+  }
+  return -1;
+}
+  
+#ifdef OATPP_CHAR_SCANNER_X86
+  
+/*
+ * Vector loops check whole blocks. The tail which doesn't fit a block goes to the scalar loop,
+ * starting where vector loop stopped.
+ */
+
+__attribute__((target("sse2")))
+v_int32 findRN_sse2(p_char8 data, v_int32 size) {
+  const __m128i r = _mm_set1_epi8('\r');
+  const __m128i n = _mm_set1_epi8('\n');
+  v_int32 i = 0;
+  for(; i + 17 <= size; i += 16) {
+    __m128i b0 = _mm_loadu_si128((const __m128i*) &data[i]);
+    __m128i b1 = _mm_loadu_si128((const __m128i*) &data[i + 1]);
+    v_int32 mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(b0, r), _mm_cmpeq_epi8(b1, n)));
+    if(mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  v_int32 result = findRN_scalar(&data[i], size - i);
+  return result < 0 ? -1 : i + result;
+}
+
+__attribute__((target("sse2")))
+v_int32 findRNRN_sse2(p_char8 data, v_int32 size) {
+  const __m128i r = _mm_set1_epi8('\r');
+  const __m128i n = _mm_set1_epi8('\n');
+  v_int32 i = 0;
+  for(; i + 19 <= size; i += 16) {
+    __m128i b0 = _mm_loadu_si128((const __m128i*) &data[i]);
+    __m128i b1 = _mm_loadu_si128((const __m128i*) &data[i + 1]);
+    __m128i b2 = _mm_loadu_si128((const __m128i*) &data[i + 2]);
+    __m128i b3 = _mm_loadu_si128((const __m128i*) &data[i + 3]);
+    __m128i m = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, r), _mm_cmpeq_epi8(b1, n)),
+                              _mm_and_si128(_mm_cmpeq_epi8(b2, r), _mm_cmpeq_epi8(b3, n)));
+    v_int32 mask = _mm_movemask_epi8(m);
+    if(mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  v_int32 result = findRNRN_scalar(&data[i], size - i);
+  return result < 0 ? -1 : i + result;
+}
+
+__attribute__((target("sse2")))
+v_int32 findOneOf2_sse2(p_char8 data, v_int32 size, v_char8 a, v_char8 b) {
+  const __m128i va = _mm_set1_epi8((char) a);
+  const __m128i vb = _mm_set1_epi8((char) b);
+  v_int32 i = 0;
+  for(; i + 16 <= size; i += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i*) &data[i]);
+    v_int32 mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, va), _mm_cmpeq_epi8(block, vb)));
+    if(mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  v_int32 result = findOneOf2_scalar(&data[i], size - i, a, b);
+  return result < 0 ? -1 : i + result;
+}
+
+__attribute__((target("avx2")))
+v_int32 findRN_avx2(p_char8 data, v_int32 size) {
+  const __m256i r = _mm256_set1_epi8('\r');
+  const __m256i n = _mm256_set1_epi8('\n');
+  v_int32 i = 0;
+  for(; i + 33 <= size; i += 32) {
+    __m256i b0 = _mm256_loadu_si256((const __m256i*) &data[i]);
+    __m256i b1 = _mm256_loadu_si256((const __m256i*) &data[i + 1]);
+    v_word32 mask = (v_word32) _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(b0, r), _mm256_cmpeq_epi8(b1, n)));
+    if(mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  v_int32 result = findRN_sse2(&data[i], size - i);
+  return result < 0 ? -1 : i + result;
+}
+
+__attribute__((target("avx2")))
+v_int32 findRNRN_avx2(p_char8 data, v_int32 size) {
+  const __m256i r = _mm256_set1_epi8('\r');
+  const __m256i n = _mm256_set1_epi8('\n');
+  v_int32 i = 0;
+  for(; i + 35 <= size; i += 32) {
+    __m256i b0 = _mm256_loadu_si256((const __m256i*) &data[i]);
+    __m256i b1 = _mm256_loadu_si256((const __m256i*) &data[i + 1]);
+    __m256i b2 = _mm256_loadu_si256((const __m256i*) &data[i + 2]);
+    __m256i b3 = _mm256_loadu_si256((const __m256i*) &data[i + 3]);
+    __m256i m = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi8(b0, r), _mm256_cmpeq_epi8(b1, n)),
+                                 _mm256_and_si256(_mm256_cmpeq_epi8(b2, r), _mm256_cmpeq_epi8(b3, n)));
+    v_word32 mask = (v_word32) _mm256_movemask_epi8(m);
+    if(mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  v_int32 result = findRNRN_sse2(&data[i], size - i);
+  return result < 0 ? -1 : i + result;
+}
+
+__attribute__((target("avx2")))
+v_int32 findOneOf2_avx2(p_char8 data, v_int32 size, v_char8 a, v_char8 b) {
+  const __m256i va = _mm256_set1_epi8((char) a);
+  const __m256i vb = _mm256_set1_epi8((char) b);
+  v_int32 i = 0;
+  for(; i + 32 <= size; i += 32) {
+    __m256i block = _mm256_loadu_si256((const __m256i*) &data[i]);
+    v_word32 mask = (v_word32) _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, va), _mm256_cmpeq_epi8(block, vb)));
+    if(mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  v_int32 result = findOneOf2_sse2(&data[i], size - i, a, b);
+  return result < 0 ? -1 : i + result;
+}
+  
+#endif
+  
+const CharScanner::Implementation IMPLEMENTATION_SCALAR = {
+  CharScanner::LEVEL_SCALAR, "scalar", &findRN_scalar, &findRNRN_scalar, &findOneOf2_scalar
+};
+  
+#ifdef OATPP_CHAR_SCANNER_X86
+  
+const CharScanner::Implementation IMPLEMENTATION_SSE2 = {
+  CharScanner::LEVEL_SSE2, "sse2", &findRN_sse2, &findRNRN_sse2, &findOneOf2_sse2
+};
+  
+const CharScanner::Implementation IMPLEMENTATION_AVX2 = {
+  CharScanner::LEVEL_AVX2, "avx2", &findRN_avx2, &findRNRN_avx2, &findOneOf2_avx2
+};
+  
+#endif
+  
+}
+  
+/*
+ * Statically initialized to scalar so that scanner is usable from other static initializers,
+ * upgraded to the best implementation during dynamic initialization.
+ */
+const CharScanner::Implementation* CharScanner::s_implementation = &IMPLEMENTATION_SCALAR;
+  
+namespace {
+  
+class ImplementationSelector {
+public:
+  ImplementationSelector() {
+    CharScanner::setImplementation(CharScanner::getBestImplementation());
+  }
+};
+  
+ImplementationSelector selector;
+  
+}
+  
+const CharScanner::Implementation* CharScanner::getImplementation(v_int32 level) {
+  switch(level) {
+    case LEVEL_SCALAR:
+      return &IMPLEMENTATION_SCALAR;
+#ifdef OATPP_CHAR_SCANNER_X86
+    case LEVEL_SSE2:
+      return __builtin_cpu_supports("sse2") ? &IMPLEMENTATION_SSE2 : nullptr;
+    case LEVEL_AVX2:
+      return __builtin_cpu_supports("avx2") ? &IMPLEMENTATION_AVX2 : nullptr;
+#endif
+    default:
+      return nullptr;
+  }
+}
+  
+const CharScanner::Implementation* CharScanner::getBestImplementation() {
+#ifdef OATPP_CHAR_SCANNER_X86
+  __builtin_cpu_init();
+#endif
+  for(v_int32 level = LEVEL_AVX2; level > LEVEL_SCALAR; level --) {
+    const Implementation* implementation = getImplementation(level);
+    if(implementation != nullptr) {
+      return implementation;
+    }
+  }
+  return &IMPLEMENTATION_SCALAR;
+}
+  
+void CharScanner::setImplementation(const Implementation* implementation) {
+  s_implementation = implementation;
+}
+  
+v_int32 CharScanner::findRNRNEnd(p_char8 data, v_int32 pos, v_int32 posEnd, v_word32& accumulator) {
+  
+  static const v_word32 SEQUENCE = ('\r' << 24) | ('\n' << 16) | ('\r' << 8) | ('\n');
+  
+  /* sequence started in previous portions */
+  v_int32 i = pos;
+  for(; i < posEnd && i < pos + 3; i ++) {
+    accumulator = (accumulator << 8) | data[i];
+    if(accumulator == SEQUENCE) {
+      return i + 1;
+    }
+  }
+  
+  /* sequence within this portion */
+  v_int32 found = findRNRN(&data[pos], posEnd - pos);
+  if(found >= 0) {
+    return pos + found + 4;
+  }
+  
+  /* keep last bytes for the next portion */
+  if(i < posEnd - 4) {
+    i = posEnd - 4;
+  }
+  for(; i < posEnd; i ++) {
+    accumulator = (accumulator << 8) | data[i];
+  }
+  
+  return -1;
+  
+}
+  
+}}
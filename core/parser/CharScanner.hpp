@@ -0,0 +1,112 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_parser_CharScanner_hpp
+#define oatpp_parser_CharScanner_hpp
+
+#include "oatpp/core/base/Environment.hpp"
+
+namespace oatpp { namespace parser {
+
+/**
+ * Scanning for protocol delimiters many bytes at a time.
+ * On x86 SSE2 (16 bytes) or AVX2 (32 bytes) implementation is chosen at runtime by CPUID,
+ * other platforms use the scalar implementation.
+ * All find functions return index relative to data, or -1 if not found.
+ */
+class CharScanner {
+public:
+  
+  static constexpr v_int32 LEVEL_SCALAR = 0;
+  static constexpr v_int32 LEVEL_SSE2 = 1;
+  static constexpr v_int32 LEVEL_AVX2 = 2;
+  
+  typedef v_int32 (*FindRN)(p_char8 data, v_int32 size);
+  typedef v_int32 (*FindRNRN)(p_char8 data, v_int32 size);
+  typedef v_int32 (*FindOneOf2)(p_char8 data, v_int32 size, v_char8 a, v_char8 b);
+  
+  struct Implementation {
+    v_int32 level;
+    const char* name;
+    FindRN findRN;
+    FindRNRN findRNRN;
+    FindOneOf2 findOneOf2;
+  };
+  
+private:
+  static const Implementation* s_implementation;
+public:
+  
+  /**
+   * Implementation of given level, or nullptr if not supported by this CPU/build.
+   */
+  static const Implementation* getImplementation(v_int32 level);
+  
+  /**
+   * Best implementation supported by this CPU.
+   */
+  static const Implementation* getBestImplementation();
+  
+  /**
+   * Override the current implementation. For tests and benchmarks.
+   */
+  static void setImplementation(const Implementation* implementation);
+  
+  static const Implementation* getCurrentImplementation() {
+    return s_implementation;
+  }
+  
+  /**
+   * Find "\r\n".
+   */
+  static v_int32 findRN(p_char8 data, v_int32 size) {
+    return s_implementation->findRN(data, size);
+  }
+  
+  /**
+   * Find "\r\n\r\n".
+   */
+  static v_int32 findRNRN(p_char8 data, v_int32 size) {
+    return s_implementation->findRNRN(data, size);
+  }
+  
+  /**
+   * Find first of two chars.
+   */
+  static v_int32 findOneOf2(p_char8 data, v_int32 size, v_char8 a, v_char8 b) {
+    return s_implementation->findOneOf2(data, size, a, b);
+  }
+  
+  /**
+   * Find end of "\r\n\r\n" in a stream read portion by portion.
+   * Accumulator holds last bytes of previous portions (initially 0) and is updated for the next call.
+   * Returns position right after the sequence in [pos, posEnd) or -1.
+   */
+  static v_int32 findRNRNEnd(p_char8 data, v_int32 pos, v_int32 posEnd, v_word32& accumulator);
+  
+};
+  
+}}
+
+#endif /* oatpp_parser_CharScanner_hpp */
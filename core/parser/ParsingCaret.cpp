@@ -23,6 +23,7 @@
  ***************************************************************************/
 
 #include "ParsingCaret.hpp"
+#include "CharScanner.hpp"
 
 #include <stdlib.h>
 #include <cstdlib>
@@ -226,15 +227,17 @@ namespace oatpp { namespace parser {
   
   bool ParsingCaret::findRN() {
     
-    while(m_pos < m_size){
-      if(m_data[m_pos] == '\r'){
-        if(m_pos + 1 < m_size && m_data[m_pos + 1] == '\n'){
-          return true;
-        }
-      }
-      m_pos ++;
+    if(m_pos >= m_size) {
+      return false;
+    }
+    
+    v_int32 found = CharScanner::findRN(&m_data[m_pos], m_size - m_pos);
+    if(found >= 0) {
+      m_pos += found;
+      return true;
     }
     
+    m_pos = m_size;
     return false;
   }
   
@@ -0,0 +1,214 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+#include "Zlib.hpp"
+
+#include <zlib.h>
+
+namespace oatpp { namespace encoding {
+  
+namespace {
+  
+  /* zlib windowBits: 15 - max window. +16 - gzip wrapper. +32 - detect gzip or zlib wrapper on inflate */
+  constexpr v_int32 WINDOW_BITS = 15;
+  constexpr v_int32 WINDOW_BITS_GZIP = WINDOW_BITS + 16;
+  constexpr v_int32 WINDOW_BITS_DETECT = WINDOW_BITS + 32;
+  
+  /* Portion of data passed to zlib at once - avail_in/avail_out are uInt */
+  constexpr oatpp::os::io::Library::v_size MAX_PORTION = 1 << 30;
+  
+}
+  
+// Deflater
+  
+Zlib::Deflater::Deflater(v_int32 format, v_int32 level)
+  : m_zStream(new z_stream())
+  , m_finished(false)
+{
+  if(deflateInit2(m_zStream, level, Z_DEFLATED, format == FORMAT_GZIP ? WINDOW_BITS_GZIP : WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    delete m_zStream;
+    throw std::runtime_error("[oatpp::encoding::Zlib::Deflater::Deflater()]: Can't init zlib deflate");
+  }
+}
+  
+Zlib::Deflater::~Deflater() {
+  deflateEnd(m_zStream);
+  delete m_zStream;
+}
+  
+Zlib::v_size Zlib::Deflater::deflate(const void* in, v_size inSize, void* out, v_size outSize, bool finish, v_size& produced) {
+  
+  produced = 0;
+  if(m_finished) {
+    return 0;
+  }
+  
+  if(inSize > MAX_PORTION) {
+    inSize = MAX_PORTION;
+    finish = false; // the rest of input is not passed yet
+  }
+  if(outSize > MAX_PORTION) {
+    outSize = MAX_PORTION;
+  }
+  
+  m_zStream->next_in = (Bytef*) in;
+  m_zStream->avail_in = (uInt) inSize;
+  m_zStream->next_out = (Bytef*) out;
+  m_zStream->avail_out = (uInt) outSize;
+  
+  auto res = ::deflate(m_zStream, finish ? Z_FINISH : Z_NO_FLUSH);
+  if(res == Z_STREAM_ERROR) {
+    return -1;
+  }
+  if(res == Z_STREAM_END) {
+    m_finished = true;
+  }
+  
+  produced = outSize - m_zStream->avail_out;
+  return inSize - m_zStream->avail_in;
+  
+}
+  
+// DeflateStream
+  
+Zlib::DeflateStream::DeflateStream(const std::shared_ptr<oatpp::data::stream::OutputStream>& stream, v_int32 format, v_int32 level)
+  : m_stream(stream)
+  , m_buffer(oatpp::data::buffer::IOBuffer::createShared())
+  , m_deflater(format, level)
+  , m_finished(false)
+{}
+  
+bool Zlib::DeflateStream::deflateData(const void* data, v_size size, bool finish) {
+  
+  v_size progress = 0;
+  
+  while(true) {
+    
+    v_size produced;
+    auto consumed = m_deflater.deflate(&((p_char8) data)[progress], size - progress,
+                                       m_buffer->getData(), m_buffer->getSize(),
+                                       finish, produced);
+    if(consumed < 0) {
+      return false;
+    }
+    progress += consumed;
+    
+    if(produced > 0 &&
+       oatpp::data::stream::writeExactSizeData(m_stream.get(), m_buffer->getData(), produced) != produced) {
+      return false;
+    }
+    
+    if(finish) {
+      if(m_deflater.isFinished()) {
+        return true;
+      }
+    } else if(progress == size && produced < m_buffer->getSize()) {
+      return true; // output buffer was not full - no more output for now
+    }
+    
+  }
+  
+}
+  
+Zlib::v_size Zlib::DeflateStream::write(const void *data, v_size count) {
+  if(m_finished) {
+    return oatpp::data::stream::Errors::ERROR_IO_PIPE;
+  }
+  if(!deflateData(data, count, false)) {
+    return oatpp::data::stream::Errors::ERROR_IO_PIPE;
+  }
+  return count;
+}
+  
+bool Zlib::DeflateStream::finish() {
+  if(m_finished) {
+    return true;
+  }
+  m_finished = true;
+  return deflateData(nullptr, 0, true);
+}
+  
+// InflateStream
+  
+Zlib::InflateStream::InflateStream(const std::shared_ptr<oatpp::data::stream::InputStream>& stream)
+  : m_stream(stream)
+  , m_buffer(oatpp::data::buffer::IOBuffer::createShared())
+  , m_zStream(new z_stream())
+  , m_finished(false)
+{
+  if(inflateInit2(m_zStream, WINDOW_BITS_DETECT) != Z_OK) {
+    delete m_zStream;
+    throw std::runtime_error("[oatpp::encoding::Zlib::InflateStream::InflateStream()]: Can't init zlib inflate");
+  }
+}
+  
+Zlib::InflateStream::~InflateStream() {
+  inflateEnd(m_zStream);
+  delete m_zStream;
+}
+  
+Zlib::v_size Zlib::InflateStream::read(void *data, v_size count) {
+  
+  if(m_finished || count == 0) {
+    return 0;
+  }
+  if(count > MAX_PORTION) {
+    count = MAX_PORTION;
+  }
+  
+  m_zStream->next_out = (Bytef*) data;
+  m_zStream->avail_out = (uInt) count;
+  
+  while(true) {
+    
+    if(m_zStream->avail_in == 0) {
+      auto res = m_stream->read(m_buffer->getData(), m_buffer->getSize());
+      if(res <= 0) {
+        if(res == 0) {
+          throw DecodingError("[oatpp::encoding::Zlib::InflateStream::read()]: Unexpected end of compressed data");
+        }
+        return res;
+      }
+      m_zStream->next_in = (Bytef*) m_buffer->getData();
+      m_zStream->avail_in = (uInt) res;
+    }
+    
+    auto res = inflate(m_zStream, Z_NO_FLUSH);
+    v_size produced = count - m_zStream->avail_out;
+    
+    if(res == Z_STREAM_END) {
+      m_finished = true;
+      return produced;
+    } else if(res != Z_OK && res != Z_BUF_ERROR) {
+      throw DecodingError("[oatpp::encoding::Zlib::InflateStream::read()]: Invalid compressed data");
+    }
+    
+    if(produced > 0) {
+      return produced;
+    }
+    
+  }
+  
+}
+  
+}}
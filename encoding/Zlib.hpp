@@ -0,0 +1,168 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+#ifndef oatpp_encoding_Zlib_hpp
+#define oatpp_encoding_Zlib_hpp
+
+#include "oatpp/core/data/stream/Stream.hpp"
+#include "oatpp/core/data/buffer/IOBuffer.hpp"
+
+struct z_stream_s;
+
+namespace oatpp { namespace encoding {
+  
+/**
+ * Streaming gzip/deflate compression with zlib.
+ * Available if oatpp is built with zlib (OATPP_ZLIB is defined).
+ */
+class Zlib {
+public:
+  typedef oatpp::os::io::Library::v_size v_size;
+public:
+  /**
+   * zlib format - HTTP "deflate" content-coding.
+   */
+  static constexpr v_int32 FORMAT_DEFLATE = 0;
+  /**
+   * gzip format - HTTP "gzip" content-coding.
+   */
+  static constexpr v_int32 FORMAT_GZIP = 1;
+  
+  static constexpr v_int32 LEVEL_DEFAULT = -1;
+  static constexpr v_int32 LEVEL_FASTEST = 1;
+  static constexpr v_int32 LEVEL_BEST = 9;
+public:
+  
+  class DecodingError : public std::runtime_error {
+  public:
+    
+    DecodingError(const char* message)
+      :std::runtime_error(message)
+    {}
+    
+  };
+  
+public:
+  
+  /**
+   * Compresses data portion by portion to caller's output buffer.
+   * For callers which can't block on output - e.g. coroutines writing to non-blocking stream.
+   */
+  class Deflater {
+  private:
+    z_stream_s* m_zStream;
+    bool m_finished;
+  public:
+    
+    Deflater(v_int32 format, v_int32 level);
+    ~Deflater();
+    
+    Deflater(const Deflater&) = delete;
+    Deflater& operator=(const Deflater&) = delete;
+    
+    /**
+     * Compress @inSize bytes of @in to @out of @outSize bytes.
+     * @finish - true if there will be no more input. Call until isFinished() to get the stream trailer.
+     * @produced - number of bytes written to @out.
+     * Returns number of bytes consumed from @in or -1 on error. Less than @inSize is consumed if @out is full.
+     */
+    v_size deflate(const void* in, v_size inSize, void* out, v_size outSize, bool finish, v_size& produced);
+    
+    /**
+     * True when the whole compressed stream including trailer is produced.
+     */
+    bool isFinished() const {
+      return m_finished;
+    }
+    
+  };
+  
+public:
+  
+  /**
+   * Compresses data written to it and writes compressed data to @stream.
+   * Compressed data is written in portions of IOBuffer size - memory use doesn't depend on data size.
+   * Call finish() after the last write().
+   */
+  class DeflateStream : public oatpp::base::Controllable, public oatpp::data::stream::OutputStream {
+  private:
+    std::shared_ptr<oatpp::data::stream::OutputStream> m_stream;
+    std::shared_ptr<oatpp::data::buffer::IOBuffer> m_buffer;
+    Deflater m_deflater;
+    bool m_finished;
+  private:
+    bool deflateData(const void* data, v_size size, bool finish);
+  public:
+    
+    DeflateStream(const std::shared_ptr<oatpp::data::stream::OutputStream>& stream, v_int32 format, v_int32 level);
+    
+    static std::shared_ptr<DeflateStream> createShared(const std::shared_ptr<oatpp::data::stream::OutputStream>& stream,
+                                                       v_int32 format,
+                                                       v_int32 level = LEVEL_DEFAULT) {
+      return std::make_shared<DeflateStream>(stream, format, level);
+    }
+    
+    /**
+     * Blocks until compressed data is written. Returns @count or ERROR_IO_PIPE if @stream failed.
+     */
+    v_size write(const void *data, v_size count) override;
+    
+    /**
+     * Write the rest of compressed data and the stream trailer.
+     */
+    bool finish();
+    
+  };
+  
+  /**
+   * Decompresses data read from @stream. Both gzip and zlib formats are accepted.
+   * read() returns 0 when compressed stream is over. Throws DecodingError on corrupted data.
+   */
+  class InflateStream : public oatpp::base::Controllable, public oatpp::data::stream::InputStream {
+  private:
+    std::shared_ptr<oatpp::data::stream::InputStream> m_stream;
+    std::shared_ptr<oatpp::data::buffer::IOBuffer> m_buffer;
+    z_stream_s* m_zStream;
+    bool m_finished;
+  public:
+    
+    InflateStream(const std::shared_ptr<oatpp::data::stream::InputStream>& stream);
+    ~InflateStream();
+    
+    static std::shared_ptr<InflateStream> createShared(const std::shared_ptr<oatpp::data::stream::InputStream>& stream) {
+      return std::make_shared<InflateStream>(stream);
+    }
+    
+    v_size read(void *data, v_size count) override;
+    
+    oatpp::async::Action getReadWaitAction() override {
+      return m_stream->getReadWaitAction();
+    }
+    
+  };
+  
+};
+  
+}}
+
+#endif /* oatpp_encoding_Zlib_hpp */
@@ -57,6 +57,40 @@ Connection::Library::v_size Connection::write(const void *buff, Library::v_size
   return result;
 }
 
+Connection::Library::v_size Connection::writeVector(const Library::v_iovec* vectors, v_int32 count){
+  errno = 0;
+  auto result = Library::handle_writev(m_handle, vectors, count);
+  if(result <= 0) {
+    auto e = errno;
+    if(e == EAGAIN || e == EWOULDBLOCK){
+      return oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY; // For async io. In case socket is non_blocking
+    } else if(e == EINTR) {
+      return oatpp::data::stream::Errors::ERROR_IO_RETRY;
+    } else if(e == EPIPE) {
+      return oatpp::data::stream::Errors::ERROR_IO_PIPE;
+    }
+  }
+  return result;
+}
+
+Connection::Library::v_size Connection::writeFile(Library::v_handle fileHandle, Library::v_size& offset, Library::v_size count){
+  errno = 0;
+  auto result = Library::handle_sendfile(m_handle, fileHandle, offset, count);
+  if(result < 0) {
+    auto e = errno;
+    if(e == EAGAIN || e == EWOULDBLOCK){
+      return oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY; // For async io. In case socket is non_blocking
+    } else if(e == EINTR) {
+      return oatpp::data::stream::Errors::ERROR_IO_RETRY;
+    } else if(e == EPIPE) {
+      return oatpp::data::stream::Errors::ERROR_IO_PIPE;
+    } else if(e == ENOSYS || e == EINVAL) {
+      return OutputStream::writeFile(fileHandle, offset, count); // sendfile is not supported for this file
+    }
+  }
+  return result;
+}
+
 Connection::Library::v_size Connection::read(void *buff, Library::v_size count){
   errno = 0;
   auto result = Library::handle_read(m_handle, buff, count);
@@ -75,8 +109,26 @@ Connection::Library::v_size Connection::read(void *buff, Library::v_size count){
   return result;
 }
 
+oatpp::async::Action Connection::getWriteWaitAction() {
+  return oatpp::async::Action::createIOWaitAction(m_handle, oatpp::async::Action::IO_EVENT_WRITE);
+}
+
+oatpp::async::Action Connection::getReadWaitAction() {
+  return oatpp::async::Action::createIOWaitAction(m_handle, oatpp::async::Action::IO_EVENT_READ);
+}
+
 void Connection::close(){
   Library::handle_close(m_handle);
 }
+  
+void Connection::shutdown(){
+  ::shutdown(m_handle, SHUT_RDWR);
+}
+  
+void Connection::shutdownWrite(){
+  ::shutdown(m_handle, SHUT_WR);
+  v_char8 buffer[256];
+  while(::recv(m_handle, buffer, 256, MSG_DONTWAIT) > 0) {}
+}
 
 }}
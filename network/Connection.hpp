@@ -49,10 +49,27 @@ public:
   ~Connection();
   
   Library::v_size write(const void *buff, Library::v_size count) override;
+  Library::v_size writeVector(const Library::v_iovec* vectors, v_int32 count) override;
+  Library::v_size writeFile(Library::v_handle fileHandle, Library::v_size& offset, Library::v_size count) override;
   Library::v_size read(void *buff, Library::v_size count) override;
   
+  oatpp::async::Action getWriteWaitAction() override;
+  oatpp::async::Action getReadWaitAction() override;
+  
   void close();
   
+  /**
+   * Shut down both directions without closing the handle.
+   * read()/write() blocked in other threads return.
+   */
+  void shutdown();
+  
+  /**
+   * Send FIN to the peer and discard data already received,
+   * so that following close() doesn't reset the connection before the peer reads the response.
+   */
+  void shutdownWrite();
+  
   Library::v_handle getHandle(){
     return m_handle;
   }
@@ -140,7 +140,7 @@ oatpp::async::Action SimpleTCPConnectionProvider::getConnectionAsync(oatpp::asyn
         return _return(oatpp::network::Connection::createShared(m_clientHandle));
       }
       if(errno == EALREADY || errno == EINPROGRESS) {
-        return waitRetry();
+        return ioWait(m_clientHandle, Action::IO_EVENT_WRITE);
       } else if(errno == EINTR) {
         return repeat();
       }
@@ -33,6 +33,15 @@ namespace oatpp { namespace network { namespace server {
 class ConnectionHandler {
 public:
   virtual void handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) = 0;
+  
+  /**
+   * Handle connection accepted on thread @threadIndex of the executor shared with MultiAcceptorServer.
+   * Handlers processing connections on that executor should keep connection on the same thread.
+   * Default implementation ignores @threadIndex.
+   */
+  virtual void handleConnectionOnThread(const std::shared_ptr<oatpp::data::stream::IOStream>& connection, v_int32 /* threadIndex */) {
+    handleConnection(connection);
+  }
 };
   
 }}}
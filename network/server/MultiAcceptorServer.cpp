@@ -0,0 +1,126 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "MultiAcceptorServer.hpp"
+
+namespace oatpp { namespace network { namespace server {
+  
+MultiAcceptorServer::AcceptorCoroutine::AcceptorCoroutine(const std::shared_ptr<State>& state,
+                                                          const std::shared_ptr<SimpleTCPConnectionProvider>& provider,
+                                                          const std::shared_ptr<ConnectionHandler>& handler,
+                                                          v_int32 threadIndex)
+  : m_state(state)
+  , m_provider(provider)
+  , m_handler(handler)
+  , m_threadIndex(threadIndex)
+  , m_retryTime(0)
+{
+  ++ m_state->acceptorsCount;
+}
+  
+MultiAcceptorServer::AcceptorCoroutine::~AcceptorCoroutine() {
+  -- m_state->acceptorsCount;
+}
+  
+oatpp::async::Action MultiAcceptorServer::AcceptorCoroutine::act() {
+  if(m_state->status != Server::STATUS_RUNNING) {
+    return finish();
+  }
+  if(m_retryTime > 0) {
+    v_int64 retryTime = m_retryTime;
+    m_retryTime = 0;
+    return waitUntil(retryTime);
+  }
+  ServerConnectionProvider::AsyncCallback callback =
+  static_cast<ServerConnectionProvider::AsyncCallback>(&AcceptorCoroutine::onConnection);
+  return m_provider->getConnectionAsync(this, callback);
+}
+  
+oatpp::async::Action MultiAcceptorServer::AcceptorCoroutine::onConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) {
+  m_handler->handleConnectionOnThread(connection, m_threadIndex);
+  return yieldTo(&AcceptorCoroutine::act);
+}
+  
+oatpp::async::Action MultiAcceptorServer::AcceptorCoroutine::handleError(const oatpp::async::Error& error) {
+  if(m_state->status != Server::STATUS_RUNNING) {
+    return finish();
+  }
+  OATPP_LOGD("[oatpp::network::server::MultiAcceptorServer::AcceptorCoroutine]", "Error: %s. Retry after %d(micro)",
+             error.message, (v_int32) ACCEPT_RETRY_MICROS);
+  m_retryTime = oatpp::base::Environment::getMicroTickCount() + ACCEPT_RETRY_MICROS;
+  return yieldTo(&AcceptorCoroutine::act);
+}
+  
+MultiAcceptorServer::MultiAcceptorServer(const std::shared_ptr<oatpp::async::Executor>& executor,
+                                         v_word16 port,
+                                         const std::shared_ptr<ConnectionHandler>& connectionHandler)
+  : m_executor(executor)
+  , m_connectionHandler(connectionHandler)
+  , m_providers(new std::shared_ptr<SimpleTCPConnectionProvider>[executor->getThreadsCount()])
+  , m_providersCount(executor->getThreadsCount())
+  , m_state(std::make_shared<State>())
+{
+  m_state->status = Server::STATUS_CREATED;
+  m_state->acceptorsCount = 0;
+  for(v_int32 i = 0; i < m_providersCount; i ++) {
+    m_providers[i] = SimpleTCPConnectionProvider::createShared(port, true /* nonBlocking */, true /* reusePort */);
+  }
+}
+  
+MultiAcceptorServer::~MultiAcceptorServer() {
+  stop();
+  delete [] m_providers;
+}
+  
+void MultiAcceptorServer::start() {
+  v_int32 expected = Server::STATUS_CREATED;
+  if(!m_state->status.compare_exchange_strong(expected, Server::STATUS_RUNNING)) {
+    return;
+  }
+  for(v_int32 i = 0; i < m_providersCount; i ++) {
+    m_executor->executeOn<AcceptorCoroutine>(i, m_state, m_providers[i], m_connectionHandler, i);
+  }
+}
+  
+void MultiAcceptorServer::stop() {
+  v_int32 expected = Server::STATUS_RUNNING;
+  if(!m_state->status.compare_exchange_strong(expected, Server::STATUS_STOPPING)) {
+    return;
+  }
+  /* Wake up acceptors parked on listening sockets */
+  for(v_int32 i = 0; i < m_providersCount; i ++) {
+    m_providers[i]->shutdown();
+  }
+}
+  
+v_int32 MultiAcceptorServer::getStatus() {
+  v_int32 status = m_state->status;
+  if(status == Server::STATUS_STOPPING && m_state->acceptorsCount == 0) {
+    return Server::STATUS_DONE;
+  }
+  return status;
+}
+  
+}}}
@@ -0,0 +1,128 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef network_server_MultiAcceptorServer_hpp
+#define network_server_MultiAcceptorServer_hpp
+
+#include "./ConnectionHandler.hpp"
+#include "./Server.hpp"
+#include "./SimpleTCPConnectionProvider.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include "oatpp/core/base/Controllable.hpp"
+
+#include <atomic>
+
+namespace oatpp { namespace network { namespace server {
+
+/**
+ * Server with one listening socket per executor thread.
+ * All sockets are bound to the same port with SO_REUSEPORT, and kernel load-balances incoming connections between them.
+ * Each executor thread runs its own acceptor coroutine, and passes accepted connections to
+ * ConnectionHandler::handleConnectionOnThread() with its thread index - no cross-thread hand-off.
+ * Use with handler sharing the same executor (ex.: AsyncHttpConnectionHandler).
+ */
+class MultiAcceptorServer : public base::Controllable {
+public:
+  /**
+   * Delay before next accept after accept error other than EAGAIN (ex.: EMFILE).
+   */
+  static constexpr v_int64 ACCEPT_RETRY_MICROS = 100 * 1000;
+private:
+  
+  class State {
+  public:
+    std::atomic<v_int32> status;
+    std::atomic<v_int32> acceptorsCount;
+  };
+  
+  class AcceptorCoroutine : public oatpp::async::Coroutine<AcceptorCoroutine> {
+  private:
+    std::shared_ptr<State> m_state;
+    std::shared_ptr<SimpleTCPConnectionProvider> m_provider;
+    std::shared_ptr<ConnectionHandler> m_handler;
+    v_int32 m_threadIndex;
+    v_int64 m_retryTime;
+  public:
+    
+    AcceptorCoroutine(const std::shared_ptr<State>& state,
+                      const std::shared_ptr<SimpleTCPConnectionProvider>& provider,
+                      const std::shared_ptr<ConnectionHandler>& handler,
+                      v_int32 threadIndex);
+    
+    ~AcceptorCoroutine();
+    
+    Action act() override;
+    Action onConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection);
+    Action handleError(const oatpp::async::Error& error) override;
+    
+  };
+  
+private:
+  std::shared_ptr<oatpp::async::Executor> m_executor;
+  std::shared_ptr<ConnectionHandler> m_connectionHandler;
+  std::shared_ptr<SimpleTCPConnectionProvider>* m_providers;
+  v_int32 m_providersCount;
+  std::shared_ptr<State> m_state;
+public:
+  
+  /**
+   * Opens executor->getThreadsCount() listening sockets on @port.
+   */
+  MultiAcceptorServer(const std::shared_ptr<oatpp::async::Executor>& executor,
+                      v_word16 port,
+                      const std::shared_ptr<ConnectionHandler>& connectionHandler);
+  
+  ~MultiAcceptorServer();
+  
+public:
+  
+  static std::shared_ptr<MultiAcceptorServer> createShared(const std::shared_ptr<oatpp::async::Executor>& executor,
+                                                           v_word16 port,
+                                                           const std::shared_ptr<ConnectionHandler>& connectionHandler){
+    return std::make_shared<MultiAcceptorServer>(executor, port, connectionHandler);
+  }
+  
+  /**
+   * Start acceptor coroutines on executor threads. Non-blocking.
+   */
+  void start();
+  
+  /**
+   * Stop accepting connections. Already accepted connections are not affected.
+   */
+  void stop();
+  
+  /**
+   * One of Server::STATUS_CREATED, STATUS_RUNNING, STATUS_STOPPING, STATUS_DONE.
+   * STATUS_DONE - when all acceptors exited after stop().
+   */
+  v_int32 getStatus();
+  
+};
+  
+}}}
+
+#endif /* network_server_MultiAcceptorServer_hpp */
@@ -37,9 +37,11 @@
 
 namespace oatpp { namespace network { namespace server {
 
-SimpleTCPConnectionProvider::SimpleTCPConnectionProvider(v_word16 port, bool nonBlocking)
+SimpleTCPConnectionProvider::SimpleTCPConnectionProvider(v_word16 port, bool nonBlocking, bool reusePort)
   : m_port(port)
   , m_nonBlocking(nonBlocking)
+  , m_reusePort(reusePort)
+  , m_asyncAccept(false)
 {
   m_serverHandle = instantiateServer();
   setProperty(PROPERTY_HOST, "localhost");
@@ -69,6 +71,19 @@ oatpp::os::io::Library::v_handle SimpleTCPConnectionProvider::instantiateServer(
     OATPP_LOGD("SimpleTCPConnectionProvider", "Warning failed to set %s for accepting socket", "SO_REUSEADDR");
   }
   
+  if(m_reusePort) {
+#ifdef SO_REUSEPORT
+    ret = setsockopt(serverHandle, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(int));
+    if(ret < 0) {
+      oatpp::os::io::Library::handle_close(serverHandle);
+      throw std::runtime_error("[oatpp::network::server::SimpleTCPConnectionProvider::instantiateServer()]: Can't set SO_REUSEPORT");
+    }
+#else
+    oatpp::os::io::Library::handle_close(serverHandle);
+    throw std::runtime_error("[oatpp::network::server::SimpleTCPConnectionProvider::instantiateServer()]: SO_REUSEPORT is not supported");
+#endif
+  }
+  
   ret = bind(serverHandle, (struct sockaddr *)&addr, sizeof(addr));
   
   if(ret != 0) {
@@ -89,20 +104,31 @@ oatpp::os::io::Library::v_handle SimpleTCPConnectionProvider::instantiateServer(
   
 }
   
-std::shared_ptr<oatpp::data::stream::IOStream> SimpleTCPConnectionProvider::getConnection(){
+std::shared_ptr<oatpp::data::stream::IOStream> SimpleTCPConnectionProvider::acceptConnection(v_int32& error){
   
-  //oatpp::test::PerformanceChecker checker("Accept Checker");
+  error = 0;
+  
+#if defined(__linux__)
+  
+  /* Set flags of the new socket in the same syscall */
+  int flags = SOCK_CLOEXEC;
+  if(m_nonBlocking) {
+    flags |= SOCK_NONBLOCK;
+  }
+  oatpp::os::io::Library::v_handle handle = accept4(m_serverHandle, nullptr, nullptr, flags);
+  
+  if (handle < 0) {
+    error = errno;
+    return nullptr;
+  }
+  
+#else
   
   oatpp::os::io::Library::v_handle handle = accept(m_serverHandle, nullptr, nullptr);
   
   if (handle < 0) {
-    v_int32 error = errno;
-    if(error == EAGAIN || error == EWOULDBLOCK){
-      return nullptr;
-    } else {
-      OATPP_LOGD("Server", "Error: %d", error);
-      return nullptr;
-    }
+    error = errno;
+    return nullptr;
   }
   
 #ifdef SO_NOSIGPIPE
@@ -120,8 +146,71 @@ std::shared_ptr<oatpp::data::stream::IOStream> SimpleTCPConnectionProvider::getC
   
   fcntl(handle, F_SETFL, flags);
   
+#endif
+  
   return Connection::createShared(handle);
   
 }
+  
+std::shared_ptr<oatpp::data::stream::IOStream> SimpleTCPConnectionProvider::getConnection(){
+  
+  //oatpp::test::PerformanceChecker checker("Accept Checker");
+  
+  v_int32 error;
+  auto connection = acceptConnection(error);
+  
+  if (!connection) {
+    if(error == EAGAIN || error == EWOULDBLOCK){
+      return nullptr;
+    } else {
+      OATPP_LOGD("Server", "Error: %d", error);
+      return nullptr;
+    }
+  }
+  
+  return connection;
+  
+}
+  
+oatpp::async::Action SimpleTCPConnectionProvider::getConnectionAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                                                                     AsyncCallback callback) {
+  
+  class AcceptCoroutine : public oatpp::async::CoroutineWithResult<AcceptCoroutine, std::shared_ptr<oatpp::data::stream::IOStream>> {
+  private:
+    SimpleTCPConnectionProvider* m_provider;
+  public:
+    
+    AcceptCoroutine(SimpleTCPConnectionProvider* provider)
+      : m_provider(provider)
+    {}
+    
+    Action act() override {
+      v_int32 errorCode;
+      auto connection = m_provider->acceptConnection(errorCode);
+      if(connection) {
+        return _return(connection);
+      }
+      if(errorCode == EAGAIN || errorCode == EWOULDBLOCK) {
+        return ioWait(m_provider->m_serverHandle, Action::IO_EVENT_READ);
+      } else if(errorCode == EINTR || errorCode == ECONNABORTED) {
+        return repeat();
+      }
+      return error("[oatpp::network::server::SimpleTCPConnectionProvider::getConnectionAsync()]: Can't accept connection");
+    }
+    
+  };
+  
+  if(!m_asyncAccept) {
+    fcntl(m_serverHandle, F_SETFL, fcntl(m_serverHandle, F_GETFL) | O_NONBLOCK);
+    m_asyncAccept = true;
+  }
+  
+  return parentCoroutine->startCoroutineForResult<AcceptCoroutine>(callback, this);
+  
+}
+  
+void SimpleTCPConnectionProvider::shutdown() {
+  ::shutdown(m_serverHandle, SHUT_RDWR);
+}
 
 }}}
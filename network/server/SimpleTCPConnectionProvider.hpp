@@ -37,15 +37,24 @@ class SimpleTCPConnectionProvider : public base::Controllable, public ServerConn
 private:
   v_word16 m_port;
   bool m_nonBlocking;
+  bool m_reusePort;
+  bool m_asyncAccept;
   oatpp::os::io::Library::v_handle m_serverHandle;
 private:
   oatpp::os::io::Library::v_handle instantiateServer();
+  std::shared_ptr<IOStream> acceptConnection(v_int32& error);
 public:
-  SimpleTCPConnectionProvider(v_word16 port, bool nonBlocking = false);
+  
+  /**
+   * @nonBlocking - accepted connections are put to non-blocking mode.
+   * @reusePort - set SO_REUSEPORT on the listening socket, so that several providers may listen on the same port.
+   * Kernel distributes incoming connections between them.
+   */
+  SimpleTCPConnectionProvider(v_word16 port, bool nonBlocking = false, bool reusePort = false);
 public:
   
-  static std::shared_ptr<SimpleTCPConnectionProvider> createShared(v_word16 port, bool nonBlocking = false){
-    return std::make_shared<SimpleTCPConnectionProvider>(port, nonBlocking);
+  static std::shared_ptr<SimpleTCPConnectionProvider> createShared(v_word16 port, bool nonBlocking = false, bool reusePort = false){
+    return std::make_shared<SimpleTCPConnectionProvider>(port, nonBlocking, reusePort);
   }
   
   ~SimpleTCPConnectionProvider() {
@@ -54,23 +63,29 @@ public:
   
   std::shared_ptr<IOStream> getConnection() override;
   
+  /**
+   * Accept connection without blocking the thread. Coroutine waits for incoming connection in the IO poller.
+   * Listening socket is switched to non-blocking mode on the first call -
+   * don't mix getConnection() and getConnectionAsync() on the same provider.
+   * Only one coroutine should accept on a provider at a time.
+   */
   Action getConnectionAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
-                            AsyncCallback callback) override {
-    /**
-     *  No need to implement this.
-     *  For Asynchronous IO in oatpp it is considered to be a good practice
-     *  to accept connections in a seperate thread with the blocking accept()
-     *  and then process connections in Asynchronous manner with non-blocking read/write
-     *
-     *  It may be implemented later
-     */
-    throw std::runtime_error("[oatpp::network::server::SimpleTCPConnectionProvider::getConnectionAsync()] not implemented.");
-  }
+                            AsyncCallback callback) override;
+  
+  /**
+   * Stop accepting connections. Pending and future accept calls fail.
+   * Listening socket is closed in destructor.
+   */
+  void shutdown();
   
   v_word16 getPort(){
     return m_port;
   }
   
+  oatpp::os::io::Library::v_handle getHandle(){
+    return m_serverHandle;
+  }
+  
 };
   
 }}}
@@ -1,11 +1,22 @@
 
 #include "oatpp/test/web/FullTest.hpp"
+#include "oatpp/test/web/server/HttpConnectionHandlerTest.hpp"
+#include "oatpp/test/web/server/handler/ResponseCacheTest.hpp"
 #include "oatpp/test/web/FullAsyncTest.hpp"
+#include "oatpp/test/web/url/mapping/RouterTest.hpp"
+#include "oatpp/test/web/protocol/http/HeadersTest.hpp"
+#include "oatpp/test/web/protocol/http/incoming/RequestHeadersReaderTest.hpp"
+#include "oatpp/test/web/protocol/http/incoming/BodyInputStreamTest.hpp"
+#include "oatpp/test/web/protocol/http/incoming/BodyDecoderPerfTest.hpp"
+#include "oatpp/test/web/protocol/http/outgoing/ResponseTest.hpp"
+#include "oatpp/test/web/protocol/http/outgoing/FileBodyTest.hpp"
 
 #include "oatpp/test/network/virtual_/PipeTest.hpp"
 #include "oatpp/test/network/virtual_/InterfaceTest.hpp"
+#include "oatpp/test/network/server/MultiAcceptorServerTest.hpp"
 
 #include "oatpp/test/core/data/share/MemoryLabelTest.hpp"
+#include "oatpp/test/core/data/stream/IOVectorTest.hpp"
 
 #include "oatpp/test/parser/json/mapping/DeserializerTest.hpp"
 #include "oatpp/test/parser/json/mapping/DTOMapperPerfTest.hpp"
@@ -14,12 +25,24 @@
 #include "oatpp/test/encoding/UnicodeTest.hpp"
 #include "oatpp/test/encoding/Base64Test.hpp"
 
+#ifdef OATPP_ZLIB
+#include "oatpp/test/encoding/ZlibTest.hpp"
+#include "oatpp/test/web/protocol/http/outgoing/CompressedBodyTest.hpp"
+#endif
+
 #include "oatpp/test/core/data/mapping/type/TypeTest.hpp"
 #include "oatpp/test/core/base/collection/LinkedListTest.hpp"
+#include "oatpp/test/core/base/collection/MPSCQueueTest.hpp"
 #include "oatpp/test/core/base/memory/MemoryPoolTest.hpp"
+#include "oatpp/test/core/base/memory/ArenaTest.hpp"
 #include "oatpp/test/core/base/memory/PerfTest.hpp"
+#include "oatpp/test/core/base/memory/ThreadCachePerfTest.hpp"
 #include "oatpp/test/core/base/CommandLineArgumentsTest.hpp"
 #include "oatpp/test/core/base/RegRuleTest.hpp"
+#include "oatpp/test/core/async/CoroutineWaitTest.hpp"
+#include "oatpp/test/core/async/IOEventPollerTest.hpp"
+#include "oatpp/test/core/async/ExecutorPerfTest.hpp"
+#include "oatpp/test/core/parser/CharScannerTest.hpp"
 
 #include "oatpp/core/concurrency/SpinLock.hpp"
 #include "oatpp/core/base/Environment.hpp"
@@ -49,17 +72,41 @@ void runTests() {
   OATPP_RUN_TEST(oatpp::test::base::RegRuleTest);
   OATPP_RUN_TEST(oatpp::test::base::CommandLineArgumentsTest);
   OATPP_RUN_TEST(oatpp::test::memory::MemoryPoolTest);
+  OATPP_RUN_TEST(oatpp::test::memory::ArenaTest);
   OATPP_RUN_TEST(oatpp::test::memory::PerfTest);
+  OATPP_RUN_TEST(oatpp::test::memory::ThreadCachePerfTest);
   OATPP_RUN_TEST(oatpp::test::collection::LinkedListTest);
+  OATPP_RUN_TEST(oatpp::test::collection::MPSCQueueTest);
   OATPP_RUN_TEST(oatpp::test::core::data::mapping::type::TypeTest);
   OATPP_RUN_TEST(oatpp::test::parser::json::mapping::DeserializerTest);
   OATPP_RUN_TEST(oatpp::test::parser::json::mapping::DTOMapperPerfTest);
   OATPP_RUN_TEST(oatpp::test::parser::json::mapping::DTOMapperTest);
   OATPP_RUN_TEST(oatpp::test::encoding::Base64Test);
   OATPP_RUN_TEST(oatpp::test::encoding::UnicodeTest);
+#ifdef OATPP_ZLIB
+  OATPP_RUN_TEST(oatpp::test::encoding::ZlibTest);
+#endif
   OATPP_RUN_TEST(oatpp::test::core::data::share::MemoryLabelTest);
+  OATPP_RUN_TEST(oatpp::test::core::data::stream::IOVectorTest);
+  OATPP_RUN_TEST(oatpp::test::parser::CharScannerTest);
+  OATPP_RUN_TEST(oatpp::test::async::IOEventPollerTest);
+  OATPP_RUN_TEST(oatpp::test::async::CoroutineWaitTest);
+  OATPP_RUN_TEST(oatpp::test::async::ExecutorPerfTest);
   OATPP_RUN_TEST(oatpp::test::network::virtual_::PipeTest);
   OATPP_RUN_TEST(oatpp::test::network::virtual_::InterfaceTest);
+  OATPP_RUN_TEST(oatpp::test::network::server::MultiAcceptorServerTest);
+  OATPP_RUN_TEST(oatpp::test::web::url::mapping::RouterTest);
+  OATPP_RUN_TEST(oatpp::test::web::protocol::http::HeadersTest);
+  OATPP_RUN_TEST(oatpp::test::web::protocol::http::incoming::RequestHeadersReaderTest);
+  OATPP_RUN_TEST(oatpp::test::web::protocol::http::incoming::BodyInputStreamTest);
+  OATPP_RUN_TEST(oatpp::test::web::protocol::http::incoming::BodyDecoderPerfTest);
+  OATPP_RUN_TEST(oatpp::test::web::protocol::http::outgoing::ResponseTest);
+  OATPP_RUN_TEST(oatpp::test::web::protocol::http::outgoing::FileBodyTest);
+#ifdef OATPP_ZLIB
+  OATPP_RUN_TEST(oatpp::test::web::protocol::http::outgoing::CompressedBodyTest);
+#endif
+  OATPP_RUN_TEST(oatpp::test::web::server::HttpConnectionHandlerTest);
+  OATPP_RUN_TEST(oatpp::test::web::server::handler::ResponseCacheTest);
   OATPP_RUN_TEST(oatpp::test::web::FullTest);
   OATPP_RUN_TEST(oatpp::test::web::FullAsyncTest);
 }
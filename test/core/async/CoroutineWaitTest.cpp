@@ -0,0 +1,155 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "CoroutineWaitTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+  
+struct Counters {
+  std::atomic<v_int32> sleepersDone;
+  std::atomic<v_int32> timeouts;
+  std::atomic<v_int32> unexpected;
+};
+  
+class SleepCoroutine : public oatpp::async::Coroutine<SleepCoroutine> {
+private:
+  Counters* m_counters;
+  v_int64 m_duration;
+  v_int64 m_start;
+  v_int32 m_waits;
+public:
+  
+  SleepCoroutine(Counters* counters, v_int64 duration)
+    : m_counters(counters)
+    , m_duration(duration)
+    , m_start(0)
+    , m_waits(0)
+  {}
+  
+  Action act() override {
+    m_start = oatpp::base::Environment::getMicroTickCount();
+    return yieldTo(&SleepCoroutine::onWakeUp);
+  }
+  
+  Action onWakeUp() {
+    if(m_start + m_duration > oatpp::base::Environment::getMicroTickCount()) {
+      if(m_waits ++ > 0) {
+        m_counters->unexpected ++; // woken up before deadline
+      }
+      return waitUntil(m_start + m_duration);
+    }
+    m_counters->sleepersDone ++;
+    return finish();
+  }
+  
+};
+
+class IOTimeoutCoroutine : public oatpp::async::Coroutine<IOTimeoutCoroutine> {
+private:
+  Counters* m_counters;
+  oatpp::os::io::Library::v_handle m_handle;
+  v_int64 m_deadline;
+public:
+  
+  IOTimeoutCoroutine(Counters* counters, oatpp::os::io::Library::v_handle handle, v_int64 timeout)
+    : m_counters(counters)
+    , m_handle(handle)
+    , m_deadline(oatpp::base::Environment::getMicroTickCount() + timeout)
+  {}
+  
+  Action act() override {
+    return ioWait(m_handle, Action::IO_EVENT_READ, m_deadline);
+  }
+  
+  Action handleError(const oatpp::async::Error& error) override {
+    if(error.message == oatpp::async::Error::ERROR_TIMEOUT) {
+      if(oatpp::base::Environment::getMicroTickCount() < m_deadline) {
+        m_counters->unexpected ++;
+      }
+      m_counters->timeouts ++;
+      return finish();
+    }
+    return error;
+  }
+  
+};
+  
+}
+  
+bool CoroutineWaitTest::onRun() {
+  
+  Counters counters;
+  counters.sleepersDone = 0;
+  counters.timeouts = 0;
+  counters.unexpected = 0;
+  
+  int pipeHandles[2];
+  OATPP_ASSERT(pipe(pipeHandles) == 0);
+  
+  const v_int32 sleepersCount = 100;
+  const v_int32 ioWaitersCount = 1;
+  
+  oatpp::async::Executor executor(2);
+  
+  v_int64 start = getTickCount();
+  
+  for(v_int32 i = 0; i < sleepersCount; i++) {
+    executor.execute<SleepCoroutine>(&counters, (v_int64)(50 + i) * 1000);
+  }
+  executor.execute<IOTimeoutCoroutine>(&counters, pipeHandles[0], (v_int64) 100 * 1000);
+  
+  while((counters.sleepersDone < sleepersCount || counters.timeouts < ioWaitersCount) &&
+        getTickCount() - start < 5 * 1000 * 1000)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  
+  v_int64 ticks = getTickCount() - start;
+  OATPP_LOGD(TAG, "sleepers done=%d, io timeouts=%d, time=%d(micro)",
+             counters.sleepersDone.load(), counters.timeouts.load(), (v_int32) ticks);
+  
+  executor.stop();
+  executor.join();
+  
+  ::close(pipeHandles[0]);
+  ::close(pipeHandles[1]);
+  
+  OATPP_ASSERT(counters.sleepersDone == sleepersCount);
+  OATPP_ASSERT(counters.timeouts == ioWaitersCount);
+  OATPP_ASSERT(counters.unexpected == 0);
+  OATPP_ASSERT(ticks >= 100 * 1000);
+  
+  return true;
+}
+  
+}}}
@@ -0,0 +1,158 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "ExecutorPerfTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+  
+struct Stats {
+  
+  Stats(v_int32 size)
+    : latencies(size, 0)
+    , count(0)
+  {}
+  
+  std::vector<v_int64> latencies;
+  std::atomic<v_int32> count;
+  
+};
+  
+/**
+ * Long running coroutine which occupies processor thread for 100 micro on each iteration
+ * (ex.: streams large body from blocking file).
+ * Thread is blocked rather than spinning so that results don't depend on number of CPU cores.
+ */
+class HeavyCoroutine : public oatpp::async::Coroutine<HeavyCoroutine> {
+private:
+  v_int32 m_iterationsLeft;
+public:
+  
+  HeavyCoroutine(v_int32 iterations)
+    : m_iterationsLeft(iterations)
+  {}
+  
+  Action act() override {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    if(-- m_iterationsLeft > 0) {
+      return repeat();
+    }
+    return finish();
+  }
+  
+};
+  
+/**
+ * Short coroutine. Measures time from submission to finish
+ */
+class LightCoroutine : public oatpp::async::Coroutine<LightCoroutine> {
+private:
+  Stats* m_stats;
+  v_int64 m_submitTick;
+  v_int32 m_iterationsLeft;
+public:
+  
+  LightCoroutine(Stats* stats, v_int64 submitTick)
+    : m_stats(stats)
+    , m_submitTick(submitTick)
+    , m_iterationsLeft(10)
+  {}
+  
+  Action act() override {
+    if(-- m_iterationsLeft > 0) {
+      return repeat();
+    }
+    v_int32 index = m_stats->count ++;
+    m_stats->latencies[index] = oatpp::base::Environment::getMicroTickCount() - m_submitTick;
+    return finish();
+  }
+  
+};
+  
+v_int64 runSkewedLoad(v_int32 balancerType, const char* TAG) {
+  
+  const v_int32 threadsCount = 4;
+  const v_int32 tasksCount = 2000;
+  const v_int32 heavyTasksCount = 4;
+  
+  Stats stats(tasksCount);
+  v_int32 lightTasksCount = 0;
+  
+  oatpp::async::Executor executor(threadsCount, balancerType);
+  
+  for(v_int32 i = 0; i < tasksCount; i ++) {
+    /* With round-robin all heavy tasks go to the same processor */
+    if(i % threadsCount == 0 && i / threadsCount < heavyTasksCount) {
+      executor.execute<HeavyCoroutine>(3000);
+    } else {
+      executor.execute<LightCoroutine>(&stats, oatpp::base::Environment::getMicroTickCount());
+      lightTasksCount ++;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  
+  v_int64 start = oatpp::base::Environment::getMicroTickCount();
+  while(stats.count < lightTasksCount && oatpp::base::Environment::getMicroTickCount() - start < 10 * 1000 * 1000) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  
+  executor.stop();
+  executor.join();
+  
+  OATPP_ASSERT(stats.count == lightTasksCount);
+  
+  std::sort(stats.latencies.begin(), stats.latencies.begin() + lightTasksCount);
+  v_int64 p50 = stats.latencies[lightTasksCount / 2];
+  v_int64 p99 = stats.latencies[lightTasksCount * 99 / 100];
+  v_int64 max = stats.latencies[lightTasksCount - 1];
+  
+  OATPP_LOGD(TAG, "%s: light tasks=%d, p50=%d(micro), p99=%d(micro), max=%d(micro)",
+             balancerType == oatpp::async::Executor::BALANCER_WORK_STEALING ?
+               "WORK_STEALING (steals not started tasks only)" : "ROUND_ROBIN",
+             lightTasksCount, (v_int32) p50, (v_int32) p99, (v_int32) max);
+  
+  return p99;
+  
+}
+  
+}
+  
+bool ExecutorPerfTest::onRun() {
+  
+  runSkewedLoad(oatpp::async::Executor::BALANCER_ROUND_ROBIN, TAG);
+  runSkewedLoad(oatpp::async::Executor::BALANCER_WORK_STEALING, TAG);
+  
+  return true;
+}
+  
+}}}
@@ -0,0 +1,49 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef test_async_ExecutorPerfTest_hpp
+#define test_async_ExecutorPerfTest_hpp
+
+#include "oatpp/test/UnitTest.hpp"
+
+namespace oatpp { namespace test { namespace async {
+  
+/**
+ * Compare latency of short tasks under skewed load
+ * for ROUND_ROBIN and WORK_STEALING executor balancers.
+ * Covers only tasks queued behind a busy processor - WORK_STEALING steals not yet started tasks,
+ * coroutines already running on a processor are not rebalanced.
+ */
+class ExecutorPerfTest : public UnitTest{
+public:
+  
+  ExecutorPerfTest():UnitTest("TEST[async::ExecutorPerfTest]"){}
+  bool onRun() override;
+  
+};
+  
+}}}
+
+#endif /* test_async_ExecutorPerfTest_hpp */
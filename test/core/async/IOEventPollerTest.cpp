@@ -0,0 +1,161 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "IOEventPollerTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+#include "oatpp/core/async/IOEventPoller.hpp"
+
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+#include <fcntl.h>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+  
+class PipeReaderCoroutine : public oatpp::async::Coroutine<PipeReaderCoroutine> {
+private:
+  oatpp::os::io::Library::v_handle m_handle;
+  std::atomic<v_int32>* m_bytesRead;
+public:
+  
+  PipeReaderCoroutine(oatpp::os::io::Library::v_handle handle, std::atomic<v_int32>* bytesRead)
+    : m_handle(handle)
+    , m_bytesRead(bytesRead)
+  {}
+  
+  Action act() override {
+    v_char8 c;
+    auto res = ::read(m_handle, &c, 1);
+    if(res == 1) {
+      (*m_bytesRead) ++;
+      return finish();
+    }
+    return ioWait(m_handle, Action::IO_EVENT_READ);
+  }
+  
+};
+  
+void testPoller() {
+  
+  oatpp::async::IOEventPoller poller;
+  if(!poller.isAvailable()) {
+    OATPP_LOGD("[IOEventPollerTest]", "IO polling is not available on this platform. Skip poller test");
+    return;
+  }
+  
+  int pipeHandles[2];
+  OATPP_ASSERT(pipe(pipeHandles) == 0);
+  
+  std::atomic<v_int32> bytesRead(0);
+  auto coroutine1 = PipeReaderCoroutine::getBench().obtain(pipeHandles[0], &bytesRead);
+  auto coroutine2 = PipeReaderCoroutine::getBench().obtain(pipeHandles[0], &bytesRead);
+  
+  oatpp::collection::FastQueue<oatpp::async::AbstractCoroutine> readyQueue;
+  
+  OATPP_ASSERT(poller.park(coroutine1, pipeHandles[0], oatpp::async::Action::IO_EVENT_READ));
+  OATPP_ASSERT(poller.getParkedCount() == 1);
+  
+  /* Handle is already taken - caller keeps the coroutine and falls back to the waiting queue */
+  OATPP_ASSERT(!poller.park(coroutine2, pipeHandles[0], oatpp::async::Action::IO_EVENT_READ));
+  OATPP_ASSERT(poller.getParkedCount() == 1);
+  
+  OATPP_ASSERT(poller.poll(readyQueue, 0) == 0);
+  OATPP_ASSERT(readyQueue.first == nullptr);
+  
+  OATPP_ASSERT(::write(pipeHandles[1], "x", 1) == 1);
+  OATPP_ASSERT(poller.poll(readyQueue, 1000) == 1);
+  OATPP_ASSERT(readyQueue.first == coroutine1);
+  OATPP_ASSERT(poller.getParkedCount() == 0);
+  readyQueue.popFront();
+  
+  /* Same handle may be parked again after the event */
+  OATPP_ASSERT(poller.park(coroutine2, pipeHandles[0], oatpp::async::Action::IO_EVENT_READ));
+  OATPP_ASSERT(poller.unpark(pipeHandles[0]) == coroutine2);
+  OATPP_ASSERT(poller.getParkedCount() == 0);
+  
+  /* wakeUp() from another thread interrupts poll() */
+  v_int64 start = oatpp::base::Environment::getMicroTickCount();
+  std::thread waker([&poller]{
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    poller.wakeUp();
+  });
+  OATPP_ASSERT(poller.poll(readyQueue, 5000) == 0);
+  v_int64 ticks = oatpp::base::Environment::getMicroTickCount() - start;
+  waker.join();
+  OATPP_ASSERT(ticks < 1000 * 1000);
+  
+  coroutine1->free();
+  coroutine2->free();
+  
+  ::close(pipeHandles[0]);
+  ::close(pipeHandles[1]);
+  
+}
+  
+void testExecutor() {
+  
+  int pipeHandles[2];
+  OATPP_ASSERT(pipe(pipeHandles) == 0);
+  fcntl(pipeHandles[0], F_SETFL, O_NONBLOCK);
+  
+  std::atomic<v_int32> bytesRead(0);
+  
+  oatpp::async::Executor executor(1);
+  
+  /* First coroutine is parked in the poller, second one falls back to the waiting queue (same handle) */
+  executor.execute<PipeReaderCoroutine>(pipeHandles[0], &bytesRead);
+  executor.execute<PipeReaderCoroutine>(pipeHandles[0], &bytesRead);
+  
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  OATPP_ASSERT(bytesRead == 0);
+  
+  OATPP_ASSERT(::write(pipeHandles[1], "xy", 2) == 2);
+  
+  v_int64 start = oatpp::base::Environment::getMicroTickCount();
+  while(bytesRead < 2 && oatpp::base::Environment::getMicroTickCount() - start < 5 * 1000 * 1000) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  
+  executor.stop();
+  executor.join();
+  
+  ::close(pipeHandles[0]);
+  ::close(pipeHandles[1]);
+  
+  OATPP_ASSERT(bytesRead == 2);
+  
+}
+  
+}
+  
+bool IOEventPollerTest::onRun() {
+  testPoller();
+  testExecutor();
+  return true;
+}
+  
+}}}
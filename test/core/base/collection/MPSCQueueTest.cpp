@@ -0,0 +1,116 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "MPSCQueueTest.hpp"
+
+#include "oatpp/core/collection/MPSCQueue.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace oatpp { namespace test { namespace collection {
+  
+namespace {
+  
+class TestEntry : public oatpp::collection::MPSCQueue<TestEntry>::Node {
+public:
+  
+  static std::atomic<v_int32> freeCount;
+  
+  TestEntry(v_int32 pProducer, v_int32 pNumber)
+    : producer(pProducer)
+    , number(pNumber)
+  {}
+  
+  v_int32 producer;
+  v_int32 number;
+  
+  void free() {
+    freeCount ++;
+    delete this;
+  }
+  
+};
+  
+std::atomic<v_int32> TestEntry::freeCount(0);
+  
+}
+  
+bool MPSCQueueTest::onRun() {
+  
+  const v_int32 producersCount = 4;
+  const v_int32 entriesCount = 100000;
+  
+  {
+    
+    oatpp::collection::MPSCQueue<TestEntry> queue;
+    OATPP_ASSERT(queue.isEmpty());
+    OATPP_ASSERT(queue.pop() == nullptr);
+    
+    std::vector<std::thread> producers;
+    for(v_int32 p = 0; p < producersCount; p ++) {
+      producers.push_back(std::thread([&queue, p, entriesCount]{
+        for(v_int32 i = 0; i < entriesCount; i ++) {
+          queue.push(new TestEntry(p, i));
+        }
+      }));
+    }
+    
+    /* Entries of each producer should come in order */
+    std::vector<v_int32> expected(producersCount, 0);
+    v_int32 received = 0;
+    while(received < producersCount * entriesCount) {
+      TestEntry* entry = queue.pop();
+      if(entry == nullptr) {
+        std::this_thread::yield();
+        continue;
+      }
+      OATPP_ASSERT(entry->number == expected[entry->producer]);
+      expected[entry->producer] ++;
+      received ++;
+      entry->free();
+    }
+    
+    for(auto& producer : producers) {
+      producer.join();
+    }
+    
+    OATPP_ASSERT(queue.pop() == nullptr);
+    OATPP_ASSERT(queue.isEmpty());
+    
+    /* Entries left in the queue are freed by queue destructor */
+    queue.push(new TestEntry(0, 0));
+    queue.push(new TestEntry(0, 1));
+    OATPP_ASSERT(!queue.isEmpty());
+    
+  }
+  
+  OATPP_ASSERT(TestEntry::freeCount == producersCount * entriesCount + 2);
+  
+  return true;
+}
+  
+}}}
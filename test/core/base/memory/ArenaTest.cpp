@@ -0,0 +1,167 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ArenaTest.hpp"
+
+#include "oatpp/core/base/memory/Arena.hpp"
+#include "oatpp/core/base/StrBuffer.hpp"
+#include "oatpp/core/data/mapping/type/Object.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+
+#include <thread>
+#include <vector>
+
+namespace oatpp { namespace test { namespace memory {
+
+namespace {
+  
+#include OATPP_CODEGEN_BEGIN(DTO)
+  
+class ArenaDto : public oatpp::data::mapping::type::Object {
+  
+  DTO_INIT(ArenaDto, Object)
+  
+  DTO_FIELD(String, name);
+  DTO_FIELD(Int32, value);
+  
+};
+  
+#include OATPP_CODEGEN_END(DTO)
+  
+typedef oatpp::base::memory::Arena Arena;
+  
+void testRewind() {
+  
+  Arena arena;
+  
+  void* first = arena.allocate(10);
+  OATPP_ASSERT(((v_word64) first) % Arena::ALIGNMENT == 0);
+  void* second = arena.allocate(100);
+  OATPP_ASSERT(((v_word64) second) % Arena::ALIGNMENT == 0);
+  OATPP_ASSERT((p_char8) second - (p_char8) first == Arena::ALIGNMENT);
+  
+  Arena::deallocate(first);
+  Arena::deallocate(second);
+  
+  arena.reset();
+  OATPP_ASSERT(arena.allocate(10) == first);
+  OATPP_ASSERT(arena.getBlocksCount() == 1);
+  
+}
+  
+void testEscapingObjects() {
+  
+  Arena arena;
+  
+  auto str = oatpp::base::StrBuffer::createShared(arena, "Hello Arena", 11);
+  OATPP_ASSERT(str->equals("Hello Arena"));
+  
+  /* str is still referenced - arena must not rewind over it */
+  arena.reset();
+  auto other = oatpp::base::StrBuffer::createShared(arena, "Another String", 14);
+  OATPP_ASSERT(arena.getBlocksCount() == 2);
+  OATPP_ASSERT(str->equals("Hello Arena"));
+  OATPP_ASSERT(other->equals("Another String"));
+  
+  /* big allocations get own block */
+  auto big = oatpp::base::StrBuffer::createShared(arena, Arena::BLOCK_SIZE * 2);
+  std::memset(big->getData(), 'a', big->getSize());
+  OATPP_ASSERT(big->getData()[big->getSize()] == 0);
+  OATPP_ASSERT(arena.getBlocksCount() == 3);
+  
+}
+  
+void testCycles() {
+  
+  Arena arena;
+  
+  for(v_int32 i = 0; i < 1000; i ++) {
+    
+    arena.reset();
+    
+    auto dto = ArenaDto::createShared(arena);
+    dto->name = oatpp::base::StrBuffer::createShared(arena, "name", 4);
+    dto->value = i;
+    
+    typedef oatpp::base::memory::ArenaAllocator<std::shared_ptr<oatpp::base::StrBuffer>> StringsAllocator;
+    std::vector<std::shared_ptr<oatpp::base::StrBuffer>, StringsAllocator> strings{StringsAllocator(arena)};
+    for(v_int32 j = 0; j < 100; j ++) {
+      strings.push_back(oatpp::base::StrBuffer::createShared(arena, 32));
+    }
+    
+    OATPP_ASSERT(dto->name == "name");
+    OATPP_ASSERT(dto->value->getValue() == i);
+    
+  }
+  
+  /* all objects are released before reset - same block is reused every cycle */
+  OATPP_ASSERT(arena.getBlocksCount() == 1);
+  
+}
+  
+void testRemoteFree() {
+  
+  Arena arena;
+  
+  for(v_int32 i = 0; i < 10; i ++) {
+    
+    arena.reset();
+    
+    std::vector<std::shared_ptr<oatpp::base::StrBuffer>> strings;
+    for(v_int32 j = 0; j < 100; j ++) {
+      strings.push_back(oatpp::base::StrBuffer::createShared(arena, "data", 4));
+    }
+    
+    std::thread thread([&strings] {
+      strings.clear();
+    });
+    thread.join();
+    
+  }
+  
+  OATPP_ASSERT(arena.getBlocksCount() == 1);
+  
+}
+  
+}
+  
+bool ArenaTest::onRun() {
+  
+  testRewind();
+  testEscapingObjects();
+  testCycles();
+  testRemoteFree();
+  
+  /* objects outlive the arena */
+  std::shared_ptr<oatpp::base::StrBuffer> str;
+  {
+    Arena arena;
+    str = oatpp::base::StrBuffer::createShared(arena, "Outlives arena", 14);
+  }
+  OATPP_ASSERT(str->equals("Outlives arena"));
+  
+  return true;
+}
+  
+}}}
@@ -25,8 +25,13 @@
 #include "MemoryPoolTest.hpp"
 
 #include "oatpp/core/base/memory/MemoryPool.hpp"
+#include "oatpp/core/concurrency/Thread.hpp"
 #include "oatpp/test/Checker.hpp"
 
+#include <chrono>
+#include <thread>
+#include <vector>
+
 namespace oatpp { namespace test { namespace memory {
 
 namespace {
@@ -149,6 +154,178 @@ void testPool(v_int32 objectsNumber, v_int32 garbageNumber, v_int32 chunkSize){
     TestClass a(10);
   }
   
+void testTrim(v_int32 entrySize, bool trimAll) {
+  
+  const v_int32 chunkSize = 32;
+  const v_int32 chunksCount = 10;
+  
+  base::memory::MemoryPool pool("MemoryPoolTest::TrimPool", entrySize, chunkSize);
+  
+  std::vector<void*> entries;
+  for(v_int32 i = 0; i < chunkSize * chunksCount; i++){
+    entries.push_back(pool.obtain());
+  }
+  OATPP_ASSERT(pool.getSize() == chunkSize * chunksCount);
+  OATPP_ASSERT(pool.trim(0) == 0);
+  
+  /* entries cached by the freeing thread are returned to the pool when the thread exits */
+  std::thread([&entries]{
+    for(void* entry : entries) {
+      oatpp::base::memory::MemoryPool::free(entry);
+    }
+  }).join();
+  OATPP_ASSERT(pool.getObjectsCount() == 0);
+  
+  /* chunks weren't free long enough */
+  OATPP_ASSERT(pool.trim(60 * 1000 * 1000) == 0);
+  OATPP_ASSERT(pool.getSize() == chunkSize * chunksCount);
+  
+  if(trimAll) {
+    OATPP_ASSERT(oatpp::base::memory::MemoryPool::trimAll(0) >= chunksCount);
+  } else {
+    OATPP_ASSERT(pool.trim(0) == chunksCount);
+  }
+  OATPP_ASSERT(pool.getSize() == 0);
+  
+  /* pool grows again after trim */
+  void* entry = pool.obtain();
+  OATPP_ASSERT(pool.getSize() == chunkSize);
+  oatpp::base::memory::MemoryPool::free(entry);
+  OATPP_ASSERT(pool.getObjectsCount() == 0);
+  
+}
+  
+void testStats() {
+  
+  const v_int32 chunkSize = 16;
+  
+  base::memory::MemoryPool pool("MemoryPoolTest::StatsPool", sizeof(TestClass), chunkSize);
+  
+  std::vector<void*> entries;
+  for(v_int32 i = 0; i < 40; i++){
+    entries.push_back(pool.obtain());
+  }
+  for(v_int32 i = 0; i < 30; i++){
+    oatpp::base::memory::MemoryPool::free(entries[i]);
+  }
+  
+  auto stats = pool.getStats();
+  OATPP_ASSERT(stats.name == "MemoryPoolTest::StatsPool");
+  OATPP_ASSERT(stats.entrySize == sizeof(TestClass));
+  OATPP_ASSERT(stats.objectsCount == 10);
+  OATPP_ASSERT(stats.objectsCountHighWaterMark == 40);
+  OATPP_ASSERT(stats.chunksCount == 3);
+  OATPP_ASSERT(stats.capacity == 3 * chunkSize);
+  OATPP_ASSERT(stats.allocationsCount == 40);
+  OATPP_ASSERT(stats.contendedLocksCount >= 0);
+  
+  /* snapshots don't affect each other - each reader computes rate from its own previous snapshot */
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  for(v_int32 i = 0; i < 10; i++){
+    entries.push_back(pool.obtain());
+  }
+  auto otherReaderStats = pool.getStats();
+  auto nextStats = pool.getStats();
+  OATPP_ASSERT(nextStats.allocationsCount == 50);
+  OATPP_ASSERT(nextStats.timestamp > stats.timestamp);
+  OATPP_ASSERT(nextStats.getAllocationRate(stats) > 0);
+  OATPP_ASSERT(otherReaderStats.getAllocationRate(stats) > 0);
+  OATPP_ASSERT(nextStats.getAllocationRate(nextStats) == 0);
+  
+  bool found = false;
+  for(auto& poolStats : oatpp::base::memory::MemoryPool::getAllStats()) {
+    if(poolStats.name == "MemoryPoolTest::StatsPool") {
+      OATPP_ASSERT(poolStats.objectsCount == 20);
+      found = true;
+    }
+  }
+  OATPP_ASSERT(found);
+  
+  for(v_int32 i = 30; i < 50; i++){
+    oatpp::base::memory::MemoryPool::free(entries[i]);
+  }
+  OATPP_ASSERT(pool.getStats().objectsCount == 0);
+  OATPP_ASSERT(pool.getStats().objectsCountHighWaterMark == 40);
+  
+  base::memory::ThreadDistributedMemoryPool distributedPool("MemoryPoolTest::DistributedStatsPool", sizeof(TestClass), chunkSize, 4);
+  void* entry = distributedPool.obtain();
+  auto distributedStats = distributedPool.getStats();
+  OATPP_ASSERT(distributedStats.name == "MemoryPoolTest::DistributedStatsPool");
+  OATPP_ASSERT(distributedStats.chunksCount == 4);
+  OATPP_ASSERT(distributedStats.objectsCount == 1);
+  OATPP_ASSERT(distributedStats.allocationsCount == 1);
+  oatpp::base::memory::MemoryPool::free(entry);
+  
+}
+  
+void testBacking(v_int32 backing) {
+  
+  const v_int32 entrySize = 4096;
+  const v_int32 chunkSize = 32;
+  
+  base::memory::MemoryPool pool("MemoryPoolTest::BackingPool", entrySize, chunkSize, backing);
+  
+  /* chunk is extended to fill its pages - huge pages fallback keeps the same layout */
+  v_int64 capacity = pool.getSize();
+  OATPP_ASSERT(capacity >= chunkSize);
+  if(backing == base::memory::MemoryPool::BACKING_HUGE_PAGES) {
+    OATPP_ASSERT(capacity * entrySize > OATPP_MEMORY_POOL_HUGE_PAGE_SIZE / 2);
+  }
+  
+  std::vector<void*> entries;
+  for(v_int32 i = 0; i < capacity * 2; i++){
+    void* entry = pool.obtain();
+    std::memset(entry, i, entrySize);
+    entries.push_back(entry);
+  }
+  OATPP_ASSERT(pool.getSize() == capacity * 2);
+  
+  /* entries cached by the freeing thread are returned to the pool when the thread exits */
+  std::thread([&entries]{
+    for(void* entry : entries) {
+      oatpp::base::memory::MemoryPool::free(entry);
+    }
+  }).join();
+  OATPP_ASSERT(pool.getObjectsCount() == 0);
+  
+  OATPP_ASSERT(pool.trim(0) == 2);
+  OATPP_ASSERT(pool.getSize() == 0);
+  
+}
+  
+void testNumaLocal() {
+  
+  OATPP_ASSERT(oatpp::concurrency::Thread::getNumaNodesCount() >= 1);
+  OATPP_ASSERT(oatpp::concurrency::Thread::getCurrentNumaNode() >= 0);
+  OATPP_ASSERT(oatpp::concurrency::Thread::getCurrentNumaNode() < oatpp::concurrency::Thread::getNumaNodesCount());
+  
+  base::memory::ThreadDistributedMemoryPool pool("MemoryPoolTest::NumaPool", 1024, 16, 4,
+                                                 base::memory::MemoryPool::BACKING_MMAP, true);
+  
+  std::vector<std::thread> threads;
+  for(v_int32 i = 0; i < 4; i++) {
+    threads.push_back(std::thread([&pool]{
+      std::vector<void*> entries;
+      for(v_int32 j = 0; j < 100; j++){
+        void* entry = pool.obtain();
+        std::memset(entry, j, 1024);
+        entries.push_back(entry);
+      }
+      for(void* entry : entries) {
+        oatpp::base::memory::MemoryPool::free(entry);
+      }
+    }));
+  }
+  for(auto& thread : threads) {
+    thread.join();
+  }
+  
+  auto stats = pool.getStats();
+  OATPP_ASSERT(stats.objectsCount == 0);
+  OATPP_ASSERT(stats.allocationsCount == 400);
+  
+}
+  
 }
   
 bool MemoryPoolTest::onRun() {
@@ -190,6 +367,17 @@ bool MemoryPoolTest::onRun() {
     }
   }
   
+  /* heap chunks */
+  testTrim(sizeof(TestClass), false);
+  /* mapped chunks */
+  testTrim(4096, true);
+  
+  testStats();
+  
+  testBacking(base::memory::MemoryPool::BACKING_MMAP);
+  testBacking(base::memory::MemoryPool::BACKING_HUGE_PAGES);
+  testNumaLocal();
+  
   return true;
   
 }
@@ -0,0 +1,223 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ThreadCachePerfTest.hpp"
+
+#include "oatpp/core/base/memory/MemoryPool.hpp"
+#include "oatpp/test/Checker.hpp"
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace oatpp { namespace test { namespace memory {
+  
+namespace {
+  
+class TestObject {
+public:
+  
+  TestObject(v_int64 pValue)
+    : value(pValue)
+  {}
+  
+  v_int64 value;
+  v_int64 payload[3];
+  
+};
+  
+class PoolAllocator {
+public:
+  
+  static base::memory::MemoryPool& getPool() {
+    static base::memory::MemoryPool pool("ThreadCachePerfTest::Pool", sizeof(TestObject), 128);
+    return pool;
+  }
+  
+  static TestObject* allocate(v_int64 value) {
+    return new (getPool().obtain()) TestObject(value);
+  }
+  
+  static void free(TestObject* object) {
+    object->~TestObject();
+    base::memory::MemoryPool::free(object);
+  }
+  
+};
+  
+class StdAllocator {
+public:
+  
+  static TestObject* allocate(v_int64 value) {
+    return new TestObject(value);
+  }
+  
+  static void free(TestObject* object) {
+    delete object;
+  }
+  
+};
+  
+void runThreads(v_int32 threadsCount, const std::function<void(v_int32)>& task) {
+  std::vector<std::thread> threads;
+  for(v_int32 i = 0; i < threadsCount; i++) {
+    threads.push_back(std::thread(task, i));
+  }
+  for(auto& thread : threads) {
+    thread.join();
+  }
+}
+
+/*
+ * Each thread allocates and frees its own objects.
+ */
+template<class Allocator>
+void testLocal(v_int32 threadsCount, v_int32 rounds, v_int32 batchSize) {
+  runThreads(threadsCount, [rounds, batchSize](v_int32 thread) {
+    std::vector<TestObject*> batch(batchSize);
+    for(v_int32 r = 0; r < rounds; r++) {
+      for(v_int32 i = 0; i < batchSize; i++) {
+        batch[i] = Allocator::allocate(thread * batchSize + i);
+      }
+      for(v_int32 i = 0; i < batchSize; i++) {
+        OATPP_ASSERT(batch[i]->value == thread * batchSize + i);
+        Allocator::free(batch[i]);
+      }
+    }
+  });
+}
+
+/*
+ * Objects are freed by another thread than the one which allocated them.
+ */
+template<class Allocator>
+void testRemote(v_int32 threadsCount, v_int32 rounds, v_int32 batchSize) {
+  std::vector<std::vector<TestObject*>> batches(threadsCount, std::vector<TestObject*>(batchSize));
+  for(v_int32 r = 0; r < rounds; r++) {
+    runThreads(threadsCount, [&batches, batchSize](v_int32 thread) {
+      for(v_int32 i = 0; i < batchSize; i++) {
+        batches[thread][i] = Allocator::allocate(thread * batchSize + i);
+      }
+    });
+    runThreads(threadsCount, [&batches, threadsCount, batchSize](v_int32 thread) {
+      v_int32 owner = (thread + 1) % threadsCount;
+      for(v_int32 i = 0; i < batchSize; i++) {
+        OATPP_ASSERT(batches[owner][i]->value == owner * batchSize + i);
+        Allocator::free(batches[owner][i]);
+      }
+    });
+  }
+}
+  
+/*
+ * Thread allocates and frees objects of two pools in turn.
+ */
+void testTwoPools(base::memory::MemoryPool& pool1, base::memory::MemoryPool& pool2, v_int32 rounds) {
+  for(v_int32 r = 0; r < rounds; r++) {
+    void* entry1 = pool1.obtain();
+    void* entry2 = pool2.obtain();
+    base::memory::MemoryPool::free(entry1);
+    base::memory::MemoryPool::free(entry2);
+  }
+}
+  
+}
+  
+bool ThreadCachePerfTest::onRun() {
+  
+  const v_int32 maxThreads = 8;
+  const v_int32 batchSize = 1000;
+  const v_int32 localRounds = 200;
+  const v_int32 remoteRounds = 20;
+  
+  for(v_int32 threadsCount = 1; threadsCount <= maxThreads; threadsCount *= 2) {
+    
+    char tag[64];
+    
+    snprintf(tag, 64, "Local  x%d - Pool", threadsCount);
+    {
+      PerformanceChecker checker(tag);
+      testLocal<PoolAllocator>(threadsCount, localRounds, batchSize);
+    }
+    
+    snprintf(tag, 64, "Local  x%d -  new", threadsCount);
+    {
+      PerformanceChecker checker(tag);
+      testLocal<StdAllocator>(threadsCount, localRounds, batchSize);
+    }
+    
+    snprintf(tag, 64, "Remote x%d - Pool", threadsCount);
+    {
+      PerformanceChecker checker(tag);
+      testRemote<PoolAllocator>(threadsCount, remoteRounds, batchSize);
+    }
+    
+    snprintf(tag, 64, "Remote x%d -  new", threadsCount);
+    {
+      PerformanceChecker checker(tag);
+      testRemote<StdAllocator>(threadsCount, remoteRounds, batchSize);
+    }
+    
+  }
+  
+  auto& pool = PoolAllocator::getPool();
+  OATPP_LOGD(TAG, "pool size=%d", (v_int32) pool.getSize());
+  OATPP_ASSERT(pool.getObjectsCount() == 0);
+  
+  /* Entries freed by other threads are reused - pool doesn't grow from round to round */
+  OATPP_ASSERT(pool.getSize() <= 2 * maxThreads * batchSize);
+  
+  {
+    /* Pools created 64 pools apart - they used to share thread cache slot (id % 64) and evict each other's magazine */
+    const v_int32 rounds = 1000000;
+    std::vector<std::unique_ptr<base::memory::MemoryPool>> pools;
+    for(v_int32 i = 0; i < 65; i++) {
+      pools.push_back(std::unique_ptr<base::memory::MemoryPool>(
+        new base::memory::MemoryPool("ThreadCachePerfTest::Pool_" + std::to_string(i), sizeof(TestObject), 128)));
+    }
+    {
+      PerformanceChecker checker("Two pools - adjacent");
+      testTwoPools(*pools[0], *pools[1], rounds);
+    }
+    {
+      PerformanceChecker checker("Two pools - 64 apart");
+      testTwoPools(*pools[0], *pools[64], rounds);
+    }
+    OATPP_ASSERT(pools[0]->getObjectsCount() == 0);
+    OATPP_ASSERT(pools[1]->getObjectsCount() == 0);
+    OATPP_ASSERT(pools[64]->getObjectsCount() == 0);
+    
+    /* slot of destroyed pool is reused - stale magazine of the thread is dropped */
+    pools[64].reset();
+    base::memory::MemoryPool reused("ThreadCachePerfTest::Pool_reused", sizeof(TestObject), 128);
+    testTwoPools(*pools[0], reused, 1000);
+    OATPP_ASSERT(reused.getObjectsCount() == 0);
+  }
+  
+  return true;
+  
+}
+  
+}}}
@@ -0,0 +1,143 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "IOVectorTest.hpp"
+
+#include "oatpp/network/Connection.hpp"
+#include "oatpp/core/data/stream/IOVector.hpp"
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace oatpp { namespace test { namespace core { namespace data { namespace stream {
+  
+namespace {
+  
+typedef oatpp::data::stream::IOVector IOVector;
+  
+/**
+ * Accepts at most @m_portion bytes per call and counts calls
+ */
+class PortionStream : public oatpp::data::stream::OutputStream {
+private:
+  oatpp::data::stream::ChunkedBuffer m_buffer;
+  v_int32 m_portion;
+public:
+  v_int32 callsCount;
+public:
+  
+  PortionStream(v_int32 portion)
+    : m_portion(portion)
+    , callsCount(0)
+  {}
+  
+  os::io::Library::v_size write(const void *data, os::io::Library::v_size count) override {
+    callsCount ++;
+    if(count > m_portion) {
+      count = m_portion;
+    }
+    return m_buffer.write(data, count);
+  }
+  
+  oatpp::String toString() {
+    return m_buffer.toString();
+  }
+  
+};
+  
+}
+  
+bool IOVectorTest::onRun() {
+  
+  oatpp::String expected = "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nHello";
+  
+  {
+    /* partial writes are resumed */
+    IOVector vector;
+    vector.add("HTTP/1.1 200 OK\r\n", 17);
+    vector.add("Content-Length", 14);
+    vector.add(": ", 2);
+    vector.add("", 0);
+    vector.add("5", 1);
+    vector.add("\r\n\r\n", 4);
+    vector.add("Hello", 5);
+    OATPP_ASSERT(vector.getCount() == 6);
+    OATPP_ASSERT(vector.getSize() == expected->getSize());
+    
+    PortionStream stream(3);
+    auto res = vector.writeToStream(&stream);
+    OATPP_ASSERT(res == expected->getSize());
+    OATPP_ASSERT(vector.getSize() == 0);
+    OATPP_ASSERT(vector.getCount() == 0);
+    OATPP_ASSERT(stream.toString()->equals(expected.get()));
+  }
+  
+  {
+    /* more regions than inline capacity, ChunkedBuffer regions */
+    auto buffer = oatpp::data::stream::ChunkedBuffer::createShared();
+    for(v_int32 i = 0; i < 10000; i ++) {
+      buffer->write("0123456789", 10);
+    }
+    
+    IOVector vector;
+    for(v_int32 i = 0; i < IOVector::INLINE_CAPACITY * 2; i ++) {
+      vector.add("abc", 3);
+    }
+    buffer->appendToVector(vector);
+    OATPP_ASSERT(vector.getSize() == IOVector::INLINE_CAPACITY * 6 + 100000);
+    
+    PortionStream stream(1000);
+    vector.writeToStream(&stream);
+    auto result = stream.toString();
+    OATPP_ASSERT(result->getSize() == IOVector::INLINE_CAPACITY * 6 + 100000);
+    OATPP_ASSERT(result->startsWith("abcabc"));
+    OATPP_ASSERT(oatpp::String((const char*)&result->getData()[IOVector::INLINE_CAPACITY * 6], 20, true)->equals("01234567890123456789"));
+  }
+  
+  {
+    /* connection sends vector with sendmsg() */
+    int fds[2];
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    auto connection = oatpp::network::Connection::createShared(fds[0]);
+    
+    IOVector vector;
+    vector.add("HTTP/1.1 200 OK\r\n", 17);
+    vector.add("Content-Length: 5\r\n\r\n", 21);
+    vector.add("Hello", 5);
+    
+    auto res = vector.writeToStream(connection.get());
+    OATPP_ASSERT(res == expected->getSize());
+    
+    v_char8 received[128];
+    auto readSize = ::recv(fds[1], received, 128, 0);
+    OATPP_ASSERT(readSize == expected->getSize());
+    OATPP_ASSERT(std::memcmp(received, expected->getData(), readSize) == 0);
+    ::close(fds[1]);
+  }
+  
+  return true;
+}
+  
+}}}}}
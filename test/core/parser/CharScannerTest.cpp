@@ -0,0 +1,200 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "CharScannerTest.hpp"
+
+#include "oatpp/core/parser/CharScanner.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+#include <cstdlib>
+#include <string>
+
+namespace oatpp { namespace test { namespace parser {
+
+namespace {
+  
+typedef oatpp::parser::CharScanner CharScanner;
+  
+void checkImplementation(const CharScanner::Implementation* reference,
+                         const CharScanner::Implementation* tested)
+{
+  
+  const v_int32 size = 200;
+  v_char8 data[size];
+  const char* alphabet = "\r\n: a";
+  
+  std::srand(1);
+  
+  for(v_int32 round = 0; round < 2000; round ++) {
+    
+    for(v_int32 i = 0; i < size; i ++) {
+      data[i] = alphabet[std::rand() % 5];
+    }
+    
+    /* scan from different offsets and for different sizes - to cover vector blocks and tails */
+    v_int32 offset = std::rand() % 40;
+    v_int32 length = std::rand() % (size - offset);
+    p_char8 start = &data[offset];
+    
+    OATPP_ASSERT(reference->findRN(start, length) == tested->findRN(start, length));
+    OATPP_ASSERT(reference->findRNRN(start, length) == tested->findRNRN(start, length));
+    OATPP_ASSERT(reference->findOneOf2(start, length, ':', ' ') == tested->findOneOf2(start, length, ':', ' '));
+    
+  }
+  
+  /* sequences at every position of a long clean buffer */
+  for(v_int32 pos = 0; pos + 4 <= size; pos ++) {
+    for(v_int32 i = 0; i < size; i ++) {
+      data[i] = 'x';
+    }
+    std::memcpy(&data[pos], "\r\n\r\n", 4);
+    OATPP_ASSERT(tested->findRNRN(data, size) == pos);
+    OATPP_ASSERT(tested->findRN(data, size) == pos);
+    OATPP_ASSERT(tested->findOneOf2(data, size, '\n', ':') == pos + 1);
+  }
+  
+}
+  
+void checkStreaming() {
+  
+  const char* text = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\nbody";
+  v_int32 size = (v_int32) std::strlen(text);
+  v_int32 expected = size - 4;
+  
+  /* split into portions of every size - sequence may span portions */
+  for(v_int32 portion = 1; portion <= size; portion ++) {
+    v_word32 accumulator = 0;
+    v_int32 result = -1;
+    for(v_int32 pos = 0; pos < size && result < 0; pos += portion) {
+      v_int32 posEnd = pos + portion < size ? pos + portion : size;
+      result = CharScanner::findRNRNEnd((p_char8) text, pos, posEnd, accumulator);
+    }
+    OATPP_ASSERT(result == expected);
+  }
+  
+}
+  
+/**
+ * Headers of a typical browser request with large Cookie and Authorization
+ */
+std::string createBrowserHeaders() {
+  
+  std::string cookie;
+  for(v_int32 i = 0; i < 40; i ++) {
+    cookie += "_session_cookie_name_" + std::to_string(i) + "=AbCdEfGhIjKlMnOpQrStUvWxYz0123456789-_AbCdEfGhIjKl; ";
+  }
+  
+  std::string token = "eyJhbGciOiJSUzI1NiIsInR5cCI6IkpXVCJ9.";
+  for(v_int32 i = 0; i < 12; i ++) {
+    token += "eyJzdWIiOiIxMjM0NTY3ODkwIiwibmFtZSI6IkpvaG4gRG9lIiwiYWRtaW4iOnRydWV9";
+  }
+  
+  return
+  "GET /api/v1/users/12345/profile?fields=name,email HTTP/1.1\r\n"
+  "Host: www.example.com\r\n"
+  "Connection: keep-alive\r\n"
+  "Cache-Control: max-age=0\r\n"
+  "sec-ch-ua: \"Chromium\";v=\"118\", \"Google Chrome\";v=\"118\", \"Not=A?Brand\";v=\"99\"\r\n"
+  "sec-ch-ua-mobile: ?0\r\n"
+  "sec-ch-ua-platform: \"macOS\"\r\n"
+  "Upgrade-Insecure-Requests: 1\r\n"
+  "User-Agent: Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/118.0.0.0 Safari/537.36\r\n"
+  "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,image/apng,*/*;q=0.8\r\n"
+  "Sec-Fetch-Site: same-origin\r\n"
+  "Sec-Fetch-Mode: navigate\r\n"
+  "Sec-Fetch-User: ?1\r\n"
+  "Sec-Fetch-Dest: document\r\n"
+  "Referer: https://www.example.com/dashboard\r\n"
+  "Accept-Encoding: gzip, deflate, br\r\n"
+  "Accept-Language: en-US,en;q=0.9,de;q=0.8\r\n"
+  "Authorization: Bearer " + token + "\r\n"
+  "Cookie: " + cookie + "\r\n"
+  "\r\n";
+  
+}
+  
+void runBenchmark(const CharScanner::Implementation* implementation, const std::string& headers, const char* TAG) {
+  
+  const v_int32 iterations = 20000;
+  
+  auto text = oatpp::base::StrBuffer::createShared(headers.data(), (v_int32) headers.size(), true);
+  CharScanner::setImplementation(implementation);
+  
+  v_int64 start = oatpp::base::Environment::getMicroTickCount();
+  
+  for(v_int32 i = 0; i < iterations; i ++) {
+    
+    v_word32 accumulator = 0;
+    v_int32 end = CharScanner::findRNRNEnd(text->getData(), 0, text->getSize(), accumulator);
+    OATPP_ASSERT(end == text->getSize());
+    
+    oatpp::parser::ParsingCaret caret(text->getData(), end);
+    oatpp::web::protocol::http::RequestStartingLine line;
+    oatpp::web::protocol::http::Protocol::Headers parsed;
+    oatpp::web::protocol::http::Status status;
+    oatpp::web::protocol::http::Protocol::parseRequestStartingLine(line, text, caret, status);
+    oatpp::web::protocol::http::Protocol::parseHeaders(parsed, text, caret, status);
+    OATPP_ASSERT(status.code == 0);
+    OATPP_ASSERT(parsed.size() == 18);
+    
+  }
+  
+  v_int64 ticks = oatpp::base::Environment::getMicroTickCount() - start;
+  v_int64 megabytes = (v_int64) headers.size() * iterations / (1024 * 1024);
+  
+  OATPP_LOGD(TAG, "%s: headers=%d(bytes), %d(ns/request), %d(MB/s)",
+             implementation->name, (v_int32) headers.size(),
+             (v_int32) (ticks * 1000 / iterations), (v_int32) (megabytes * 1000 * 1000 / (ticks > 0 ? ticks : 1)));
+  
+}
+  
+}
+  
+bool CharScannerTest::onRun() {
+  
+  const CharScanner::Implementation* current = CharScanner::getCurrentImplementation();
+  const CharScanner::Implementation* scalar = CharScanner::getImplementation(CharScanner::LEVEL_SCALAR);
+  
+  OATPP_LOGD(TAG, "Current implementation - '%s'", current->name);
+  
+  std::string headers = createBrowserHeaders();
+  
+  for(v_int32 level = CharScanner::LEVEL_SCALAR; level <= CharScanner::LEVEL_AVX2; level ++) {
+    const CharScanner::Implementation* implementation = CharScanner::getImplementation(level);
+    if(implementation == nullptr) {
+      OATPP_LOGD(TAG, "Level %d is not supported", level);
+      continue;
+    }
+    checkImplementation(scalar, implementation);
+    CharScanner::setImplementation(implementation);
+    checkStreaming();
+    runBenchmark(implementation, headers, TAG);
+  }
+  
+  CharScanner::setImplementation(current);
+  
+  return true;
+}
+  
+}}}
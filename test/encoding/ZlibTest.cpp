@@ -0,0 +1,141 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ZlibTest.hpp"
+
+#include "oatpp/encoding/Zlib.hpp"
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+
+namespace oatpp { namespace test { namespace encoding {
+  
+namespace {
+  
+typedef oatpp::encoding::Zlib Zlib;
+  
+/**
+ * Stream returning data in portions of fixed size.
+ */
+class PortionsStream : public oatpp::data::stream::InputStream {
+private:
+  oatpp::String m_data;
+  v_int32 m_pos;
+  v_int32 m_portion;
+public:
+  
+  PortionsStream(const oatpp::String& data, v_int32 portion)
+    : m_data(data)
+    , m_pos(0)
+    , m_portion(portion)
+  {}
+  
+  oatpp::os::io::Library::v_size read(void *data, oatpp::os::io::Library::v_size count) override {
+    v_int32 size = m_data->getSize() - m_pos;
+    if(size > count) size = (v_int32) count;
+    if(size > m_portion) size = m_portion;
+    std::memcpy(data, &m_data->getData()[m_pos], size);
+    m_pos += size;
+    return size;
+  }
+  
+};
+  
+oatpp::String compress(const oatpp::String& data, v_int32 format, v_int32 portion) {
+  auto buffer = oatpp::data::stream::ChunkedBuffer::createShared();
+  auto stream = Zlib::DeflateStream::createShared(buffer, format);
+  for(v_int32 pos = 0; pos < data->getSize(); pos += portion) {
+    v_int32 size = data->getSize() - pos;
+    if(size > portion) size = portion;
+    OATPP_ASSERT(stream->write(&data->getData()[pos], size) == size);
+  }
+  OATPP_ASSERT(stream->finish());
+  return buffer->toString();
+}
+  
+oatpp::String decompress(const oatpp::String& data, v_int32 portion) {
+  Zlib::InflateStream stream(std::make_shared<PortionsStream>(data, portion));
+  oatpp::data::stream::ChunkedBuffer buffer;
+  v_char8 readBuffer[1000];
+  oatpp::os::io::Library::v_size res;
+  while((res = stream.read(readBuffer, 1000)) > 0) {
+    buffer.write(readBuffer, res);
+  }
+  OATPP_ASSERT(res == 0);
+  return buffer.toString();
+}
+  
+bool isDecodingError(const oatpp::String& data) {
+  try {
+    decompress(data, 1024);
+  } catch (const Zlib::DecodingError&) {
+    return true;
+  }
+  return false;
+}
+  
+}
+  
+bool ZlibTest::onRun() {
+  
+  oatpp::data::stream::ChunkedBuffer textBuffer;
+  for(v_int32 i = 0; i < 100000; i ++) {
+    textBuffer.write("{\"id\": ", 7);
+    textBuffer.writeAsString(i % 1000);
+    textBuffer.write(", \"name\": \"oat++ web framework\"},", 33);
+  }
+  oatpp::String text = textBuffer.toString();
+  
+  {
+    auto compressed = compress(text, Zlib::FORMAT_GZIP, 777);
+    OATPP_LOGD(TAG, "gzip: %d -> %d bytes", text->getSize(), compressed->getSize());
+    OATPP_ASSERT(compressed->getSize() < text->getSize() / 10);
+    OATPP_ASSERT(compressed->getData()[0] == 0x1F && compressed->getData()[1] == 0x8B);
+    OATPP_ASSERT(decompress(compressed, 1)->equals(text.get()));
+    OATPP_ASSERT(decompress(compressed, 4096)->equals(text.get()));
+  }
+  
+  {
+    auto compressed = compress(text, Zlib::FORMAT_DEFLATE, text->getSize());
+    OATPP_LOGD(TAG, "deflate: %d -> %d bytes", text->getSize(), compressed->getSize());
+    OATPP_ASSERT((compressed->getData()[0] & 0x0F) == 8); // zlib header, method 8 - deflate
+    OATPP_ASSERT(decompress(compressed, 100)->equals(text.get()));
+  }
+  
+  { /* empty data */
+    auto compressed = compress("", Zlib::FORMAT_GZIP, 1);
+    OATPP_ASSERT(compressed->getSize() > 0);
+    OATPP_ASSERT(decompress(compressed, 1)->getSize() == 0);
+  }
+  
+  { /* corrupted and truncated data */
+    auto compressed = compress(text, Zlib::FORMAT_GZIP, 4096);
+    OATPP_ASSERT(isDecodingError(oatpp::String((const char*) compressed->getData(), compressed->getSize() / 2, true)));
+    compressed->getData()[20] ^= 0xFF;
+    OATPP_ASSERT(isDecodingError(compressed));
+    OATPP_ASSERT(isDecodingError("not compressed data"));
+  }
+  
+  return true;
+}
+  
+}}}
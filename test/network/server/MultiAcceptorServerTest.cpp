@@ -0,0 +1,104 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "MultiAcceptorServerTest.hpp"
+
+#include "oatpp/network/server/MultiAcceptorServer.hpp"
+#include "oatpp/network/client/SimpleTCPConnectionProvider.hpp"
+
+#include <thread>
+#include <chrono>
+
+namespace oatpp { namespace test { namespace network { namespace server {
+  
+namespace {
+  
+  const v_word16 PORT = 8765;
+  const v_int32 THREADS_COUNT = 2;
+  
+  class TestHandler : public oatpp::network::server::ConnectionHandler {
+  public:
+    std::atomic<v_int32> connectionsCount;
+    std::atomic<v_int32> wrongThreadCount;
+  public:
+    
+    TestHandler()
+      : connectionsCount(0)
+      , wrongThreadCount(0)
+    {}
+    
+    void handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& /* connection */) override {
+      ++ wrongThreadCount; // connections of MultiAcceptorServer should come with thread index
+    }
+    
+    void handleConnectionOnThread(const std::shared_ptr<oatpp::data::stream::IOStream>& connection, v_int32 threadIndex) override {
+      if(threadIndex < 0 || threadIndex >= THREADS_COUNT) {
+        ++ wrongThreadCount;
+      }
+      ++ connectionsCount;
+      connection->writeChar('x');
+    }
+    
+  };
+  
+}
+  
+bool MultiAcceptorServerTest::onRun() {
+  
+  auto executor = std::make_shared<oatpp::async::Executor>(THREADS_COUNT);
+  auto handler = std::make_shared<TestHandler>();
+  auto server = oatpp::network::server::MultiAcceptorServer::createShared(executor, PORT, handler);
+  
+  server->start();
+  OATPP_ASSERT(server->getStatus() == oatpp::network::server::Server::STATUS_RUNNING);
+  
+  auto clientProvider = oatpp::network::client::SimpleTCPConnectionProvider::createShared("localhost", PORT);
+  
+  const v_int32 connectionsCount = 20;
+  for(v_int32 i = 0; i < connectionsCount; i ++) {
+    auto connection = clientProvider->getConnection();
+    OATPP_ASSERT(connection);
+    v_char8 c = 0;
+    OATPP_ASSERT(connection->read(&c, 1) == 1);
+    OATPP_ASSERT(c == 'x');
+  }
+  
+  OATPP_ASSERT(handler->connectionsCount == connectionsCount);
+  OATPP_ASSERT(handler->wrongThreadCount == 0);
+  
+  server->stop();
+  
+  for(v_int32 i = 0; i < 1000 && server->getStatus() != oatpp::network::server::Server::STATUS_DONE; i ++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  OATPP_ASSERT(server->getStatus() == oatpp::network::server::Server::STATUS_DONE);
+  
+  executor->stop();
+  executor->join();
+  
+  return true;
+}
+  
+}}}}
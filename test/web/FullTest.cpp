@@ -99,6 +99,13 @@ bool FullTest::onRun() {
         OATPP_ASSERT(dto->testValue == "my_test_body");
       }
       
+      { /* test GET with DTO allocated on request arena */
+        auto response = client->getWithArena("my_arena_param");
+        auto dto = response->readBodyToDto<app::TestDto>(objectMapper);
+        OATPP_ASSERT(dto);
+        OATPP_ASSERT(dto->testValue == "my_arena_param");
+      }
+      
     }
     
     try {
@@ -39,6 +39,7 @@ class Client : public oatpp::web::client::ApiClient {
   API_CALL("GET", "params/{param}", getWithParams, PATH(String, param))
   API_CALL("GET", "headers", getWithHeaders, HEADER(String, param, "X-TEST-HEADER"))
   API_CALL("POST", "body", postBody, BODY_STRING(String, body))
+  API_CALL("GET", "arena/{param}", getWithArena, PATH(String, param))
   
 #include OATPP_CODEGEN_END(ApiClient)
 };
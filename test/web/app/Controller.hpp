@@ -76,6 +76,17 @@ public:
     dto->testValue = body;
     return createDtoResponse(Status::CODE_200, dto);
   }
+  
+  ENDPOINT("GET", "arena/{param}", getWithArena,
+           PATH(String, param),
+           REQUEST(std::shared_ptr<IncomingRequest>, request)) {
+    OATPP_LOGD(TAG, "GET arena/%s", param->c_str());
+    auto arena = request->getArena();
+    OATPP_ASSERT(arena != nullptr);
+    auto dto = TestDto::createShared(*arena);
+    dto->testValue = oatpp::base::StrBuffer::createShared(*arena, param->getData(), param->getSize());
+    return createDtoResponse(Status::CODE_200, dto);
+  }
 
 #include OATPP_CODEGEN_END(ApiController)
   
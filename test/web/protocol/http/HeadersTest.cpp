@@ -0,0 +1,130 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "HeadersTest.hpp"
+
+#include "oatpp/web/protocol/http/Http.hpp"
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+namespace oatpp { namespace test { namespace web { namespace protocol { namespace http {
+
+namespace {
+  
+typedef oatpp::web::protocol::http::Headers Headers;
+typedef oatpp::web::protocol::http::Header Header;
+  
+}
+  
+bool HeadersTest::onRun() {
+  
+  {
+    /* parse - well-known headers are interned, multi-value headers are kept */
+    oatpp::String text =
+    "Host: localhost\r\n"
+    "content-length: 10\r\n"
+    "Accept: text/html\r\n"
+    "Cookie: a=1\r\n"
+    "Cookie: b=2\r\n"
+    "\r\n";
+    
+    oatpp::parser::ParsingCaret caret(text);
+    oatpp::web::protocol::http::Status status;
+    Headers headers;
+    oatpp::web::protocol::http::Protocol::parseHeaders(headers, text.getPtr(), caret, status);
+    
+    OATPP_ASSERT(status.code == 0);
+    OATPP_ASSERT(headers.size() == 5);
+    
+    auto it = headers.findById(Header::ID_CONTENT_LENGTH);
+    OATPP_ASSERT(it != headers.end() && it->second.equals("10"));
+    OATPP_ASSERT(headers.find(Header::CONTENT_LENGTH) == it);
+    OATPP_ASSERT(headers.findById(Header::ID_HOST)->second.equals("localhost"));
+    OATPP_ASSERT(headers.findById(Header::ID_TRANSFER_ENCODING) == headers.end());
+    OATPP_ASSERT(headers.find("ACCEPT")->second.equals("text/html"));
+    
+    Headers::const_iterator cookie = headers.find("Cookie");
+    OATPP_ASSERT(cookie->second.equals("a=1"));
+    cookie = headers.findNext(cookie);
+    OATPP_ASSERT(cookie != headers.end() && cookie->second.equals("b=2"));
+    OATPP_ASSERT(headers.findNext(cookie) == headers.end());
+    
+    /* erase - all values are removed, well-known headers are still found by id */
+    OATPP_ASSERT(headers.erase("cookie") == 2);
+    OATPP_ASSERT(headers.erase(Header::HOST) == 1);
+    OATPP_ASSERT(headers.erase("X-Missing") == 0);
+    OATPP_ASSERT(headers.size() == 2);
+    OATPP_ASSERT(headers.find("Cookie") == headers.end());
+    OATPP_ASSERT(headers.findById(Header::ID_HOST) == headers.end());
+    OATPP_ASSERT(headers.findById(Header::ID_CONTENT_LENGTH)->second.equals("10"));
+    OATPP_ASSERT(headers.find("Accept")->second.equals("text/html"));
+  }
+  
+  {
+    /* more headers than inline capacity, copy */
+    Headers headers;
+    for(v_int32 i = 0; i < Headers::INLINE_CAPACITY * 2; i ++) {
+      headers.add(oatpp::String("X-Header-") + oatpp::utils::conversion::int32ToStr(i), oatpp::utils::conversion::int32ToStr(i));
+    }
+    headers[Header::CONNECTION] = "close";
+    
+    Headers copy = headers;
+    OATPP_ASSERT(copy.size() == Headers::INLINE_CAPACITY * 2 + 1);
+    OATPP_ASSERT(copy.find("x-header-0")->second.equals("0"));
+    OATPP_ASSERT(copy.find("X-Header-31")->second.equals("31"));
+    OATPP_ASSERT(copy.findById(Header::ID_CONNECTION)->second.equals("close"));
+    
+    /* operator[] replaces value of existing header */
+    copy[Header::CONNECTION] = "keep-alive";
+    OATPP_ASSERT(copy.size() == Headers::INLINE_CAPACITY * 2 + 1);
+    OATPP_ASSERT(copy.findById(Header::ID_CONNECTION)->second.equals("keep-alive"));
+    OATPP_ASSERT(headers.findById(Header::ID_CONNECTION)->second.equals("close"));
+    
+    Headers small;
+    small.add("A", "1");
+    copy = small;
+    OATPP_ASSERT(copy.size() == 1);
+    OATPP_ASSERT(copy.findById(Header::ID_CONNECTION) == copy.end());
+  }
+  
+  {
+    /* ambiguous message length is rejected */
+    auto parse = [](const oatpp::String& text) {
+      oatpp::parser::ParsingCaret caret(text);
+      oatpp::web::protocol::http::Status status;
+      Headers headers;
+      oatpp::web::protocol::http::Protocol::parseHeaders(headers, text.getPtr(), caret, status);
+      return status.code;
+    };
+    
+    OATPP_ASSERT(parse("Content-Length: 10\r\nContent-Length: 10\r\n\r\n") == 0);
+    OATPP_ASSERT(parse("Content-Length: 10\r\nHost: localhost\r\ncontent-length: 4\r\n\r\n") == 400);
+    OATPP_ASSERT(parse("Content-Length: 10\r\nTransfer-Encoding: chunked\r\n\r\n") == 400);
+    OATPP_ASSERT(parse("Transfer-Encoding: chunked\r\nContent-Length: 10\r\n\r\n") == 400);
+    OATPP_ASSERT(parse("Transfer-Encoding: chunked\r\n\r\n") == 0);
+  }
+  
+  return true;
+}
+  
+}}}}}
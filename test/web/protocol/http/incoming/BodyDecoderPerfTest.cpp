@@ -0,0 +1,199 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+#include "BodyDecoderPerfTest.hpp"
+
+#include "oatpp/web/protocol/http/incoming/SimpleBodyDecoder.hpp"
+#include "oatpp/core/data/stream/StreamBufferedProxy.hpp"
+#include "oatpp/core/async/Executor.hpp"
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace web { namespace protocol { namespace http { namespace incoming {
+
+namespace {
+  
+typedef oatpp::web::protocol::http::incoming::SimpleBodyDecoder SimpleBodyDecoder;
+typedef oatpp::web::protocol::http::Protocol Protocol;
+typedef oatpp::os::io::Library::v_size v_size;
+  
+const v_int32 CHUNK_SIZE = 1024;
+  
+#ifdef OATPP_ENABLE_PERF_TESTS
+const v_int32 CHUNKS_COUNT = 100 * 1024; // 100 MB
+#else
+const v_int32 CHUNKS_COUNT = 4 * 1024; // 4 MB - checks decoding only. Build with OATPP_ENABLE_PERF_TESTS for meaningful numbers
+#endif
+  
+/**
+ * Generates chunked body of CHUNKS_COUNT chunks of CHUNK_SIZE.
+ * Returns as much data as asked - like socket with data always available.
+ */
+class ChunkedUploadStream : public oatpp::data::stream::InputStream {
+private:
+  std::string m_chunk;
+  std::string m_tail;
+  v_int32 m_chunksLeft;
+  v_size m_pos;
+public:
+  
+  ChunkedUploadStream()
+    : m_chunk("400\r\n" + std::string(CHUNK_SIZE, 'x') + "\r\n")
+    , m_tail("0\r\n\r\n")
+    , m_chunksLeft(CHUNKS_COUNT)
+    , m_pos(0)
+  {}
+  
+  v_size read(void *data, v_size count) override {
+    p_char8 buffer = (p_char8) data;
+    v_size progress = 0;
+    while(progress < count) {
+      const std::string& current = m_chunksLeft > 0 ? m_chunk : m_tail;
+      if(m_chunksLeft < 0 || (m_chunksLeft == 0 && m_pos == (v_size) m_tail.size())) {
+        break;
+      }
+      v_size size = current.size() - m_pos;
+      if(size > count - progress) {
+        size = count - progress;
+      }
+      std::memcpy(&buffer[progress], &current.data()[m_pos], size);
+      progress += size;
+      m_pos += size;
+      if(m_pos == (v_size) current.size() && m_chunksLeft > 0) {
+        m_chunksLeft --;
+        m_pos = 0;
+      }
+    }
+    return progress;
+  }
+  
+};
+  
+class CountingStream : public oatpp::data::stream::OutputStream {
+public:
+  v_int64 size = 0;
+public:
+  
+  v_size write(const void* /* data */, v_size count) override {
+    size += count;
+    return count;
+  }
+  
+};
+  
+std::shared_ptr<oatpp::data::stream::InputStream> createUploadStream(bool buffered, p_char8 buffer) {
+  auto stream = std::make_shared<ChunkedUploadStream>();
+  if(buffered) {
+    return oatpp::data::stream::InputStreamBufferedProxy::createShared(stream, buffer, oatpp::data::buffer::IOBuffer::BUFFER_SIZE);
+  }
+  return stream;
+}
+  
+class DecodeCoroutine : public oatpp::async::Coroutine<DecodeCoroutine> {
+private:
+  const SimpleBodyDecoder* m_decoder;
+  const Protocol::Headers* m_headers;
+  std::shared_ptr<oatpp::data::stream::InputStream> m_stream;
+  std::shared_ptr<CountingStream> m_toStream;
+  std::atomic<bool>* m_done;
+public:
+  
+  DecodeCoroutine(const SimpleBodyDecoder* decoder,
+                  const Protocol::Headers* headers,
+                  const std::shared_ptr<oatpp::data::stream::InputStream>& stream,
+                  const std::shared_ptr<CountingStream>& toStream,
+                  std::atomic<bool>* done)
+    : m_decoder(decoder)
+    , m_headers(headers)
+    , m_stream(stream)
+    , m_toStream(toStream)
+    , m_done(done)
+  {}
+  
+  Action act() override {
+    return m_decoder->decodeAsync(this, yieldTo(&DecodeCoroutine::onDecoded), *m_headers, m_stream, m_toStream);
+  }
+  
+  Action onDecoded() {
+    *m_done = true;
+    return finish();
+  }
+  
+};
+  
+void runDecode(const Protocol::Headers& headers, bool buffered, bool async, const char* TAG) {
+  
+  SimpleBodyDecoder decoder;
+  v_char8 buffer[oatpp::data::buffer::IOBuffer::BUFFER_SIZE];
+  auto stream = createUploadStream(buffered, buffer);
+  auto toStream = std::make_shared<CountingStream>();
+  
+  v_int64 ticks;
+  
+  if(async) {
+    std::atomic<bool> done(false);
+    oatpp::async::Executor executor(1);
+    ticks = oatpp::base::Environment::getMicroTickCount();
+    executor.execute<DecodeCoroutine>(&decoder, &headers, stream, toStream, &done);
+    while(!done) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    ticks = oatpp::base::Environment::getMicroTickCount() - ticks;
+    executor.stop();
+    executor.join();
+  } else {
+    ticks = oatpp::base::Environment::getMicroTickCount();
+    decoder.decode(headers, stream, toStream);
+    ticks = oatpp::base::Environment::getMicroTickCount() - ticks;
+  }
+  
+  OATPP_ASSERT(toStream->size == (v_int64) CHUNK_SIZE * CHUNKS_COUNT);
+  
+  OATPP_LOGD(TAG, "%s, %s: %d MB in %d(micro) - %d MB/s",
+             async ? "async" : "sync",
+             buffered ? "buffered framing" : "byte-by-byte framing",
+             (v_int32) (toStream->size >> 20), (v_int32) ticks,
+             (v_int32) ((toStream->size >> 20) * 1000000 / (ticks > 0 ? ticks : 1)));
+  
+}
+  
+}
+  
+bool BodyDecoderPerfTest::onRun() {
+  
+  oatpp::String headersText = "Transfer-Encoding: chunked\r\n\r\n";
+  oatpp::parser::ParsingCaret caret(headersText);
+  oatpp::web::protocol::http::Status status;
+  Protocol::Headers headers;
+  Protocol::parseHeaders(headers, headersText.getPtr(), caret, status);
+  OATPP_ASSERT(status.code == 0);
+  
+  runDecode(headers, true, false, TAG);
+  runDecode(headers, false, false, TAG);
+  runDecode(headers, true, true, TAG);
+  runDecode(headers, false, true, TAG);
+  
+  return true;
+}
+  
+}}}}}}
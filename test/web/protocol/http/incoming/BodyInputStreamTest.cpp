@@ -0,0 +1,247 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+#include "BodyInputStreamTest.hpp"
+
+#include "oatpp/web/protocol/http/incoming/SimpleBodyDecoder.hpp"
+#include "oatpp/web/protocol/http/incoming/BodyInputStream.hpp"
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+#include "oatpp/core/data/stream/StreamBufferedProxy.hpp"
+
+namespace oatpp { namespace test { namespace web { namespace protocol { namespace http { namespace incoming {
+
+namespace {
+  
+typedef oatpp::web::protocol::http::incoming::BodyInputStream BodyInputStream;
+typedef oatpp::web::protocol::http::incoming::SimpleBodyDecoder SimpleBodyDecoder;
+typedef oatpp::web::protocol::http::Protocol Protocol;
+typedef oatpp::web::protocol::http::HttpError HttpError;
+  
+/**
+ * Stream returning data in portions of fixed size.
+ * Returns ERROR_IO_RETRY before each portion if @retry is set.
+ */
+class PortionsStream : public oatpp::data::stream::InputStream {
+private:
+  const char* m_data;
+  v_int32 m_size;
+  v_int32 m_pos;
+  v_int32 m_portion;
+  bool m_retry;
+  bool m_retried;
+public:
+  
+  PortionsStream(const char* data, v_int32 portion, bool retry = false)
+    : m_data(data)
+    , m_size((v_int32) std::strlen(data))
+    , m_pos(0)
+    , m_portion(portion)
+    , m_retry(retry)
+    , m_retried(false)
+  {}
+  
+  oatpp::os::io::Library::v_size read(void *data, oatpp::os::io::Library::v_size count) override {
+    if(m_retry && !m_retried) {
+      m_retried = true;
+      return oatpp::data::stream::Errors::ERROR_IO_RETRY;
+    }
+    m_retried = false;
+    if(m_pos >= m_size) {
+      return 0;
+    }
+    v_int32 size = m_size - m_pos;
+    if(size > count) size = (v_int32) count;
+    if(size > m_portion) size = m_portion;
+    std::memcpy(data, &m_data[m_pos], size);
+    m_pos += size;
+    return size;
+  }
+  
+  const char* getRest() const {
+    return &m_data[m_pos];
+  }
+  
+};
+  
+Protocol::Headers parseHeaders(const oatpp::String& text) {
+  oatpp::parser::ParsingCaret caret(text);
+  oatpp::web::protocol::http::Status status;
+  Protocol::Headers headers;
+  Protocol::parseHeaders(headers, text.getPtr(), caret, status);
+  OATPP_ASSERT(status.code == 0);
+  return headers;
+}
+  
+oatpp::String readAll(const std::shared_ptr<oatpp::data::stream::InputStream>& stream) {
+  oatpp::data::stream::ChunkedBuffer buffer;
+  v_char8 data[5];
+  while(true) {
+    auto res = stream->read(data, 5);
+    if(res > 0) {
+      buffer.write(data, res);
+    } else if(res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
+      continue;
+    } else {
+      OATPP_ASSERT(res == 0);
+      break;
+    }
+  }
+  return buffer.toString();
+}
+  
+v_int32 getErrorCode(const oatpp::String& headersText, const char* body, v_int64 maxBodySize) {
+  auto headers = parseHeaders(headersText);
+  try {
+    auto stream = BodyInputStream::createShared(headers, std::make_shared<PortionsStream>(body, 3), maxBodySize);
+    readAll(stream);
+  } catch (HttpError& error) {
+    return error.getInfo().status.code;
+  }
+  return 0;
+}
+  
+const char* CHUNKED_BODY =
+  "4\r\nWiki\r\n"
+  "5;name=value\r\npedia\r\n"
+  "E\r\n in\r\n\r\nchunks.\r\n"
+  "0\r\n"
+  "Trailer: value\r\n"
+  "\r\n"
+  "GET /next HTTP/1.1\r\n";
+  
+const char* CHUNKED_DECODED = "Wikipedia in\r\n\r\nchunks.";
+  
+}
+  
+bool BodyInputStreamTest::onRun() {
+  
+  oatpp::String contentLengthHeaders = "Content-Length: 9\r\n\r\n";
+  oatpp::String chunkedHeaders = "Transfer-Encoding: chunked\r\n\r\n";
+  
+  {
+    /* Content-Length - body is read up to its length only */
+    auto fromStream = std::make_shared<PortionsStream>("Wikipedia and the rest", 4, true);
+    auto stream = BodyInputStream::createShared(parseHeaders(contentLengthHeaders), fromStream);
+    OATPP_ASSERT(stream->getMode() == BodyInputStream::MODE_CONTENT_LENGTH);
+    OATPP_ASSERT(readAll(stream)->equals("Wikipedia"));
+    OATPP_ASSERT(stream->isDone());
+    OATPP_ASSERT(stream->getProgress() == 9);
+    OATPP_ASSERT(std::strcmp(fromStream->getRest(), " and the rest") == 0);
+  }
+  
+  {
+    /* No framing headers - body is empty */
+    auto stream = BodyInputStream::createShared(parseHeaders("Host: localhost\r\n\r\n"), std::make_shared<PortionsStream>("data", 4));
+    OATPP_ASSERT(stream->isDone());
+    OATPP_ASSERT(readAll(stream)->getSize() == 0);
+  }
+  
+  {
+    /* Chunked - extensions and trailers are skipped, next request is not consumed */
+    v_int32 portions[] = {1, 2, 7, 1024};
+    for(v_int32 portion : portions) {
+      auto fromStream = std::make_shared<PortionsStream>(CHUNKED_BODY, portion, true);
+      auto stream = BodyInputStream::createShared(parseHeaders(chunkedHeaders), fromStream);
+      OATPP_ASSERT(stream->getMode() == BodyInputStream::MODE_CHUNKED);
+      OATPP_ASSERT(readAll(stream)->equals(CHUNKED_DECODED));
+      OATPP_ASSERT(stream->isDone());
+      OATPP_ASSERT(std::strcmp(fromStream->getRest(), "GET /next HTTP/1.1\r\n") == 0);
+    }
+  }
+  
+  {
+    /* Chunked over InputStreamBufferedProxy - framing is parsed from the proxy buffer, next request stays there */
+    v_int32 bufferSizes[] = {1, 5, 16, 4096};
+    for(v_int32 bufferSize : bufferSizes) {
+      v_char8 buffer[4096];
+      auto fromStream = oatpp::data::stream::InputStreamBufferedProxy::createShared(std::make_shared<PortionsStream>(CHUNKED_BODY, 7, true),
+                                                                                 buffer, bufferSize);
+      auto stream = BodyInputStream::createShared(parseHeaders(chunkedHeaders), fromStream);
+      OATPP_ASSERT(readAll(stream)->equals(CHUNKED_DECODED));
+      OATPP_ASSERT(stream->isDone());
+      v_char8 rest[64];
+      auto size = oatpp::data::stream::readExactSizeData(fromStream.get(), rest, 20);
+      OATPP_ASSERT(size == 20 && std::memcmp(rest, "GET /next HTTP/1.1\r\n", 20) == 0);
+    }
+  }
+  
+  {
+    /* Several chunks are returned by one read() when they are in the proxy buffer */
+    v_char8 buffer[4096];
+    auto fromStream = oatpp::data::stream::InputStreamBufferedProxy::createShared(std::make_shared<PortionsStream>(CHUNKED_BODY, 1024),
+                                                                               buffer, 4096);
+    auto stream = BodyInputStream::createShared(parseHeaders(chunkedHeaders), fromStream);
+    v_char8 data[64];
+    OATPP_ASSERT(stream->read(data, 64) == 23);
+    OATPP_ASSERT(std::memcmp(data, CHUNKED_DECODED, 23) == 0);
+    OATPP_ASSERT(stream->read(data, 64) == 0);
+  }
+  
+  {
+    /* Truncated body */
+    auto stream = BodyInputStream::createShared(parseHeaders(chunkedHeaders), std::make_shared<PortionsStream>("4\r\nWi", 16));
+    v_char8 data[16];
+    OATPP_ASSERT(stream->read(data, 16) == 2);
+    OATPP_ASSERT(stream->read(data, 16) == oatpp::data::stream::Errors::ERROR_IO_PIPE);
+  }
+  
+  {
+    /* Max body size */
+    OATPP_ASSERT(getErrorCode(contentLengthHeaders, "Wikipedia", 9) == 0);
+    OATPP_ASSERT(getErrorCode(contentLengthHeaders, "Wikipedia", 8) == 413);
+    OATPP_ASSERT(getErrorCode(chunkedHeaders, CHUNKED_BODY, 23) == 0);
+    OATPP_ASSERT(getErrorCode(chunkedHeaders, CHUNKED_BODY, 22) == 413);
+    OATPP_ASSERT(getErrorCode(chunkedHeaders, "FFFFFFFF\r\n", 1024 * 1024) == 413);
+  }
+  
+  {
+    /* Malformed framing */
+    OATPP_ASSERT(getErrorCode("Content-Length: -1\r\n\r\n", "", -1) == 400);
+    OATPP_ASSERT(getErrorCode("Content-Length: abc\r\n\r\n", "", -1) == 400);
+    OATPP_ASSERT(getErrorCode(chunkedHeaders, "x\r\n", -1) == 400);
+    OATPP_ASSERT(getErrorCode(chunkedHeaders, "\r\n", -1) == 400);
+    OATPP_ASSERT(getErrorCode(chunkedHeaders, "4\r\nWikiXX", -1) == 400);
+    OATPP_ASSERT(getErrorCode(chunkedHeaders, "FFFFFFFFFFFFFFFF\r\n", -1) == 400);
+  }
+  
+  {
+    /* SimpleBodyDecoder */
+    SimpleBodyDecoder decoder;
+    auto body = decoder.decodeToString(parseHeaders(contentLengthHeaders), std::make_shared<PortionsStream>("Wikipedia", 2));
+    OATPP_ASSERT(body->equals("Wikipedia"));
+    body = decoder.decodeToString(parseHeaders(chunkedHeaders), std::make_shared<PortionsStream>(CHUNKED_BODY, 3));
+    OATPP_ASSERT(body->equals(CHUNKED_DECODED));
+    
+    SimpleBodyDecoder limitedDecoder(8);
+    try {
+      limitedDecoder.decodeToString(parseHeaders(contentLengthHeaders), std::make_shared<PortionsStream>("Wikipedia", 2));
+      OATPP_ASSERT(false);
+    } catch (HttpError& error) {
+      OATPP_ASSERT(error.getInfo().status.code == 413);
+    }
+  }
+  
+  return true;
+}
+  
+}}}}}}
@@ -0,0 +1,45 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+#ifndef test_web_protocol_http_incoming_BodyInputStreamTest_hpp
+#define test_web_protocol_http_incoming_BodyInputStreamTest_hpp
+
+#include "oatpp/test/UnitTest.hpp"
+
+namespace oatpp { namespace test { namespace web { namespace protocol { namespace http { namespace incoming {
+  
+/**
+ * Check Content-Length and chunked decoding by BodyInputStream, max body size guard,
+ * and decoding body to string with SimpleBodyDecoder
+ */
+class BodyInputStreamTest : public UnitTest{
+public:
+  
+  BodyInputStreamTest():UnitTest("TEST[web::protocol::http::incoming::BodyInputStreamTest]"){}
+  bool onRun() override;
+  
+};
+  
+}}}}}}
+
+#endif /* test_web_protocol_http_incoming_BodyInputStreamTest_hpp */
@@ -0,0 +1,167 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "RequestHeadersReaderTest.hpp"
+
+#include "oatpp/web/protocol/http/incoming/RequestHeadersReader.hpp"
+#include "oatpp/web/server/HttpProcessor.hpp"
+
+namespace oatpp { namespace test { namespace web { namespace protocol { namespace http { namespace incoming {
+
+namespace {
+  
+typedef oatpp::web::protocol::http::incoming::RequestHeadersReader RequestHeadersReader;
+  
+/**
+ * Stream returning data in portions of fixed size
+ */
+class PortionsStream : public oatpp::data::stream::IOStream {
+private:
+  const char* m_data;
+  v_int32 m_size;
+  v_int32 m_pos;
+  v_int32 m_portion;
+public:
+  
+  PortionsStream(const char* data, v_int32 portion)
+    : m_data(data)
+    , m_size((v_int32) std::strlen(data))
+    , m_pos(0)
+    , m_portion(portion)
+  {}
+  
+  v_size read(void *data, v_size count) override {
+    if(m_pos >= m_size) {
+      return oatpp::data::stream::Errors::ERROR_IO_PIPE;
+    }
+    v_int32 size = m_size - m_pos;
+    if(size > count) size = (v_int32) count;
+    if(size > m_portion) size = m_portion;
+    std::memcpy(data, &m_data[m_pos], size);
+    m_pos += size;
+    return size;
+  }
+  
+  v_size write(const void* /* data */, v_size count) override {
+    return count;
+  }
+  
+};
+  
+bool isInBuffer(const oatpp::data::share::MemoryLabel& label, const std::shared_ptr<oatpp::base::StrBuffer>& buffer) {
+  return label.getData() >= buffer->getData() && label.getData() + label.getSize() <= buffer->getData() + buffer->getSize();
+}
+  
+const char* REQUEST =
+  "GET /users/42?x=1 HTTP/1.1\r\n"
+  "Host: localhost\r\n"
+  "User-Agent: test\r\n"
+  "Content-Length: 4\r\n"
+  "\r\n"
+  "body";
+  
+void checkResult(const RequestHeadersReader::Result& result) {
+  OATPP_ASSERT(result.startingLine.method.equals("GET"));
+  OATPP_ASSERT(result.startingLine.path.equals("/users/42?x=1"));
+  OATPP_ASSERT(result.startingLine.protocol.equals("HTTP/1.1"));
+  OATPP_ASSERT(result.headers.size() == 3);
+  OATPP_ASSERT(result.headers.find("Host")->second.equals("localhost"));
+  OATPP_ASSERT(result.headers.find("user-agent")->second.equals("test"));
+}
+  
+}
+  
+bool RequestHeadersReaderTest::onRun() {
+  
+  {
+    /* headers fit the buffer - parsed in place */
+    auto buffer = oatpp::base::StrBuffer::createShared(256);
+    auto connection = std::make_shared<PortionsStream>(REQUEST, 10);
+    RequestHeadersReader reader(buffer, 4096);
+    oatpp::web::protocol::http::HttpError::Info error;
+    auto result = reader.readHeaders(connection, error);
+    OATPP_ASSERT(error.ioStatus > 0);
+    checkResult(result);
+    
+    OATPP_ASSERT(isInBuffer(result.startingLine.path, buffer));
+    OATPP_ASSERT(result.startingLine.path.getMemoryHandle() == buffer);
+    OATPP_ASSERT(isInBuffer(result.headers.find("Host")->second, buffer));
+    
+    /* already read part of the body stays in the buffer */
+    OATPP_ASSERT(result.bufferPosEnd > result.bufferPosStart);
+    OATPP_ASSERT(std::memcmp(&buffer->getData()[result.bufferPosStart], "body", result.bufferPosEnd - result.bufferPosStart) == 0);
+  }
+  
+  {
+    /* headers don't fit the buffer - copied */
+    auto buffer = oatpp::base::StrBuffer::createShared(16);
+    auto connection = std::make_shared<PortionsStream>(REQUEST, 5);
+    RequestHeadersReader reader(buffer, 4096);
+    oatpp::web::protocol::http::HttpError::Info error;
+    auto result = reader.readHeaders(connection, error);
+    OATPP_ASSERT(error.ioStatus > 0);
+    checkResult(result);
+    OATPP_ASSERT(!isInBuffer(result.startingLine.path, buffer));
+  }
+  
+  {
+    /* headers section is larger than allowed */
+    auto buffer = oatpp::base::StrBuffer::createShared(16);
+    auto connection = std::make_shared<PortionsStream>(REQUEST, 5);
+    RequestHeadersReader reader(buffer, 32);
+    oatpp::web::protocol::http::HttpError::Info error;
+    reader.readHeaders(connection, error);
+    OATPP_ASSERT(error.ioStatus < 0);
+  }
+  
+  {
+    /* labels of the previous request are still alive - next request is read into a fresh buffer */
+    auto buffer = oatpp::web::server::HttpProcessor::createHeadersBuffer();
+    oatpp::data::share::StringKeyLabel host;
+    {
+      auto connection = std::make_shared<PortionsStream>(REQUEST, 10);
+      RequestHeadersReader reader(buffer, 4096);
+      oatpp::web::protocol::http::HttpError::Info error;
+      host = reader.readHeaders(connection, error).headers.find("Host")->second;
+      OATPP_ASSERT(isInBuffer(host, buffer));
+    }
+    
+    auto prevBuffer = buffer.get();
+    oatpp::web::server::HttpProcessor::prepareHeadersBuffer(buffer);
+    OATPP_ASSERT(buffer.get() != prevBuffer);
+    
+    std::memset(buffer->getData(), 'x', buffer->getSize());
+    OATPP_ASSERT(host.equals("localhost"));
+    
+    /* nobody else holds the buffer - it is reused */
+    host = oatpp::data::share::StringKeyLabel();
+    prevBuffer = buffer.get();
+    oatpp::web::server::HttpProcessor::prepareHeadersBuffer(buffer);
+    OATPP_ASSERT(buffer.get() == prevBuffer);
+  }
+  
+  return true;
+}
+  
+}}}}}}
@@ -0,0 +1,298 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "CompressedBodyTest.hpp"
+
+#include "oatpp/web/protocol/http/outgoing/CompressedBody.hpp"
+#include "oatpp/web/protocol/http/outgoing/BufferBody.hpp"
+#include "oatpp/web/protocol/http/outgoing/Response.hpp"
+#include "oatpp/web/protocol/http/incoming/SimpleBodyDecoder.hpp"
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+#include "oatpp/core/async/Executor.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace oatpp { namespace test { namespace web { namespace protocol { namespace http { namespace outgoing {
+  
+namespace {
+  
+typedef oatpp::web::protocol::http::Protocol Protocol;
+typedef oatpp::web::protocol::http::Status Status;
+typedef oatpp::web::protocol::http::HttpError HttpError;
+typedef oatpp::web::protocol::http::outgoing::Response Response;
+typedef oatpp::web::protocol::http::outgoing::BufferBody BufferBody;
+typedef oatpp::web::protocol::http::outgoing::CompressedBody CompressedBody;
+typedef oatpp::web::protocol::http::incoming::SimpleBodyDecoder SimpleBodyDecoder;
+typedef oatpp::encoding::Zlib Zlib;
+  
+class StringInputStream : public oatpp::data::stream::InputStream {
+private:
+  std::string m_data;
+  v_int64 m_pos;
+public:
+  
+  StringInputStream(const std::string& data)
+    : m_data(data)
+    , m_pos(0)
+  {}
+  
+  oatpp::os::io::Library::v_size read(void *data, oatpp::os::io::Library::v_size count) override {
+    v_int64 size = m_data.size() - m_pos;
+    if(size > count) size = count;
+    std::memcpy(data, &m_data[m_pos], size);
+    m_pos += size;
+    return size;
+  }
+  
+};
+  
+/**
+ * Non-blocking stream imitation - asks to wait on every other write and accepts small portions only.
+ */
+class ThrottledOutputStream : public oatpp::data::stream::OutputStream {
+private:
+  std::shared_ptr<oatpp::data::stream::OutputStream> m_stream;
+  bool m_wait;
+public:
+  
+  ThrottledOutputStream(const std::shared_ptr<oatpp::data::stream::OutputStream>& stream)
+    : m_stream(stream)
+    , m_wait(false)
+  {}
+  
+  oatpp::os::io::Library::v_size write(const void *data, oatpp::os::io::Library::v_size count) override {
+    m_wait = !m_wait;
+    if(m_wait) {
+      return oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY;
+    }
+    if(count > 100) {
+      count = 100;
+    }
+    return m_stream->write(data, count);
+  }
+  
+};
+  
+class SendCoroutine : public oatpp::async::Coroutine<SendCoroutine> {
+private:
+  std::shared_ptr<Response> m_response;
+  std::shared_ptr<oatpp::data::stream::OutputStream> m_stream;
+  std::atomic<bool>* m_done;
+public:
+  
+  SendCoroutine(const std::shared_ptr<Response>& response,
+                const std::shared_ptr<oatpp::data::stream::OutputStream>& stream,
+                std::atomic<bool>* done)
+    : m_response(response)
+    , m_stream(stream)
+    , m_done(done)
+  {}
+  
+  Action act() override {
+    return m_response->sendAsync(this, yieldTo(&SendCoroutine::onSent), m_stream);
+  }
+  
+  Action onSent() {
+    *m_done = true;
+    return finish();
+  }
+  
+};
+  
+std::string send(const std::shared_ptr<Response>& response, oatpp::async::Executor* executor, bool throttled = false) {
+  auto stream = oatpp::data::stream::ChunkedBuffer::createShared();
+  if(executor) {
+    std::atomic<bool> done(false);
+    std::shared_ptr<oatpp::data::stream::OutputStream> sendStream = stream;
+    if(throttled) {
+      sendStream = std::make_shared<ThrottledOutputStream>(stream);
+    }
+    executor->execute<SendCoroutine>(response, sendStream, &done);
+    while(!done) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  } else {
+    response->send(stream);
+  }
+  auto text = stream->toString();
+  return std::string((const char*) text->getData(), text->getSize());
+}
+  
+Protocol::Headers parseHeaders(const oatpp::String& text) {
+  oatpp::parser::ParsingCaret caret(text);
+  Status status;
+  Protocol::Headers headers;
+  Protocol::parseHeaders(headers, text.getPtr(), caret, status);
+  OATPP_ASSERT(status.code == 0);
+  return headers;
+}
+  
+/**
+ * Decode body of the response received the same way ApiClient does.
+ */
+std::string decodeBody(const std::string& response, v_int64 maxInflatedSize = SimpleBodyDecoder::DEFAULT_CLIENT_MAX_INFLATED_SIZE) {
+  auto headersStart = response.find("\r\n") + 2;
+  auto bodyStart = response.find("\r\n\r\n") + 4;
+  oatpp::String headersText(response.substr(headersStart, bodyStart - headersStart).c_str());
+  SimpleBodyDecoder decoder(-1, maxInflatedSize);
+  auto body = decoder.decodeToString(parseHeaders(headersText), std::make_shared<StringInputStream>(response.substr(bodyStart)));
+  return std::string((const char*) body->getData(), body->getSize());
+}
+  
+v_int32 chooseFormat(const char* acceptEncoding) {
+  Protocol::Headers headers;
+  headers.add("Accept-Encoding", acceptEncoding);
+  return CompressedBody::chooseFormat(headers);
+}
+  
+std::shared_ptr<Response> createResponse(const oatpp::String& text, const char* acceptEncoding, v_int32 minSize) {
+  Protocol::Headers requestHeaders;
+  requestHeaders.add("Accept-Encoding", acceptEncoding);
+  return Response::createShared(Status::CODE_200,
+                                CompressedBody::createIfAccepted(BufferBody::createShared(text),
+                                                                 requestHeaders,
+                                                                 Zlib::LEVEL_FASTEST,
+                                                                 minSize));
+}
+  
+}
+  
+bool CompressedBodyTest::onRun() {
+  
+  { /* Accept-Encoding negotiation */
+    OATPP_ASSERT(CompressedBody::chooseFormat(Protocol::Headers()) == -1);
+    OATPP_ASSERT(chooseFormat("gzip") == Zlib::FORMAT_GZIP);
+    OATPP_ASSERT(chooseFormat("deflate, gzip") == Zlib::FORMAT_GZIP);
+    OATPP_ASSERT(chooseFormat("gzip;q=0.5, deflate") == Zlib::FORMAT_DEFLATE);
+    OATPP_ASSERT(chooseFormat("GZIP ; q=0.5, Deflate;q=0.4") == Zlib::FORMAT_GZIP);
+    OATPP_ASSERT(chooseFormat("gzip;q=0, deflate;q=0.000") == -1);
+    OATPP_ASSERT(chooseFormat("br, identity") == -1);
+    OATPP_ASSERT(chooseFormat("*") == Zlib::FORMAT_GZIP);
+    OATPP_ASSERT(chooseFormat("gzip;q=0, *;q=0.1") == Zlib::FORMAT_DEFLATE);
+    OATPP_ASSERT(chooseFormat("br,gzip") == Zlib::FORMAT_GZIP);
+  }
+  
+  oatpp::data::stream::ChunkedBuffer textBuffer;
+  for(v_int32 i = 0; i < 50000; i ++) {
+    textBuffer.write("{\"id\": ", 7);
+    textBuffer.writeAsString(i);
+    textBuffer.write(", \"name\": \"oat++ web framework\"},", 33);
+  }
+  oatpp::String text = textBuffer.toString();
+  std::string textString((const char*) text->getData(), text->getSize());
+  
+  oatpp::async::Executor executor(1);
+  
+  for(v_int32 async = 0; async < 2; async ++) {
+    
+    oatpp::async::Executor* currExecutor = async ? &executor : nullptr;
+    
+    { /* compressed */
+      auto received = send(createResponse(text, "gzip, deflate", 1024), currExecutor);
+      OATPP_LOGD(TAG, "async=%d: %d -> %d bytes", async, text->getSize(), (v_int32) received.size());
+      OATPP_ASSERT(received.size() < (size_t) text->getSize() / 5);
+      OATPP_ASSERT(received.find("\r\nContent-Encoding: gzip\r\n") != std::string::npos);
+      OATPP_ASSERT(received.find("\r\nTransfer-Encoding: chunked\r\n") != std::string::npos);
+      OATPP_ASSERT(received.find("\r\nVary: Accept-Encoding\r\n") != std::string::npos);
+      OATPP_ASSERT(received.find("Content-Length") == std::string::npos);
+      OATPP_ASSERT(decodeBody(received) == textString);
+    }
+    
+    { /* deflate */
+      auto received = send(createResponse(text, "deflate", 1024), currExecutor);
+      OATPP_ASSERT(received.find("\r\nContent-Encoding: deflate\r\n") != std::string::npos);
+      OATPP_ASSERT(decodeBody(received) == textString);
+    }
+    
+    { /* smaller than minSize */
+      auto received = send(createResponse("small body", "gzip", 1024), currExecutor);
+      OATPP_ASSERT(received.find("Content-Encoding") == std::string::npos);
+      OATPP_ASSERT(received.find("\r\nContent-Length: 10\r\n") != std::string::npos);
+      OATPP_ASSERT(decodeBody(received) == "small body");
+    }
+    
+    { /* not accepted */
+      auto received = send(createResponse(text, "br", 0), currExecutor);
+      OATPP_ASSERT(received.find("Content-Encoding") == std::string::npos);
+      OATPP_ASSERT(decodeBody(received) == textString);
+    }
+    
+  }
+  
+  { /* async - compressed on the go to the stream which is not always ready */
+    auto received = send(createResponse(text, "gzip", 0), &executor, true);
+    OATPP_ASSERT(received.find("\r\nContent-Encoding: gzip\r\n") != std::string::npos);
+    OATPP_ASSERT(decodeBody(received) == textString);
+  }
+  
+  executor.stop();
+  executor.join();
+  
+  { /* body already encoded */
+    auto response = createResponse(text, "gzip", 0);
+    response->putHeader("Content-Encoding", "br");
+    auto received = send(response, nullptr);
+    OATPP_ASSERT(received.find("\r\nContent-Length: ") != std::string::npos);
+    OATPP_ASSERT(received.find("Transfer-Encoding") == std::string::npos);
+  }
+  
+  { /* decompression is off by default - body is returned as received */
+    auto received = send(createResponse(text, "gzip", 0), nullptr);
+    auto body = decodeBody(received, SimpleBodyDecoder::INFLATE_DISABLED);
+    OATPP_ASSERT(body.size() < (size_t) text->getSize() / 5);
+    OATPP_ASSERT((v_char8) body[0] == 0x1F && (v_char8) body[1] == 0x8B);
+  }
+  
+  { /* maxInflatedSize limits decompressed size */
+    auto received = send(createResponse(text, "gzip", 0), nullptr);
+    OATPP_ASSERT(received.size() < (size_t) text->getSize() / 5);
+    v_int32 code = 0;
+    try {
+      decodeBody(received, text->getSize() - 1);
+    } catch (HttpError& error) {
+      code = error.getInfo().status.code;
+    }
+    OATPP_ASSERT(code == 413);
+    OATPP_ASSERT(decodeBody(received, text->getSize()) == textString);
+  }
+  
+  { /* corrupted compressed body */
+    auto received = send(createResponse(text, "gzip", 0), nullptr);
+    auto bodyStart = received.find("\r\n\r\n") + 4;
+    auto chunkStart = received.find("\r\n", bodyStart) + 2;
+    received[chunkStart + 20] ^= 0xFF;
+    v_int32 code = 0;
+    try {
+      decodeBody(received);
+    } catch (HttpError& error) {
+      code = error.getInfo().status.code;
+    }
+    OATPP_ASSERT(code == 400);
+  }
+  
+  return true;
+}
+  
+}}}}}}
@@ -0,0 +1,196 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "FileBodyTest.hpp"
+
+#include "oatpp/web/protocol/http/outgoing/ResponseFactory.hpp"
+#include "oatpp/network/Connection.hpp"
+#include "oatpp/core/async/Executor.hpp"
+
+#include <atomic>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+namespace oatpp { namespace test { namespace web { namespace protocol { namespace http { namespace outgoing {
+  
+namespace {
+  
+typedef oatpp::web::protocol::http::Range Range;
+typedef oatpp::web::protocol::http::outgoing::Response Response;
+typedef oatpp::web::protocol::http::outgoing::ResponseFactory ResponseFactory;
+  
+class SendCoroutine : public oatpp::async::Coroutine<SendCoroutine> {
+private:
+  std::shared_ptr<Response> m_response;
+  std::shared_ptr<oatpp::network::Connection> m_connection;
+  std::atomic<bool>* m_done;
+public:
+  
+  SendCoroutine(const std::shared_ptr<Response>& response,
+                const std::shared_ptr<oatpp::network::Connection>& connection,
+                std::atomic<bool>* done)
+    : m_response(response)
+    , m_connection(connection)
+    , m_done(done)
+  {}
+  
+  Action act() override {
+    return m_response->sendAsync(this, yieldTo(&SendCoroutine::onSent), m_connection);
+  }
+  
+  Action onSent() {
+    m_connection.reset();
+    *m_done = true;
+    return finish();
+  }
+  
+};
+  
+/**
+ * Send response over socket pair, return everything received.
+ */
+std::string sendOverSocket(const std::shared_ptr<Response>& response, oatpp::async::Executor* executor) {
+  
+  int fds[2];
+  OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  
+  std::string received;
+  std::thread reader([&received, &fds]{
+    char buffer[4096];
+    ssize_t res;
+    while((res = ::read(fds[1], buffer, 4096)) > 0) {
+      received.append(buffer, res);
+    }
+    ::close(fds[1]);
+  });
+  
+  auto connection = oatpp::network::Connection::createShared(fds[0]);
+  if(executor) {
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    std::atomic<bool> done(false);
+    executor->execute<SendCoroutine>(response, connection, &done);
+    connection.reset();
+    while(!done) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  } else {
+    response->send(connection);
+    connection.reset();
+  }
+  
+  reader.join();
+  return received;
+  
+}
+  
+std::string getBody(const std::string& response) {
+  auto pos = response.find("\r\n\r\n");
+  OATPP_ASSERT(pos != std::string::npos);
+  return response.substr(pos + 4);
+}
+  
+}
+  
+bool FileBodyTest::onRun() {
+  
+  {
+    /* Range parsing */
+    auto range = Range::parse("bytes=100-199");
+    OATPP_ASSERT(range.isValid() && range.start == 100 && range.end == 199);
+    range = Range::parse("bytes=100-");
+    OATPP_ASSERT(range.isValid() && range.start == 100 && range.end == -1);
+    OATPP_ASSERT(range.toString() == "bytes=100-");
+    range = Range::parse("bytes=-50");
+    OATPP_ASSERT(range.isValid() && range.start == -1 && range.end == 50);
+    OATPP_ASSERT(range.toString() == "bytes=-50");
+    OATPP_ASSERT(!Range::parse("bytes=-").isValid());
+  }
+  
+  char filename[] = "/tmp/oatpp-FileBodyTest-XXXXXX";
+  int fd = mkstemp(filename);
+  OATPP_ASSERT(fd >= 0);
+  
+  std::string content;
+  for(v_int32 i = 0; i < 3 * 1024 * 1024; i ++) {
+    content.push_back((char) ('a' + (i * 7 + i / 1024) % 26));
+  }
+  OATPP_ASSERT(::write(fd, content.data(), content.size()) == (ssize_t) content.size());
+  ::close(fd);
+  
+  oatpp::async::Executor executor(1);
+  
+  for(v_int32 async = 0; async < 2; async ++) {
+    
+    oatpp::async::Executor* currExecutor = async ? &executor : nullptr;
+    
+    { /* whole file */
+      auto received = sendOverSocket(ResponseFactory::createFileResponse(filename, nullptr), currExecutor);
+      OATPP_ASSERT(received.compare(0, 17, "HTTP/1.1 200 OK\r\n") == 0);
+      OATPP_ASSERT(received.find("\r\nAccept-Ranges: bytes\r\n") != std::string::npos);
+      OATPP_ASSERT(getBody(received) == content);
+    }
+    
+    { /* range */
+      auto received = sendOverSocket(ResponseFactory::createFileResponse(filename, "bytes=1000000-2999999"), currExecutor);
+      OATPP_ASSERT(received.compare(0, 22, "HTTP/1.1 206 Partial C") == 0);
+      OATPP_ASSERT(received.find("\r\nContent-Range: bytes 1000000-2999999/3145728\r\n") != std::string::npos);
+      OATPP_ASSERT(received.find("\r\nContent-Length: 2000000\r\n") != std::string::npos);
+      OATPP_ASSERT(getBody(received) == content.substr(1000000, 2000000));
+    }
+    
+    { /* suffix range */
+      auto received = sendOverSocket(ResponseFactory::createFileResponse(filename, "bytes=-10"), currExecutor);
+      OATPP_ASSERT(received.find("\r\nContent-Range: bytes 3145718-3145727/3145728\r\n") != std::string::npos);
+      OATPP_ASSERT(getBody(received) == content.substr(content.size() - 10));
+    }
+    
+  }
+  
+  executor.stop();
+  executor.join();
+  
+  { /* not satisfiable range, not found */
+    auto response = ResponseFactory::createFileResponse(filename, "bytes=4000000-");
+    OATPP_ASSERT(response->getStatus().code == 416);
+    OATPP_ASSERT(response->getHeaders().find("Content-Range")->second.equals("bytes */3145728"));
+    
+    response = ResponseFactory::createFileResponse("/tmp/oatpp-FileBodyTest-does-not-exist", nullptr);
+    OATPP_ASSERT(response->getStatus().code == 404);
+  }
+  
+  { /* stream without sendfile - file is read by portions */
+    auto stream = oatpp::data::stream::ChunkedBuffer::createShared();
+    ResponseFactory::createFileResponse(filename, "bytes=10-20009")->send(stream);
+    auto text = stream->toString();
+    OATPP_ASSERT(getBody(std::string((const char*) text->getData(), text->getSize())) == content.substr(10, 20000));
+  }
+  
+  ::unlink(filename);
+  
+  return true;
+}
+  
+}}}}}}
@@ -0,0 +1,151 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ResponseTest.hpp"
+
+#include "oatpp/web/protocol/http/outgoing/Response.hpp"
+#include "oatpp/web/protocol/http/outgoing/BufferBody.hpp"
+#include "oatpp/web/protocol/http/outgoing/SharedBufferBody.hpp"
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+
+#include <thread>
+#include <vector>
+
+namespace oatpp { namespace test { namespace web { namespace protocol { namespace http { namespace outgoing {
+  
+namespace {
+  
+typedef oatpp::web::protocol::http::Status Status;
+typedef oatpp::web::protocol::http::Header Header;
+typedef oatpp::web::protocol::http::outgoing::Response Response;
+typedef oatpp::web::protocol::http::outgoing::BufferBody BufferBody;
+typedef oatpp::web::protocol::http::outgoing::SharedBufferBody SharedBufferBody;
+  
+oatpp::String sendToString(const std::shared_ptr<Response>& response) {
+  auto stream = oatpp::data::stream::ChunkedBuffer::createShared();
+  response->send(stream);
+  return stream->toString();
+}
+  
+v_int32 countOccurrences(const oatpp::String& text, const char* substring) {
+  v_int32 count = 0;
+  std::string str((const char*) text->getData(), text->getSize());
+  auto pos = str.find(substring);
+  while(pos != std::string::npos) {
+    count ++;
+    pos = str.find(substring, pos + 1);
+  }
+  return count;
+}
+  
+}
+  
+bool ResponseTest::onRun() {
+  
+  {
+    /* well-known status - pre-encoded line, Date and Server added */
+    auto text = sendToString(Response::createShared(Status::CODE_404, BufferBody::createShared("Hello")));
+    OATPP_LOGD(TAG, "response:\n%s", text->c_str());
+    OATPP_ASSERT(text->startsWith("HTTP/1.1 404 Not Found\r\n"));
+    OATPP_ASSERT(countOccurrences(text, "\r\nDate: ") == 1);
+    OATPP_ASSERT(countOccurrences(text, " GMT\r\n") == 1);
+    OATPP_ASSERT(countOccurrences(text, "\r\nServer: oatpp/") == 1);
+    OATPP_ASSERT(countOccurrences(text, "\r\nContent-Length: 5\r\n") == 1);
+    std::string str((const char*) text->getData(), text->getSize());
+    OATPP_ASSERT(str.substr(str.size() - 9) == "\r\n\r\nHello");
+  }
+  
+  {
+    /* custom status - line is formatted */
+    auto text = sendToString(Response::createShared(Status(200, "Fine"), nullptr));
+    OATPP_ASSERT(text->startsWith("HTTP/1.1 200 Fine\r\n"));
+    OATPP_ASSERT(countOccurrences(text, "\r\nContent-Length: 0\r\n") == 1);
+    
+    text = sendToString(Response::createShared(Status(299, "Unknown"), nullptr));
+    OATPP_ASSERT(text->startsWith("HTTP/1.1 299 Unknown\r\n"));
+  }
+  
+  {
+    /* Server and Date set by user are kept and not duplicated */
+    auto response = Response::createShared(Status::CODE_200, nullptr);
+    response->putHeader(Header::SERVER, "my-server");
+    auto text = sendToString(response);
+    OATPP_ASSERT(countOccurrences(text, "Server: ") == 1);
+    OATPP_ASSERT(countOccurrences(text, "\r\nServer: my-server\r\n") == 1);
+    OATPP_ASSERT(countOccurrences(text, "\r\nDate: ") == 1);
+    
+    response = Response::createShared(Status::CODE_200, nullptr);
+    response->putHeader(Header::DATE, "Thu, 01 Jan 1970 00:00:00 GMT");
+    text = sendToString(response);
+    OATPP_ASSERT(countOccurrences(text, "Date: ") == 1);
+    OATPP_ASSERT(countOccurrences(text, "\r\nDate: Thu, 01 Jan 1970 00:00:00 GMT\r\n") == 1);
+    OATPP_ASSERT(countOccurrences(text, "\r\nServer: oatpp/") == 1);
+  }
+  
+  {
+    /* shared body - prepared header lines, one instance sent by many responses on many threads */
+    oatpp::String payload = "{\"status\": \"ok\"}";
+    auto body = SharedBufferBody::createShared(payload, "application/json");
+    payload->getData()[0] = '['; // body keeps its own copy
+    
+    auto text = sendToString(Response::createShared(Status::CODE_200, body));
+    OATPP_ASSERT(text->startsWith("HTTP/1.1 200 OK\r\nContent-Length: 16\r\nContent-Type: application/json\r\n"));
+    OATPP_ASSERT(countOccurrences(text, "Content-Length") == 1);
+    OATPP_ASSERT(countOccurrences(text, "\r\nServer: oatpp/") == 1);
+    std::string str((const char*) text->getData(), text->getSize());
+    OATPP_ASSERT(str.substr(str.size() - 20) == "\r\n\r\n{\"status\": \"ok\"}");
+    
+    std::vector<std::thread> threads;
+    for(v_int32 i = 0; i < 4; i ++) {
+      threads.push_back(std::thread([body]{
+        for(v_int32 j = 0; j < 1000; j ++) {
+          auto text = sendToString(Response::createShared(Status::CODE_200, body));
+          OATPP_ASSERT(countOccurrences(text, "\r\n\r\n{\"status\": \"ok\"}") == 1);
+        }
+      }));
+    }
+    for(auto& thread : threads) {
+      thread.join();
+    }
+    
+    /* headers declared for body decorators */
+    oatpp::web::protocol::http::Protocol::Headers headers;
+    body->declareHeaders(headers);
+    OATPP_ASSERT(headers.size() == 2);
+    OATPP_ASSERT(headers.findById(Header::ID_CONTENT_LENGTH)->second.equals("16"));
+    OATPP_ASSERT(headers.findById(Header::ID_CONTENT_TYPE)->second.equals("application/json"));
+    
+    /* Content-Type set by user replaces the one of the body */
+    auto response = Response::createShared(Status::CODE_200, body);
+    response->putHeader(Header::CONTENT_TYPE, "text/plain");
+    text = sendToString(response);
+    OATPP_ASSERT(countOccurrences(text, "Content-Type") == 1);
+    OATPP_ASSERT(countOccurrences(text, "\r\nContent-Type: text/plain\r\n") == 1);
+    OATPP_ASSERT(countOccurrences(text, "\r\nContent-Length: 16\r\n") == 1);
+  }
+  
+  return true;
+}
+  
+}}}}}}
@@ -0,0 +1,387 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "HttpConnectionHandlerTest.hpp"
+
+#include "oatpp/test/web/app/Controller.hpp"
+#include "oatpp/test/web/app/ControllerAsync.hpp"
+
+#include "oatpp/web/server/handler/ResponseCache.hpp"
+#include "oatpp/web/server/HttpConnectionHandler.hpp"
+#include "oatpp/web/server/AsyncHttpConnectionHandler.hpp"
+#include "oatpp/web/server/HttpRouter.hpp"
+#include "oatpp/web/protocol/http/incoming/SimpleBodyDecoder.hpp"
+
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+
+#include "oatpp/network/virtual_/Interface.hpp"
+
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+namespace oatpp { namespace test { namespace web { namespace server {
+  
+namespace {
+  
+  typedef oatpp::web::server::HttpConnectionHandler HttpConnectionHandler;
+  
+  class TestConnection {
+  public:
+    std::shared_ptr<oatpp::network::virtual_::Socket> client;
+    std::shared_ptr<oatpp::network::virtual_::Socket> server;
+  public:
+    
+    TestConnection(const std::shared_ptr<oatpp::network::virtual_::Interface>& interface) {
+      auto submission = interface->connect();
+      server = interface->accept();
+      client = submission->getSocket();
+      server->setNonBlocking(false);
+      client->setNonBlocking(false);
+    }
+    
+    oatpp::String readAll() {
+      auto buffer = oatpp::data::stream::ChunkedBuffer::createShared();
+      v_char8 data[256];
+      while(true) {
+        auto res = client->read(data, 256);
+        if(res <= 0) {
+          break;
+        }
+        buffer->write(data, res);
+      }
+      return buffer->toString();
+    }
+    
+    /**
+     * Send keep-alive request and read its response. Connection stays open.
+     * Response came - the connection is taken by a worker.
+     */
+    oatpp::String roundTrip() {
+      client->OutputStream::write("GET / HTTP/1.1\r\n\r\n");
+      std::string text;
+      v_char8 data[256];
+      while(true) {
+        auto headersEnd = text.find("\r\n\r\n");
+        if(headersEnd != std::string::npos) {
+          auto pos = text.find("Content-Length: ");
+          OATPP_ASSERT(pos != std::string::npos && pos < headersEnd);
+          v_int32 size = (v_int32) headersEnd + 4 + std::atoi(text.c_str() + pos + 16);
+          if((v_int32) text.size() >= size) {
+            return oatpp::String(text.c_str(), size, true);
+          }
+        }
+        auto res = client->read(data, 256);
+        if(res <= 0) {
+          return oatpp::String(text.c_str(), (v_int32) text.size(), true);
+        }
+        text.append((const char*) data, res);
+      }
+    }
+    
+  };
+  
+  /**
+   * Send several requests at once and check that all responses came in order.
+   * Server side of the connection is closed only when the handler releases it - so it is released once readAll() returns.
+   */
+  void checkPipelining(TestConnection& connection) {
+    
+    std::weak_ptr<oatpp::network::virtual_::Socket> server = connection.server;
+    connection.server.reset();
+    
+    connection.client->OutputStream::write("GET /params/first HTTP/1.1\r\n\r\n"
+                                           "POST /body HTTP/1.1\r\nContent-Length: 6\r\n\r\nsecond"
+                                           "GET /headers HTTP/1.1\r\nX-TEST-HEADER: third\r\n\r\n"
+                                           "GET / HTTP/1.0\r\n\r\n");
+    
+    auto response = connection.readAll();
+    std::string text((const char*) response->getData(), response->getSize());
+    
+    v_int32 count = 0;
+    auto pos = text.find("HTTP/1.1 200 OK\r\n");
+    while(pos != std::string::npos) {
+      count ++;
+      pos = text.find("HTTP/1.1 200 OK\r\n", pos + 1);
+    }
+    OATPP_ASSERT(count == 4);
+    
+    auto first = text.find("first");
+    auto second = text.find("second");
+    auto third = text.find("third");
+    auto last = text.find("Hello World");
+    OATPP_ASSERT(first != std::string::npos);
+    OATPP_ASSERT(first < second && second < third && third < last && last != std::string::npos);
+    
+    OATPP_ASSERT(server.expired());
+    
+  }
+  
+  /**
+   * Body of a keep-alive request which is rejected (413) or not read by the endpoint looks like the next request.
+   * Connection must be closed after the response - the smuggled request is not served.
+   * Handler is expected to limit request body to 8 bytes.
+   */
+  void checkSmuggling(TestConnection& connection1, TestConnection& connection2) {
+    
+    const char* smuggled = "GET /params/smuggled HTTP/1.1\r\n\r\n";
+    oatpp::String contentLength = oatpp::utils::conversion::int32ToStr((v_int32) std::strlen(smuggled));
+    
+    connection1.server.reset();
+    connection1.client->OutputStream::write("POST /body HTTP/1.1\r\nContent-Length: ");
+    connection1.client->OutputStream::write(contentLength);
+    connection1.client->OutputStream::write("\r\n\r\n");
+    connection1.client->OutputStream::write(smuggled);
+    
+    auto response = connection1.readAll();
+    std::string text((const char*) response->getData(), response->getSize());
+    OATPP_ASSERT(text.find("HTTP/1.1 413") == 0);
+    OATPP_ASSERT(text.find("Connection: close\r\n") != std::string::npos);
+    OATPP_ASSERT(text.find("HTTP/1.1", 1) == std::string::npos);
+    OATPP_ASSERT(text.find("smuggled") == std::string::npos);
+    
+    connection2.server.reset();
+    connection2.client->OutputStream::write("GET / HTTP/1.1\r\nContent-Length: ");
+    connection2.client->OutputStream::write(contentLength);
+    connection2.client->OutputStream::write("\r\n\r\n");
+    connection2.client->OutputStream::write(smuggled);
+    
+    response = connection2.readAll();
+    text = std::string((const char*) response->getData(), response->getSize());
+    OATPP_ASSERT(text.find("HTTP/1.1 200") == 0);
+    OATPP_ASSERT(text.find("Connection: close\r\n") != std::string::npos);
+    OATPP_ASSERT(text.find("HTTP/1.1", 1) == std::string::npos);
+    OATPP_ASSERT(text.find("smuggled") == std::string::npos);
+    
+  }
+  
+  /**
+   * Second request is served from cache registered as request and response interceptor.
+   */
+  void checkResponseCache(TestConnection& connection, const std::shared_ptr<oatpp::web::server::handler::ResponseCache>& cache) {
+    
+    std::weak_ptr<oatpp::network::virtual_::Socket> server = connection.server;
+    connection.server.reset();
+    
+    connection.client->OutputStream::write("GET /params/cached HTTP/1.1\r\n\r\n"
+                                           "GET /params/cached HTTP/1.0\r\n\r\n");
+    
+    auto response = connection.readAll();
+    std::string text((const char*) response->getData(), response->getSize());
+    
+    auto first = text.find("\r\nETag: ");
+    OATPP_ASSERT(first != std::string::npos);
+    auto second = text.find("\r\nETag: ", first + 1);
+    OATPP_ASSERT(second != std::string::npos);
+    OATPP_ASSERT(text.compare(first, 20, text, second, 20) == 0);
+    
+    OATPP_ASSERT(server.expired());
+    OATPP_ASSERT(cache->getMissesCount() == 1 && cache->getHitsCount() == 1);
+    
+  }
+  
+}
+  
+bool HttpConnectionHandlerTest::onRun() {
+  
+  auto interface = oatpp::network::virtual_::Interface::createShared("virtualhost");
+  auto objectMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+  auto router = oatpp::web::server::HttpRouter::createShared();
+  auto controller = app::Controller::createShared(objectMapper);
+  controller->addEndpointsToRouter(router);
+  
+  {
+    
+    auto handler = HttpConnectionHandler::createShared(router, 1, 1, HttpConnectionHandler::OVERLOAD_POLICY_REJECT);
+    
+    /* Server side of a connection is closed when the worker releases it - after active workers count is decremented.
+     * So end of stream on the client side means the worker is done with the connection. */
+    
+    /* occupies the only worker */
+    TestConnection connection1(interface);
+    handler->handleConnection(connection1.server);
+    connection1.server.reset();
+    OATPP_ASSERT(connection1.roundTrip()->startsWith("HTTP/1.1 200"));
+    OATPP_ASSERT(handler->getActiveWorkersCount() == 1);
+    
+    /* waits in the queue */
+    TestConnection connection2(interface);
+    handler->handleConnection(connection2.server);
+    connection2.server.reset();
+    OATPP_ASSERT(handler->getQueueDepth() == 1);
+    
+    /* doesn't fit the queue */
+    TestConnection connection3(interface);
+    handler->handleConnection(connection3.server);
+    connection3.server.reset();
+    OATPP_ASSERT(handler->getRejectedConnectionsCount() == 1);
+    OATPP_ASSERT(handler->getQueueDepth() == 1);
+    
+    auto rejectResponse = connection3.readAll();
+    OATPP_ASSERT(rejectResponse->startsWith("HTTP/1.1 503"));
+    
+    /* worker is released and takes queued connection */
+    connection1.client->OutputStream::write("GET / HTTP/1.0\r\n\r\n");
+    auto response = connection1.readAll();
+    OATPP_ASSERT(response->startsWith("HTTP/1.1 200"));
+    OATPP_ASSERT(connection2.roundTrip()->startsWith("HTTP/1.1 200"));
+    OATPP_ASSERT(handler->getQueueDepth() == 0);
+    OATPP_ASSERT(handler->getActiveWorkersCount() == 1);
+    
+    connection2.client->OutputStream::write("GET / HTTP/1.0\r\n\r\n");
+    connection2.readAll();
+    OATPP_ASSERT(handler->getActiveWorkersCount() == 0);
+    
+  }
+  
+  {
+    
+    auto handler = HttpConnectionHandler::createShared(router, 1, 0, HttpConnectionHandler::OVERLOAD_POLICY_BLOCK);
+    
+    TestConnection connection1(interface);
+    handler->handleConnection(connection1.server);
+    connection1.server.reset();
+    OATPP_ASSERT(connection1.roundTrip()->startsWith("HTTP/1.1 200"));
+    OATPP_ASSERT(handler->getActiveWorkersCount() == 1);
+    
+    TestConnection connection2(interface);
+    std::atomic<bool> accepted(false);
+    std::thread acceptor([&handler, &connection2, &accepted]{
+      handler->handleConnection(connection2.server); // blocks until connection1 is finished
+      connection2.server.reset();
+      accepted = true;
+    });
+    
+    /* the only worker is busy with connection1 - acceptor can't return whenever it gets there */
+    OATPP_ASSERT(connection1.roundTrip()->startsWith("HTTP/1.1 200"));
+    OATPP_ASSERT(!accepted);
+    OATPP_ASSERT(handler->getQueueDepth() == 0);
+    
+    connection1.client.reset();
+    acceptor.join();
+    OATPP_ASSERT(accepted);
+    
+    connection2.client->OutputStream::write("GET / HTTP/1.0\r\n\r\n");
+    auto response = connection2.readAll();
+    OATPP_ASSERT(response->startsWith("HTTP/1.1 200"));
+    OATPP_ASSERT(handler->getRejectedConnectionsCount() == 0);
+    
+  }
+  
+  {
+    /* pipelined requests - sync */
+    auto handler = HttpConnectionHandler::createShared(router, 1, 1, HttpConnectionHandler::OVERLOAD_POLICY_REJECT);
+    TestConnection connection(interface);
+    handler->handleConnection(connection.server);
+    checkPipelining(connection);
+  }
+  
+  {
+    /* pipelined requests - async */
+    auto asyncRouter = oatpp::web::server::HttpRouter::createShared();
+    /* endpoints keep raw pointer to controller - it must outlive the executor */
+    auto asyncController = app::ControllerAsync::createShared(objectMapper);
+    asyncController->addEndpointsToRouter(asyncRouter);
+    auto executor = std::make_shared<oatpp::async::Executor>(1);
+    auto handler = oatpp::web::server::AsyncHttpConnectionHandler::createShared(asyncRouter, executor);
+    TestConnection connection(interface);
+    connection.server->setNonBlocking(true);
+    handler->handleConnection(connection.server);
+    checkPipelining(connection);
+    /* join - coroutine may still be finishing its cleanup when connection is released */
+    executor->stop();
+    executor->join();
+  }
+  
+  {
+    /* request body over the limit, unread request body - sync */
+    auto handler = HttpConnectionHandler::createShared(router, 1, 2, HttpConnectionHandler::OVERLOAD_POLICY_REJECT);
+    handler->setBodyDecoder(std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>(8));
+    TestConnection connection1(interface);
+    handler->handleConnection(connection1.server);
+    TestConnection connection2(interface);
+    handler->handleConnection(connection2.server);
+    checkSmuggling(connection1, connection2);
+  }
+  
+  {
+    /* request body over the limit, unread request body - async */
+    auto asyncRouter = oatpp::web::server::HttpRouter::createShared();
+    auto asyncController = app::ControllerAsync::createShared(objectMapper);
+    asyncController->addEndpointsToRouter(asyncRouter);
+    auto executor = std::make_shared<oatpp::async::Executor>(1);
+    auto handler = oatpp::web::server::AsyncHttpConnectionHandler::createShared(asyncRouter, executor);
+    handler->setBodyDecoder(std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>(8));
+    TestConnection connection1(interface);
+    connection1.server->setNonBlocking(true);
+    handler->handleConnection(connection1.server);
+    TestConnection connection2(interface);
+    connection2.server->setNonBlocking(true);
+    handler->handleConnection(connection2.server);
+    checkSmuggling(connection1, connection2);
+    executor->stop();
+    executor->join();
+  }
+  
+  {
+    /* response cache - sync */
+    auto cache = oatpp::web::server::handler::ResponseCache::createShared(1024 * 1024);
+    cache->addEndpoint(router, "GET", "/params/{param}", std::chrono::hours(1));
+    auto handler = HttpConnectionHandler::createShared(router, 1, 1, HttpConnectionHandler::OVERLOAD_POLICY_REJECT);
+    handler->addRequestInterceptor(cache);
+    handler->addResponseInterceptor(cache);
+    TestConnection connection(interface);
+    handler->handleConnection(connection.server);
+    checkResponseCache(connection, cache);
+  }
+  
+  {
+    /* response cache - async */
+    auto cache = oatpp::web::server::handler::ResponseCache::createShared(1024 * 1024);
+    auto asyncRouter = oatpp::web::server::HttpRouter::createShared();
+    /* endpoints keep raw pointer to controller - it must outlive the executor */
+    auto asyncController = app::ControllerAsync::createShared(objectMapper);
+    asyncController->addEndpointsToRouter(asyncRouter);
+    cache->addEndpoint(asyncRouter, "GET", "/params/{param}", std::chrono::hours(1));
+    auto executor = std::make_shared<oatpp::async::Executor>(1);
+    auto handler = oatpp::web::server::AsyncHttpConnectionHandler::createShared(asyncRouter, executor);
+    handler->addRequestInterceptor(cache);
+    handler->addResponseInterceptor(cache);
+    TestConnection connection(interface);
+    connection.server->setNonBlocking(true);
+    handler->handleConnection(connection.server);
+    checkResponseCache(connection, cache);
+    executor->stop();
+    executor->join();
+  }
+  
+  return true;
+}
+  
+}}}}
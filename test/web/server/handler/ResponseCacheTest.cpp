@@ -0,0 +1,278 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ResponseCacheTest.hpp"
+
+#include "oatpp/test/web/app/DTOs.hpp"
+
+#include "oatpp/web/server/handler/ResponseCache.hpp"
+#include "oatpp/web/protocol/http/outgoing/ResponseFactory.hpp"
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace web { namespace server { namespace handler {
+  
+namespace {
+  
+typedef oatpp::web::server::handler::ResponseCache ResponseCache;
+typedef oatpp::web::server::HttpRouter HttpRouter;
+typedef oatpp::web::protocol::http::incoming::Request IncomingRequest;
+typedef oatpp::web::protocol::http::outgoing::Response OutgoingResponse;
+typedef oatpp::web::protocol::http::outgoing::ResponseFactory ResponseFactory;
+typedef oatpp::web::protocol::http::Protocol Protocol;
+typedef oatpp::web::protocol::http::Status Status;
+  
+/**
+ * Passes request through router and cache the same way HttpProcessor does - handler is called on cache miss only.
+ */
+class Server : public HttpRouter::Subscriber {
+private:
+  std::shared_ptr<ResponseCache> m_cache;
+  std::shared_ptr<oatpp::data::mapping::ObjectMapper> m_objectMapper;
+public:
+  std::shared_ptr<HttpRouter> router;
+  std::atomic<v_int32> handlerCalls;
+  oatpp::String vary;
+public:
+  
+  Server(const std::shared_ptr<ResponseCache>& cache)
+    : m_cache(cache)
+    , m_objectMapper(oatpp::parser::json::mapping::ObjectMapper::createShared())
+    , router(HttpRouter::createShared())
+    , handlerCalls(0)
+  {
+    /* router is owned by the server - it must not own the server back */
+    std::shared_ptr<HttpRouter::Subscriber> subscriber(this, [](HttpRouter::Subscriber*){});
+    router->addSubscriber("GET", "/users/{userId}", subscriber);
+    router->addSubscriber("POST", "/users/{userId}", subscriber);
+    router->addSubscriber("GET", "/posts/{postId}", subscriber);
+    router->addSubscriber("GET", "/short", subscriber);
+  }
+  
+  std::shared_ptr<OutgoingResponse> processUrl(const std::shared_ptr<IncomingRequest>& request) override {
+    handlerCalls ++;
+    auto dto = app::TestDto::createShared();
+    dto->testValue = request->getStartingLine().path.toString();
+    auto response = ResponseFactory::createShared(Status::CODE_200, dto, m_objectMapper.get());
+    if(vary) {
+      response->putHeader("Vary", vary);
+    }
+    return response;
+  }
+  
+  Action processUrlAsync(oatpp::async::AbstractCoroutine* /* parentCoroutine */,
+                         AsyncCallback /* callback */,
+                         const std::shared_ptr<IncomingRequest>& /* request */) override {
+    throw std::runtime_error("not used in test");
+  }
+  
+  std::string process(const char* path,
+                      const char* ifNoneMatch = nullptr,
+                      const char* method = "GET",
+                      const char* headerName = nullptr,
+                      const char* headerValue = nullptr) {
+    oatpp::web::protocol::http::RequestStartingLine startingLine;
+    startingLine.method = method;
+    startingLine.path = path;
+    startingLine.protocol = "HTTP/1.1";
+    Protocol::Headers headers;
+    if(ifNoneMatch) {
+      headers.add("If-None-Match", ifNoneMatch);
+    }
+    if(headerName) {
+      headers.add(headerName, headerValue);
+    }
+    auto route = router->getRoute(startingLine.method, startingLine.path);
+    OATPP_ASSERT(route);
+    auto request = IncomingRequest::createShared(startingLine, route.matchMap, headers, nullptr, nullptr);
+    request->setRoutePattern(route.getPattern());
+    
+    std::shared_ptr<OutgoingResponse> response = m_cache->intercept(request);
+    if(!response) {
+      response = m_cache->intercept(request, route.processUrl(request));
+    }
+    
+    auto stream = oatpp::data::stream::ChunkedBuffer::createShared();
+    response->send(stream);
+    auto text = stream->toString();
+    return std::string((const char*) text->getData(), text->getSize());
+  }
+  
+};
+  
+std::string getBody(const std::string& response) {
+  return response.substr(response.find("\r\n\r\n") + 4);
+}
+  
+std::string expectedBody(const std::string& path) {
+  std::string result = "{\"testValue\": \"";
+  for(char c : path) {
+    if(c == '/') {
+      result += "\\/";
+    } else {
+      result.push_back(c);
+    }
+  }
+  return result + "\"}";
+}
+  
+std::string getHeader(const std::string& response, const std::string& name) {
+  auto pos = response.find("\r\n" + name + ": ");
+  if(pos == std::string::npos) {
+    return "";
+  }
+  pos += name.size() + 4;
+  return response.substr(pos, response.find("\r\n", pos) - pos);
+}
+  
+}
+  
+bool ResponseCacheTest::onRun() {
+  
+  {
+    auto cache = ResponseCache::createShared(1024 * 1024);
+    Server server(cache);
+    cache->addEndpoint(server.router, "GET", "/users/{userId}", std::chrono::hours(1));
+    cache->addEndpoint(server.router, "GET", "/short", std::chrono::milliseconds(50));
+    
+    /* miss - response is stored, then served from cache */
+    auto first = server.process("/users/1");
+    OATPP_ASSERT(first.compare(0, 17, "HTTP/1.1 200 OK\r\n") == 0);
+    OATPP_ASSERT(getBody(first) == expectedBody("/users/1"));
+    OATPP_ASSERT(getHeader(first, "Content-Type") == "application/json");
+    OATPP_ASSERT(getHeader(first, "Content-Length") == "27");
+    auto etag = getHeader(first, "ETag");
+    OATPP_ASSERT(etag.size() > 2 && etag[0] == '"');
+    
+    auto second = server.process("/users/1");
+    OATPP_ASSERT(server.handlerCalls == 1);
+    OATPP_ASSERT(getBody(second) == getBody(first));
+    OATPP_ASSERT(getHeader(second, "Content-Type") == "application/json");
+    OATPP_ASSERT(getHeader(second, "ETag") == etag);
+    OATPP_ASSERT(cache->getHitsCount() == 1 && cache->getMissesCount() == 1);
+    
+    /* query is a part of the key */
+    OATPP_ASSERT(getBody(server.process("/users/1?x=1")) == expectedBody("/users/1?x=1"));
+    OATPP_ASSERT(server.handlerCalls == 2);
+    OATPP_ASSERT(cache->getEntriesCount() == 2);
+    
+    /* If-None-Match */
+    auto notModified = server.process("/users/1", etag.c_str());
+    OATPP_ASSERT(notModified.compare(0, 17, "HTTP/1.1 304 Not ") == 0);
+    OATPP_ASSERT(getHeader(notModified, "ETag") == etag);
+    OATPP_ASSERT(notModified.find("Content-Length") == std::string::npos);
+    OATPP_ASSERT(getBody(notModified).empty());
+    OATPP_ASSERT(server.process("/users/1", ("\"other\", W/" + etag).c_str()).compare(0, 12, "HTTP/1.1 304") == 0);
+    OATPP_ASSERT(server.process("/users/1", "*").compare(0, 12, "HTTP/1.1 304") == 0);
+    OATPP_ASSERT(server.process("/users/1", "\"other\"").compare(0, 12, "HTTP/1.1 200") == 0);
+    OATPP_ASSERT(server.process("/users/2", "*").compare(0, 12, "HTTP/1.1 304") == 0); // stored on miss, matched right away
+    OATPP_ASSERT(server.handlerCalls == 3);
+    
+    /* not cached - other endpoint, other method, Vary */
+    server.process("/posts/1");
+    server.process("/posts/1");
+    server.process("/users/1", nullptr, "POST");
+    OATPP_ASSERT(server.handlerCalls == 6);
+    server.vary = "Accept-Encoding";
+    server.process("/users/3");
+    server.process("/users/3");
+    OATPP_ASSERT(server.handlerCalls == 8);
+    server.vary = nullptr;
+    
+    /* not cached - requests with credentials */
+    server.process("/users/1", nullptr, "GET", "Authorization", "Bearer 1");
+    server.process("/users/4", nullptr, "GET", "Cookie", "session=1");
+    server.process("/users/4", nullptr, "GET", "Cookie", "session=1");
+    OATPP_ASSERT(server.handlerCalls == 11);
+    OATPP_ASSERT(cache->getEntriesCount() == 3);
+    
+    /* TTL */
+    server.process("/short");
+    server.process("/short");
+    OATPP_ASSERT(server.handlerCalls == 12);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    server.process("/short");
+    OATPP_ASSERT(server.handlerCalls == 13);
+    
+    cache->clear();
+    OATPP_ASSERT(cache->getEntriesCount() == 0 && cache->getMemoryUsage() == 0);
+    server.process("/users/1");
+    OATPP_ASSERT(server.handlerCalls == 14);
+    
+    bool thrown = false;
+    try {
+      cache->addEndpoint(server.router, "GET", "/unknown", std::chrono::hours(1));
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    OATPP_ASSERT(thrown);
+  }
+  
+  { /* LRU bounded by memory */
+    auto cache = ResponseCache::createShared(4096, 1);
+    Server server(cache);
+    cache->addEndpoint(server.router, "GET", "/users/{userId}", std::chrono::hours(1));
+    for(v_int32 i = 0; i < 100; i ++) {
+      server.process(("/users/" + std::to_string(i)).c_str());
+      server.process("/users/0"); // keep recently used
+    }
+    OATPP_ASSERT(cache->getMemoryUsage() <= 4096);
+    OATPP_ASSERT(cache->getEntriesCount() > 1 && cache->getEntriesCount() < 100);
+    v_int32 calls = server.handlerCalls;
+    OATPP_ASSERT(calls == 100);
+    server.process("/users/0");
+    server.process("/users/99");
+    OATPP_ASSERT(server.handlerCalls == calls);
+    server.process("/users/1");
+    OATPP_ASSERT(server.handlerCalls == calls + 1);
+  }
+  
+  { /* concurrent access */
+    auto cache = ResponseCache::createShared(1024 * 1024, 4);
+    Server server(cache);
+    cache->addEndpoint(server.router, "GET", "/users/{userId}", std::chrono::hours(1));
+    std::vector<std::thread> threads;
+    for(v_int32 t = 0; t < 4; t ++) {
+      threads.push_back(std::thread([&server]{
+        for(v_int32 i = 0; i < 1000; i ++) {
+          std::string path = "/users/" + std::to_string(i % 50);
+          auto response = server.process(path.c_str());
+          OATPP_ASSERT(getBody(response) == expectedBody(path));
+        }
+      }));
+    }
+    for(auto& thread : threads) {
+      thread.join();
+    }
+    OATPP_ASSERT(cache->getEntriesCount() == 50);
+    OATPP_ASSERT(cache->getHitsCount() + cache->getMissesCount() == 4000);
+    OATPP_LOGD(TAG, "concurrent: handler calls=%d, hits=%d", (v_int32) server.handlerCalls, (v_int32) cache->getHitsCount());
+  }
+  
+  return true;
+}
+  
+}}}}}
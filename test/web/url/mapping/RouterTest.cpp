@@ -0,0 +1,287 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "RouterTest.hpp"
+
+#include "oatpp/web/url/mapping/Router.hpp"
+
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+
+#include <vector>
+
+namespace oatpp { namespace test { namespace web { namespace url { namespace mapping {
+
+namespace {
+  
+typedef oatpp::web::url::mapping::Pattern Pattern;
+typedef oatpp::web::url::mapping::PatternTree PatternTree;
+typedef oatpp::data::share::StringKeyLabel StringKeyLabel;
+  
+class IndexSubscriber : public oatpp::web::url::mapping::Subscriber<v_int32, v_int32> {
+private:
+  v_int32 m_index;
+public:
+  
+  IndexSubscriber(v_int32 index)
+    : m_index(index)
+  {}
+  
+  v_int32 processUrl(const v_int32& /* param */) override {
+    return m_index;
+  }
+  
+  Action processUrlAsync(oatpp::async::AbstractCoroutine* /* parentCoroutine */,
+                         AsyncCallback /* callback */,
+                         const v_int32& /* param */) override {
+    return Action::_FINISH;
+  }
+  
+};
+
+typedef oatpp::web::url::mapping::Router<v_int32, v_int32> Router;
+  
+/**
+ * Reference router - first registered pattern which matches
+ */
+v_int32 linearMatch(const std::vector<std::shared_ptr<Pattern>>& patterns, const StringKeyLabel& url) {
+  for(v_int32 i = 0; i < (v_int32) patterns.size(); i ++) {
+    Pattern::MatchMap matchMap;
+    if(patterns[i]->match(url, matchMap)) {
+      return i;
+    }
+  }
+  return -1;
+}
+  
+StringKeyLabel label(const char* text) {
+  return StringKeyLabel(oatpp::String(text));
+}
+  
+bool stringsEqual(const oatpp::String& a, const oatpp::String& b) {
+  if(!a || !b) {
+    return !a && !b;
+  }
+  return a->equals(b.get());
+}
+  
+void testEquivalence(const char* TAG) {
+  
+  const char* patternsText[] = {
+    "/",
+    "/users",
+    "/users/{userId}",
+    "/users/{userId}/posts",
+    "/users/{userId}/posts/{postId}",
+    "/users/me",
+    "/users/{id}/friends",
+    "/files/*",
+    "/files/static/{name}",
+    "/search?debug",
+    "/api/{version}/*",
+    "/api/v1/health",
+    "{root}",
+    "/docs/{page}/*",
+    "/docs/{page}/edit"
+  };
+  
+  const char* urls[] = {
+    "", "/", "//", "/users", "/users/", "/users?x=1", "/users/42", "/users/42/", "/users/42?a=b",
+    "/users/me", "/users/me/", "/users/42/posts", "/users/42/posts/7", "/users/42/posts/7?x",
+    "/users/42?x=1/posts", "/users/42?x/posts/7", "/users/42/friends", "/users//42///posts",
+    "/files", "/files/", "/files/a/b/c", "/files/static/logo.png", "/files/static/",
+    "/search", "/search?debug", "/searchx", "/api/v1/health", "/api/v2/health", "/api/v1", "/api/v1/",
+    "/other", "/other/deeper", "/docs/intro", "/docs/intro/edit", "/docs/intro/x/y", "/docs/intro?q",
+    "/users/42/posts/7/extra"
+  };
+  
+  std::vector<std::shared_ptr<Pattern>> patterns;
+  PatternTree tree;
+  Router router;
+  
+  const v_int32 patternsCount = sizeof(patternsText) / sizeof(patternsText[0]);
+  const v_int32 urlsCount = sizeof(urls) / sizeof(urls[0]);
+  
+  for(v_int32 i = 0; i < patternsCount; i ++) {
+    auto pattern = Pattern::parse(patternsText[i]);
+    patterns.push_back(pattern);
+    OATPP_ASSERT(tree.add(pattern) == i);
+    router.addSubscriber(patternsText[i], std::make_shared<IndexSubscriber>(i));
+  }
+  
+  for(v_int32 i = 0; i < urlsCount; i ++) {
+    
+    auto url = label(urls[i]);
+    v_int32 expected = linearMatch(patterns, url);
+    v_int32 actual = tree.match(url);
+    
+    if(expected != actual) {
+      OATPP_LOGD(TAG, "url='%s', expected=%d, actual=%d", urls[i], expected, actual);
+    }
+    OATPP_ASSERT(expected == actual);
+    
+    auto route = router.getRoute(url);
+    OATPP_ASSERT((bool) route == (expected >= 0));
+    if(route) {
+      OATPP_ASSERT(route.processUrl(0) == expected);
+      Pattern::MatchMap matchMap;
+      patterns[expected]->match(url, matchMap);
+      const char* variables[] = {"userId", "postId", "id", "name", "version", "root", "page"};
+      for(const char* variable : variables) {
+        OATPP_ASSERT(stringsEqual(route.matchMap.getVariable(variable), matchMap.getVariable(variable)));
+      }
+      OATPP_ASSERT(stringsEqual(route.matchMap.getTail(), matchMap.getTail()));
+    }
+    
+  }
+  
+}
+  
+void testVariableSlots() {
+  
+  {
+    auto pattern = Pattern::parse("/users/{userId}/posts/{postId}");
+    OATPP_ASSERT(pattern->getVariablesCount() == 2);
+    v_int32 userIdSlot = pattern->getVariableSlot("userId");
+    v_int32 postIdSlot = pattern->getVariableSlot("postId");
+    OATPP_ASSERT(userIdSlot == 0);
+    OATPP_ASSERT(postIdSlot == 1);
+    OATPP_ASSERT(pattern->getVariableSlot("unknown") == -1);
+    
+    Pattern::MatchMap matchMap;
+    OATPP_ASSERT(pattern->match(label("/users/42/posts/7"), matchMap));
+    OATPP_ASSERT(matchMap.getVariableAt(userIdSlot)->equals("42"));
+    OATPP_ASSERT(matchMap.getVariableAt(postIdSlot)->equals("7"));
+    OATPP_ASSERT(!matchMap.getVariableAt(2));
+    
+    Pattern::MatchMap copy = matchMap;
+    OATPP_ASSERT(copy.getVariable("postId")->equals("7"));
+  }
+  
+  {
+    /* more variables than MatchMap stores inline */
+    auto pattern = Pattern::parse("/{a}/{b}/{c}/{d}/{e}/{f}/{g}/{h}/{i}/{j}");
+    OATPP_ASSERT(pattern->getVariablesCount() == 10);
+    OATPP_ASSERT(pattern->getVariableSlot("h") == 7);
+    OATPP_ASSERT(pattern->getVariableSlot("i") == -1);
+    
+    Pattern::MatchMap matchMap;
+    OATPP_ASSERT(pattern->match(label("/1/2/3/4/5/6/7/8/9/10"), matchMap));
+    OATPP_ASSERT(matchMap.getVariable("a")->equals("1"));
+    OATPP_ASSERT(matchMap.getVariable("h")->equals("8"));
+    OATPP_ASSERT(matchMap.getVariable("i")->equals("9"));
+    OATPP_ASSERT(matchMap.getVariable("j")->equals("10"));
+  }
+  
+  {
+    /* repeated name - the last one wins */
+    auto pattern = Pattern::parse("/{a}/{a}");
+    Pattern::MatchMap matchMap;
+    OATPP_ASSERT(pattern->match(label("/1/2"), matchMap));
+    OATPP_ASSERT(matchMap.getVariable("a")->equals("2"));
+    OATPP_ASSERT(pattern->getVariableSlot("a") == 1);
+  }
+  
+}
+  
+void runBenchmark(v_int32 routesCount, const char* TAG) {
+  
+  const v_int32 iterations = 1000000 / routesCount + 1000;
+  
+  std::vector<std::shared_ptr<Pattern>> patterns;
+  Router router;
+  
+  for(v_int32 i = 0; i < routesCount; i ++) {
+    auto stream = oatpp::data::stream::ChunkedBuffer::createShared();
+    switch (i % 4) {
+      case 0: stream << "/api/v1/resource" << i; break;
+      case 1: stream << "/api/v1/resource" << i << "/{id}"; break;
+      case 2: stream << "/api/v1/resource" << i << "/{id}/items/{itemId}"; break;
+      case 3: stream << "/static" << i << "/*"; break;
+    }
+    auto text = stream->toString();
+    patterns.push_back(Pattern::parse(text));
+    router.addSubscriber(text, std::make_shared<IndexSubscriber>(i));
+  }
+  
+  auto lastStream = oatpp::data::stream::ChunkedBuffer::createShared();
+  lastStream << "/api/v1/resource" << (routesCount - 3) / 4 * 4 + 2 << "/123/items/456";
+  
+  StringKeyLabel urls[] = {
+    label("/api/v1/resource0"),
+    StringKeyLabel(lastStream->toString()),
+    label("/api/v2/unknown/path")
+  };
+  
+  for(StringKeyLabel& url : urls) {
+    OATPP_ASSERT(linearMatch(patterns, url) == (router.getRoute(url) ? router.getRoute(url).processUrl(0) : -1));
+  }
+  
+  v_int64 linearTime;
+  v_int64 treeTime;
+  
+  {
+    v_int64 start = oatpp::base::Environment::getMicroTickCount();
+    v_int32 found = 0;
+    for(v_int32 i = 0; i < iterations; i ++) {
+      for(StringKeyLabel& url : urls) {
+        if(linearMatch(patterns, url) >= 0) found ++;
+      }
+    }
+    linearTime = oatpp::base::Environment::getMicroTickCount() - start;
+    OATPP_ASSERT(found == iterations * 2);
+  }
+  
+  {
+    v_int64 start = oatpp::base::Environment::getMicroTickCount();
+    v_int32 found = 0;
+    for(v_int32 i = 0; i < iterations; i ++) {
+      for(StringKeyLabel& url : urls) {
+        if(router.getRoute(url)) found ++;
+      }
+    }
+    treeTime = oatpp::base::Environment::getMicroTickCount() - start;
+    OATPP_ASSERT(found == iterations * 2);
+  }
+  
+  v_int32 lookups = iterations * 3;
+  OATPP_LOGD(TAG, "routes=%d: linear=%d(ns/lookup), tree=%d(ns/lookup)",
+             routesCount, (v_int32)(linearTime * 1000 / lookups), (v_int32)(treeTime * 1000 / lookups));
+  
+}
+  
+}
+  
+bool RouterTest::onRun() {
+  
+  testEquivalence(TAG);
+  testVariableSlots();
+  
+  runBenchmark(10, TAG);
+  runBenchmark(100, TAG);
+  runBenchmark(1000, TAG);
+  
+  return true;
+}
+  
+}}}}}
@@ -49,7 +49,9 @@ public:
 public:
   HttpRequestExecutor(const std::shared_ptr<oatpp::network::ClientConnectionProvider>& connectionProvider,
                       const std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder>& bodyDecoder =
-                      std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>())
+                      std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>(
+                        oatpp::web::protocol::http::incoming::BodyInputStream::MAX_BODY_SIZE_UNLIMITED,
+                        oatpp::web::protocol::http::incoming::SimpleBodyDecoder::DEFAULT_CLIENT_MAX_INFLATED_SIZE))
     : m_connectionProvider(connectionProvider)
     , m_bodyDecoder(bodyDecoder)
   {}
@@ -58,7 +60,9 @@ public:
   static std::shared_ptr<HttpRequestExecutor>
   createShared(const std::shared_ptr<oatpp::network::ClientConnectionProvider>& connectionProvider,
                const std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder>& bodyDecoder =
-               std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>()){
+               std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>(
+                 oatpp::web::protocol::http::incoming::BodyInputStream::MAX_BODY_SIZE_UNLIMITED,
+                 oatpp::web::protocol::http::incoming::SimpleBodyDecoder::DEFAULT_CLIENT_MAX_INFLATED_SIZE)){
     return std::make_shared<HttpRequestExecutor>(connectionProvider, bodyDecoder);
   }
   
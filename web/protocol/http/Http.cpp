@@ -27,6 +27,10 @@
 #include "oatpp/test/Checker.hpp"
 #include "oatpp/core/data/stream/ChunkedBuffer.hpp"
 #include "oatpp/core/utils/ConversionUtils.hpp"
+#include "oatpp/core/parser/CharScanner.hpp"
+
+#include <cstdio>
+#include <cstring>
 
 namespace oatpp { namespace web { namespace protocol { namespace http {
   
@@ -97,6 +101,122 @@ const Status Status::CODE_509(509, "Bandwidth Limit Exceeded");
 const Status Status::CODE_510(510, "Not Extended");
 const Status Status::CODE_511(511, "Network Authentication Required");
 
+namespace {
+  
+/**
+ * StatusLine for each code in range [CODE_FIRST, CODE_LAST].
+ * Defined after Status constants - they are initialized first.
+ */
+class StatusLineTable {
+public:
+  static constexpr v_int32 CODE_FIRST = 100;
+  static constexpr v_int32 CODE_LAST = 599;
+private:
+  StatusLine m_lines[CODE_LAST - CODE_FIRST + 1];
+public:
+  
+  StatusLineTable() {
+    
+    static const Status* const statuses[] = {
+    &Status::CODE_100,
+    &Status::CODE_101,
+    &Status::CODE_102,
+    &Status::CODE_200,
+    &Status::CODE_201,
+    &Status::CODE_202,
+    &Status::CODE_203,
+    &Status::CODE_204,
+    &Status::CODE_205,
+    &Status::CODE_206,
+    &Status::CODE_207,
+    &Status::CODE_226,
+    &Status::CODE_300,
+    &Status::CODE_301,
+    &Status::CODE_302,
+    &Status::CODE_303,
+    &Status::CODE_304,
+    &Status::CODE_305,
+    &Status::CODE_306,
+    &Status::CODE_307,
+    &Status::CODE_400,
+    &Status::CODE_401,
+    &Status::CODE_402,
+    &Status::CODE_403,
+    &Status::CODE_404,
+    &Status::CODE_405,
+    &Status::CODE_406,
+    &Status::CODE_407,
+    &Status::CODE_408,
+    &Status::CODE_409,
+    &Status::CODE_410,
+    &Status::CODE_411,
+    &Status::CODE_412,
+    &Status::CODE_413,
+    &Status::CODE_414,
+    &Status::CODE_415,
+    &Status::CODE_416,
+    &Status::CODE_417,
+    &Status::CODE_422,
+    &Status::CODE_423,
+    &Status::CODE_424,
+    &Status::CODE_425,
+    &Status::CODE_426,
+    &Status::CODE_428,
+    &Status::CODE_429,
+    &Status::CODE_431,
+    &Status::CODE_434,
+    &Status::CODE_444,
+    &Status::CODE_449,
+    &Status::CODE_451,
+    &Status::CODE_500,
+    &Status::CODE_501,
+    &Status::CODE_502,
+    &Status::CODE_503,
+    &Status::CODE_504,
+    &Status::CODE_505,
+    &Status::CODE_506,
+    &Status::CODE_507,
+    &Status::CODE_508,
+    &Status::CODE_509,
+    &Status::CODE_510,
+    &Status::CODE_511
+    };
+    
+    for(auto& line : m_lines) {
+      line.description = nullptr;
+      line.size = 0;
+    }
+    
+    for(const Status* status : statuses) {
+      StatusLine& line = m_lines[status->code - CODE_FIRST];
+      line.description = status->description;
+      line.size = std::snprintf((char*) line.data, StatusLine::MAX_SIZE, "HTTP/1.1 %d %s\r\n", status->code, status->description);
+    }
+    
+  }
+  
+  const StatusLine* get(const Status& status) const {
+    if(status.code < CODE_FIRST || status.code > CODE_LAST || status.description == nullptr) {
+      return nullptr;
+    }
+    const StatusLine& line = m_lines[status.code - CODE_FIRST];
+    if(line.description == status.description ||
+       (line.description != nullptr && std::strcmp(line.description, status.description) == 0)) {
+      return &line;
+    }
+    return nullptr;
+  }
+  
+};
+  
+const StatusLineTable statusLineTable;
+  
+}
+  
+const StatusLine* StatusLine::get(const Status& status) {
+  return statusLineTable.get(status);
+}
+
 const char* const Header::Value::CONNECTION_CLOSE = "close";
 const char* const Header::Value::CONNECTION_KEEP_ALIVE = "keep-alive";
 const char* const Header::Value::CONNECTION_UPGRADE = "Upgrade";
@@ -107,8 +227,12 @@ const char* const Header::Value::USER_AGENT = "oatpp/" OATPP_VERSION;
 const char* const Header::Value::TRANSFER_ENCODING_CHUNKED = "chunked";
   
 const char* const Header::Value::CONTENT_TYPE_APPLICATION_JSON = "application/json";
+
+const char* const Header::Value::CONTENT_ENCODING_GZIP = "gzip";
+const char* const Header::Value::CONTENT_ENCODING_DEFLATE = "deflate";
   
 const char* const Header::ACCEPT = "Accept";
+const char* const Header::ACCEPT_ENCODING = "Accept-Encoding";
 const char* const Header::AUTHORIZATION = "Authorization";
 const char* const Header::CONNECTION = "Connection";
 const char* const Header::TRANSFER_ENCODING = "Transfer-Encoding";
@@ -117,10 +241,18 @@ const char* const Header::CONTENT_LENGTH = "Content-Length";
 const char* const Header::CONTENT_TYPE = "Content-Type";
 const char* const Header::CONTENT_RANGE = "Content-Range";
 const char* const Header::RANGE = "Range";
+const char* const Header::ACCEPT_RANGES = "Accept-Ranges";
 const char* const Header::HOST = "Host";
 const char* const Header::USER_AGENT = "User-Agent";
 const char* const Header::SERVER = "Server";
+const char* const Header::DATE = "Date";
 const char* const Header::UPGRADE = "Upgrade";
+const char* const Header::VARY = "Vary";
+const char* const Header::ETAG = "ETag";
+const char* const Header::IF_NONE_MATCH = "If-None-Match";
+const char* const Header::CACHE_CONTROL = "Cache-Control";
+const char* const Header::SET_COOKIE = "Set-Cookie";
+const char* const Header::COOKIE = "Cookie";
   
 const char* const Range::UNIT_BYTES = "bytes";
 const char* const ContentRange::UNIT_BYTES = "bytes";
@@ -129,9 +261,13 @@ oatpp::String Range::toString() const {
   oatpp::data::stream::ChunkedBuffer stream;
   stream.write(units->getData(), units->getSize());
   stream.write("=", 1);
-  stream.writeAsString((v_int64) start);
+  if(start >= 0) {
+    stream.writeAsString((v_int64) start);
+  }
   stream.write("-", 1);
-  stream.writeAsString((v_int64) end);
+  if(end >= 0) {
+    stream.writeAsString((v_int64) end);
+  }
   return stream.toString();
 }
 
@@ -160,8 +296,19 @@ Range Range::parse(oatpp::parser::ParsingCaret& caret) {
   caret.findRN();
   endLabel.end();
   
-  oatpp::os::io::Library::v_size start = oatpp::utils::conversion::strToInt64((const char*) startLabel.getData());
-  oatpp::os::io::Library::v_size end = oatpp::utils::conversion::strToInt64((const char*) endLabel.getData());
+  if(startLabel.getSize() == 0 && endLabel.getSize() == 0) {
+    caret.setError("range bounds - expected");
+    return Range();
+  }
+  
+  oatpp::os::io::Library::v_size start = -1;
+  oatpp::os::io::Library::v_size end = -1;
+  if(startLabel.getSize() > 0) {
+    start = oatpp::utils::conversion::strToInt64((const char*) startLabel.getData());
+  }
+  if(endLabel.getSize() > 0) {
+    end = oatpp::utils::conversion::strToInt64((const char*) endLabel.getData());
+  }
   return Range(unitsLabel.toString(true), start, end);
   
 }
@@ -239,17 +386,189 @@ ContentRange ContentRange::parse(const oatpp::String& str) {
   return parse(caret);
 }
   
+Headers::Headers()
+  : m_entries(m_inline)
+  , m_size(0)
+  , m_capacity(INLINE_CAPACITY)
+{
+  for(v_int32 i = 0; i < Header::ID_COUNT; i ++) {
+    m_known[i] = -1;
+  }
+}
+
+Headers::Headers(const Headers& other)
+  : m_entries(m_inline)
+  , m_size(0)
+  , m_capacity(INLINE_CAPACITY)
+{
+  copyFrom(other);
+}
+
+Headers::~Headers() {
+  if(m_entries != m_inline) {
+    delete [] m_entries;
+  }
+}
+
+Headers& Headers::operator=(const Headers& other) {
+  if(this != &other) {
+    copyFrom(other);
+  }
+  return *this;
+}
+
+void Headers::copyFrom(const Headers& other) {
+  if(other.m_size > m_capacity) {
+    if(m_entries != m_inline) {
+      delete [] m_entries;
+    }
+    m_entries = new Entry[other.m_capacity];
+    m_capacity = other.m_capacity;
+  }
+  for(v_int32 i = 0; i < other.m_size; i ++) {
+    m_entries[i] = other.m_entries[i];
+  }
+  for(v_int32 i = other.m_size; i < m_size; i ++) {
+    m_entries[i] = Entry();
+  }
+  m_size = other.m_size;
+  for(v_int32 i = 0; i < Header::ID_COUNT; i ++) {
+    m_known[i] = other.m_known[i];
+  }
+}
+
+void Headers::grow() {
+  v_int32 capacity = m_capacity * 2;
+  Entry* entries = new Entry[capacity];
+  for(v_int32 i = 0; i < m_size; i ++) {
+    entries[i] = std::move(m_entries[i]);
+  }
+  if(m_entries != m_inline) {
+    delete [] m_entries;
+  } else {
+    for(v_int32 i = 0; i < m_size; i ++) {
+      m_inline[i] = Entry();
+    }
+  }
+  m_entries = entries;
+  m_capacity = capacity;
+}
+
+v_int32 Headers::internId(const Key& name) {
+  p_char8 data = name.getData();
+  switch(name.getSize()) {
+    case 4:
+      if(base::StrBuffer::equalsCI_FAST(data, Header::HOST, 4)) return Header::ID_HOST;
+      if(base::StrBuffer::equalsCI_FAST(data, Header::DATE, 4)) return Header::ID_DATE;
+      break;
+    case 6:
+      if(base::StrBuffer::equalsCI_FAST(data, Header::SERVER, 6)) return Header::ID_SERVER;
+      break;
+    case 10:
+      if(base::StrBuffer::equalsCI_FAST(data, Header::CONNECTION, 10)) return Header::ID_CONNECTION;
+      break;
+    case 12:
+      if(base::StrBuffer::equalsCI_FAST(data, Header::CONTENT_TYPE, 12)) return Header::ID_CONTENT_TYPE;
+      break;
+    case 14:
+      if(base::StrBuffer::equalsCI_FAST(data, Header::CONTENT_LENGTH, 14)) return Header::ID_CONTENT_LENGTH;
+      break;
+    case 17:
+      if(base::StrBuffer::equalsCI_FAST(data, Header::TRANSFER_ENCODING, 17)) return Header::ID_TRANSFER_ENCODING;
+      break;
+  }
+  return Header::ID_UNKNOWN;
+}
+
+void Headers::add(const Key& name, const Value& value) {
+  if(m_size == m_capacity) {
+    grow();
+  }
+  Entry& entry = m_entries[m_size];
+  entry.first = name;
+  entry.second = value;
+  entry.id = internId(name);
+  if(entry.id >= 0 && m_known[entry.id] < 0) {
+    m_known[entry.id] = m_size;
+  }
+  m_size ++;
+}
+
+Headers::Value& Headers::operator[](const Key& name) {
+  iterator it = find(name);
+  if(it != end()) {
+    return it->second;
+  }
+  add(name, Value());
+  return m_entries[m_size - 1].second;
+}
+
+Headers::iterator Headers::find(const Key& name) {
+  const Headers* self = this;
+  return const_cast<iterator>(self->find(name));
+}
+
+Headers::const_iterator Headers::find(const Key& name) const {
+  v_int32 id = internId(name);
+  if(id >= 0) {
+    return findById(id);
+  }
+  for(v_int32 i = 0; i < m_size; i ++) {
+    if(m_entries[i].id < 0 && m_entries[i].first == name) {
+      return &m_entries[i];
+    }
+  }
+  return end();
+}
+
+Headers::const_iterator Headers::findNext(const_iterator from) const {
+  for(const_iterator it = from + 1; it < end(); it ++) {
+    if(it->id == from->id && it->first == from->first) {
+      return it;
+    }
+  }
+  return end();
+}
+
+v_int32 Headers::erase(const Key& name) {
+  v_int32 id = internId(name);
+  v_int32 size = 0;
+  for(v_int32 i = 0; i < m_size; i ++) {
+    bool match = (id >= 0) ? m_entries[i].id == id : (m_entries[i].id < 0 && m_entries[i].first == name);
+    if(!match) {
+      if(size != i) {
+        m_entries[size] = std::move(m_entries[i]);
+      }
+      size ++;
+    }
+  }
+  v_int32 removed = m_size - size;
+  if(removed > 0) {
+    for(v_int32 i = size; i < m_size; i ++) {
+      m_entries[i] = Entry();
+    }
+    m_size = size;
+    for(v_int32 i = 0; i < Header::ID_COUNT; i ++) {
+      m_known[i] = -1;
+    }
+    for(v_int32 i = m_size - 1; i >= 0; i --) {
+      if(m_entries[i].id >= 0) {
+        m_known[m_entries[i].id] = i;
+      }
+    }
+  }
+  return removed;
+}
+
 oatpp::data::share::StringKeyLabelCI_FAST Protocol::parseHeaderNameLabel(const std::shared_ptr<oatpp::base::StrBuffer>& headersText,
                                                                          oatpp::parser::ParsingCaret& caret) {
   p_char8 data = caret.getData();
-  for(v_int32 i = caret.getPosition(); i < caret.getSize(); i++) {
-    v_char8 a = data[i];
-    if(a == ':' || a == ' '){
-      oatpp::data::share::StringKeyLabelCI_FAST label(headersText, &data[caret.getPosition()], i - caret.getPosition());
-      caret.setPosition(i);
-      return label;
-      
-    }
+  v_int32 pos = caret.getPosition();
+  v_int32 found = oatpp::parser::CharScanner::findOneOf2(&data[pos], caret.getSize() - pos, ':', ' ');
+  if(found >= 0) {
+    oatpp::data::share::StringKeyLabelCI_FAST label(headersText, &data[pos], found);
+    caret.setPosition(pos + found);
+    return label;
   }
   return oatpp::data::share::StringKeyLabelCI_FAST(nullptr, nullptr, 0);
 }
@@ -330,7 +649,7 @@ void Protocol::parseOneHeader(Headers& headers,
     caret.findNotSpaceChar();
     v_int32 valuePos0 = caret.getPosition();
     caret.findRN();
-    headers[name] = oatpp::data::share::StringKeyLabel(headersText, &caret.getData()[valuePos0], caret.getPosition() - valuePos0);
+    headers.add(name, oatpp::data::share::StringKeyLabel(headersText, &caret.getData()[valuePos0], caret.getPosition() - valuePos0));
     caret.skipRN();
   } else {
     error = Status::CODE_431;
@@ -350,6 +669,21 @@ void Protocol::parseHeaders(Headers& headers,
     }
   }
   
+  /* Ambiguous message length - different framing on each hop allows request smuggling */
+  auto contentLength = headers.findById(Header::ID_CONTENT_LENGTH);
+  if(contentLength != headers.end()) {
+    if(headers.findById(Header::ID_TRANSFER_ENCODING) != headers.end()) {
+      error = Status::CODE_400;
+      return;
+    }
+    for(auto it = headers.findNext(contentLength); it != headers.end(); it = headers.findNext(it)) {
+      if(!(it->second == contentLength->second)) {
+        error = Status::CODE_400;
+        return;
+      }
+    }
+  }
+  
   caret.skipRN();
   
 }
@@ -131,6 +131,26 @@ public:
   }
   
 };
+
+/**
+ * Pre-encoded "HTTP/1.1 <code> <description>\r\n" line of a well-known status.
+ */
+class StatusLine {
+public:
+  static constexpr v_int32 MAX_SIZE = 64;
+public:
+  
+  /**
+   * Pre-encoded line of @status.
+   * nullptr if status is not one of Status::CODE_XXX (or has custom description) - line has to be formatted then.
+   */
+  static const StatusLine* get(const Status& status);
+  
+public:
+  const char* description;
+  v_char8 data[MAX_SIZE];
+  v_int32 size;
+};
   
 class HttpError : public protocol::ProtocolError<Status> {
 public:
@@ -161,9 +181,13 @@ public:
     
     static const char* const TRANSFER_ENCODING_CHUNKED;
     static const char* const CONTENT_TYPE_APPLICATION_JSON;
+    
+    static const char* const CONTENT_ENCODING_GZIP;
+    static const char* const CONTENT_ENCODING_DEFLATE;
   };
 public:
   static const char* const ACCEPT;              // "Accept"
+  static const char* const ACCEPT_ENCODING;     // "Accept-Encoding"
   static const char* const AUTHORIZATION;       // "Authorization"
   static const char* const CONNECTION;          // "Connection"
   static const char* const TRANSFER_ENCODING;   // "Transfer-Encoding"
@@ -172,10 +196,128 @@ public:
   static const char* const CONTENT_TYPE;        // "Content-Type"
   static const char* const CONTENT_RANGE;       // "Content-Range"
   static const char* const RANGE;               // "Range"
+  static const char* const ACCEPT_RANGES;       // "Accept-Ranges"
   static const char* const HOST;                // "Host"
   static const char* const USER_AGENT;          // "User-Agent"
   static const char* const SERVER;              // "Server"
+  static const char* const DATE;                // "Date"
   static const char* const UPGRADE;             // "Upgrade"
+  static const char* const VARY;                // "Vary"
+  static const char* const ETAG;                // "ETag"
+  static const char* const IF_NONE_MATCH;       // "If-None-Match"
+  static const char* const CACHE_CONTROL;       // "Cache-Control"
+  static const char* const SET_COOKIE;          // "Set-Cookie"
+  static const char* const COOKIE;              // "Cookie"
+public:
+  /*
+   * Ids of well-known headers. Headers container interns them when header is added,
+   * so they are looked up by index instead of name comparison.
+   */
+  static constexpr v_int32 ID_UNKNOWN = -1;
+  static constexpr v_int32 ID_HOST = 0;
+  static constexpr v_int32 ID_CONNECTION = 1;
+  static constexpr v_int32 ID_CONTENT_LENGTH = 2;
+  static constexpr v_int32 ID_CONTENT_TYPE = 3;
+  static constexpr v_int32 ID_TRANSFER_ENCODING = 4;
+  static constexpr v_int32 ID_SERVER = 5;
+  static constexpr v_int32 ID_DATE = 6;
+  static constexpr v_int32 ID_COUNT = 7;
+};
+  
+/**
+ * Flat container of (name, value) header labels in order of addition.
+ * Up to INLINE_CAPACITY headers are stored inline - no allocations for typical requests,
+ * and copy is a plain copy of used entries.
+ * Several headers with the same name are all kept (multi-value headers).
+ */
+class Headers {
+public:
+  typedef oatpp::data::share::StringKeyLabelCI_FAST Key;
+  typedef oatpp::data::share::StringKeyLabel Value;
+public:
+  
+  static constexpr v_int32 INLINE_CAPACITY = 16;
+  
+  /**
+   * first/second - to be iterated the same way as map entries.
+   */
+  class Entry {
+  public:
+    Key first;
+    Value second;
+    v_int32 id = Header::ID_UNKNOWN;
+  };
+  
+  typedef Entry* iterator;
+  typedef const Entry* const_iterator;
+  
+private:
+  Entry m_inline[INLINE_CAPACITY];
+  Entry* m_entries;
+  v_int32 m_size;
+  v_int32 m_capacity;
+  /* index of the first entry with given id, -1 if none */
+  v_int32 m_known[Header::ID_COUNT];
+private:
+  void copyFrom(const Headers& other);
+  void grow();
+public:
+  
+  Headers();
+  Headers(const Headers& other);
+  ~Headers();
+  
+  Headers& operator=(const Headers& other);
+  
+  /**
+   * Id of a well-known header or Header::ID_UNKNOWN.
+   */
+  static v_int32 internId(const Key& name);
+  
+  /**
+   * Append header. Headers with the same name already added are kept.
+   */
+  void add(const Key& name, const Value& value);
+  
+  /**
+   * Value of the first header with such name. Header is added if there is none.
+   */
+  Value& operator[](const Key& name);
+  
+  iterator find(const Key& name);
+  const_iterator find(const Key& name) const;
+  
+  /**
+   * Next header with the same name after @from - to iterate over values of multi-value header.
+   */
+  const_iterator findNext(const_iterator from) const;
+  
+  /**
+   * Remove all headers with such name. Returns number of headers removed.
+   */
+  v_int32 erase(const Key& name);
+  
+  /**
+   * Find well-known header by id - index check only.
+   */
+  const_iterator findById(v_int32 id) const {
+    v_int32 index = m_known[id];
+    return index < 0 ? end() : &m_entries[index];
+  }
+  
+  iterator begin() { return m_entries; }
+  iterator end() { return m_entries + m_size; }
+  const_iterator begin() const { return m_entries; }
+  const_iterator end() const { return m_entries + m_size; }
+  
+  v_int32 size() const {
+    return m_size;
+  }
+  
+  bool empty() const {
+    return m_size == 0;
+  }
+  
 };
   
 class Range {
@@ -196,7 +338,13 @@ public:
   {}
   
   oatpp::String units;
+  /**
+   * -1 - suffix range "bytes=-<end>" - last @end bytes.
+   */
   oatpp::os::io::Library::v_size start;
+  /**
+   * -1 - open range "bytes=<start>-" - till the end.
+   */
   oatpp::os::io::Library::v_size end;
   
   oatpp::String toString() const;
@@ -262,7 +410,7 @@ struct ResponseStartingLine {
   
 class Protocol {
 public:
-  typedef std::unordered_map<oatpp::data::share::StringKeyLabelCI_FAST, oatpp::data::share::StringKeyLabel> Headers;
+  typedef http::Headers Headers;
 private:
   static oatpp::data::share::StringKeyLabelCI_FAST parseHeaderNameLabel(const std::shared_ptr<oatpp::base::StrBuffer>& headersText,
                                                                         oatpp::parser::ParsingCaret& caret);
@@ -283,6 +431,10 @@ public:
                              oatpp::parser::ParsingCaret& caret,
                              Status& error);
   
+  /**
+   * Parse headers section. @error is set to 400 if message length is ambiguous -
+   * Content-Length together with Transfer-Encoding, or several different Content-Length values.
+   */
   static void parseHeaders(Headers& headers,
                            const std::shared_ptr<oatpp::base::StrBuffer>& headersText,
                            oatpp::parser::ParsingCaret& caret,
@@ -24,10 +24,28 @@
 
 #include "BodyDecoder.hpp"
 
-
-
 namespace oatpp { namespace web { namespace protocol { namespace http { namespace incoming {
-
-
+  
+oatpp::String BodyDecoder::decodeToString(const Protocol::Headers& headers,
+                                          const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream) const {
+  
+  auto size = getDecodedSize(headers);
+  if(size >= 0 && size <= std::numeric_limits<v_int32>::max()) {
+    auto stream = openStream(headers, bodyStream);
+    oatpp::String result((v_int32) size);
+    if(size > 0) {
+      auto res = oatpp::data::stream::readExactSizeData(stream.get(), result->getData(), size);
+      if(res != size) {
+        return oatpp::String((const char*) result->getData(), (v_int32) res, true);
+      }
+    }
+    return result;
+  }
+  
+  auto chunkedBuffer = oatpp::data::stream::ChunkedBuffer::createShared();
+  decode(headers, bodyStream, chunkedBuffer);
+  return chunkedBuffer->toString();
+  
+}
 
 }}}}}
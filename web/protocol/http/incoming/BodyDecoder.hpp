@@ -39,7 +39,11 @@ private:
     const BodyDecoder* m_decoder;
     Protocol::Headers m_headers;
     std::shared_ptr<oatpp::data::stream::InputStream> m_bodyStream;
-    std::shared_ptr<oatpp::data::stream::ChunkedBuffer> m_chunkedBuffer = oatpp::data::stream::ChunkedBuffer::createShared();
+    std::shared_ptr<oatpp::data::stream::ChunkedBuffer> m_chunkedBuffer;
+    std::shared_ptr<oatpp::data::stream::InputStream> m_decodedStream;
+    oatpp::String m_result;
+    void* m_data;
+    os::io::Library::v_size m_bytesLeft;
   public:
     
     ToStringDecoder(const BodyDecoder* decoder,
@@ -51,9 +55,28 @@ private:
     {}
     
     Action act() override {
+      auto size = m_decoder->getDecodedSize(m_headers);
+      if(size >= 0 && size <= std::numeric_limits<v_int32>::max()) {
+        m_decodedStream = m_decoder->openStream(m_headers, m_bodyStream);
+        m_result = oatpp::String((v_int32) size);
+        m_data = m_result->getData();
+        m_bytesLeft = size;
+        return yieldTo(&ToStringDecoder::readExactSize);
+      }
+      m_chunkedBuffer = oatpp::data::stream::ChunkedBuffer::createShared();
       return m_decoder->decodeAsync(this, yieldTo(&ToStringDecoder::onDecoded), m_headers, m_bodyStream, m_chunkedBuffer);
     }
     
+    Action readExactSize() {
+      if(m_bytesLeft == 0) {
+        return _return(m_result);
+      }
+      return oatpp::data::stream::readExactSizeDataAsyncInline(m_decodedStream.get(),
+                                                               m_data,
+                                                               m_bytesLeft,
+                                                               yieldTo(&ToStringDecoder::readExactSize));
+    }
+    
     Action onDecoded() {
       return _return(m_chunkedBuffer->toString());
     }
@@ -67,7 +90,6 @@ private:
     Protocol::Headers m_headers;
     std::shared_ptr<oatpp::data::stream::InputStream> m_bodyStream;
     std::shared_ptr<oatpp::data::mapping::ObjectMapper> m_objectMapper;
-    std::shared_ptr<oatpp::data::stream::ChunkedBuffer> m_chunkedBuffer = oatpp::data::stream::ChunkedBuffer::createShared();
   public:
     
     ToDtoDecoder(const BodyDecoder* decoder,
@@ -81,11 +103,10 @@ private:
     {}
     
     oatpp::async::Action act() override {
-      return m_decoder->decodeAsync(this, this->yieldTo(&ToDtoDecoder::onDecoded), m_headers, m_bodyStream, m_chunkedBuffer);
+      return m_decoder->decodeToStringAsync(this, &ToDtoDecoder::onDecoded, m_headers, m_bodyStream);
     }
     
-    oatpp::async::Action onDecoded() {
-      auto body = m_chunkedBuffer->toString();
+    oatpp::async::Action onDecoded(const oatpp::String& body) {
       oatpp::parser::ParsingCaret caret(body);
       auto dto = m_objectMapper->readFromCaret<Type>(caret);
       if(caret.hasError()) {
@@ -108,13 +129,24 @@ public:
                                            const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream,
                                            const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream) const = 0;
   
-  oatpp::String decodeToString(const Protocol::Headers& headers,
-                               const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream) const {
-    auto chunkedBuffer = oatpp::data::stream::ChunkedBuffer::createShared();
-    decode(headers, bodyStream, chunkedBuffer);
-    return chunkedBuffer->toString();
+  /**
+   * Pull-based stream of the decoded body. Body is decoded as it is read - nothing is buffered.
+   * Stream returned may throw HttpError (ex.: 413 if body is too large).
+   */
+  virtual std::shared_ptr<oatpp::data::stream::InputStream> openStream(const Protocol::Headers& headers,
+                                                                       const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream) const = 0;
+  
+  /**
+   * Size of the decoded body if it is known from @headers. -1 otherwise.
+   * When known, decodeToString() reads body straight into the resulting string.
+   */
+  virtual v_int64 getDecodedSize(const Protocol::Headers& /* headers */) const {
+    return -1;
   }
   
+  oatpp::String decodeToString(const Protocol::Headers& headers,
+                               const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream) const;
+  
   template<class Type>
   typename Type::ObjectWrapper decodeToDto(const Protocol::Headers& headers,
                                            const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream,
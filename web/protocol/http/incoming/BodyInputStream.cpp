@@ -0,0 +1,261 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+#include "BodyInputStream.hpp"
+
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace incoming {
+  
+constexpr v_int64 BodyInputStream::MAX_BODY_SIZE_UNLIMITED;
+  
+namespace {
+  constexpr v_int32 MAX_CHUNK_SIZE_DIGITS = 15;
+  constexpr v_int32 MAX_TRAILER_LINE_SIZE = 4096;
+}
+  
+BodyInputStream::BodyInputStream(const std::shared_ptr<oatpp::data::stream::InputStream>& stream,
+                                 v_int32 mode,
+                                 v_size contentLength,
+                                 v_int64 maxBodySize)
+  : m_stream(stream)
+  , m_bufferedStream(std::dynamic_pointer_cast<oatpp::data::stream::InputStreamBufferedProxy>(stream))
+  , m_mode(mode)
+  , m_maxBodySize(maxBodySize)
+  , m_state(STATE_DONE)
+  , m_bytesLeft(0)
+  , m_progress(0)
+  , m_digits(0)
+  , m_lineLength(0)
+{
+  if(m_mode == MODE_CHUNKED) {
+    m_state = STATE_SIZE;
+  } else if(m_mode == MODE_CONTENT_LENGTH && contentLength > 0) {
+    m_state = STATE_DATA;
+    m_bytesLeft = contentLength;
+  }
+}
+  
+std::shared_ptr<BodyInputStream> BodyInputStream::createShared(const Protocol::Headers& headers,
+                                                               const std::shared_ptr<oatpp::data::stream::InputStream>& stream,
+                                                               v_int64 maxBodySize)
+{
+  auto transferEncodingIt = headers.findById(Header::ID_TRANSFER_ENCODING);
+  if(transferEncodingIt != headers.end() && transferEncodingIt->second == Header::Value::TRANSFER_ENCODING_CHUNKED) {
+    return Shared_Http_Incoming_BodyInputStream_Pool::allocateShared(stream, MODE_CHUNKED, 0, maxBodySize);
+  }
+  
+  auto contentLengthIt = headers.findById(Header::ID_CONTENT_LENGTH);
+  if(contentLengthIt == headers.end()) {
+    return Shared_Http_Incoming_BodyInputStream_Pool::allocateShared(stream, MODE_EMPTY, 0, maxBodySize);
+  }
+  
+  bool success;
+  v_int64 contentLength = oatpp::utils::conversion::strToInt64(contentLengthIt->second.toString(), success);
+  if(!success || contentLength < 0) {
+    throw HttpError(Status::CODE_400, "Invalid 'Content-Length' Header");
+  }
+  if(maxBodySize >= 0 && contentLength > maxBodySize) {
+    throw HttpError(Status::CODE_413, "Request body is too large");
+  }
+  return Shared_Http_Incoming_BodyInputStream_Pool::allocateShared(stream, MODE_CONTENT_LENGTH, contentLength, maxBodySize);
+}
+  
+void BodyInputStream::onFramingChar(v_char8 a) {
+  
+  switch (m_state) {
+      
+    case STATE_SIZE: {
+      v_int32 digit;
+      if(a >= '0' && a <= '9') {
+        digit = a - '0';
+      } else if(a >= 'a' && a <= 'f') {
+        digit = a - 'a' + 10;
+      } else if(a >= 'A' && a <= 'F') {
+        digit = a - 'A' + 10;
+      } else if(m_digits > 0 && (a == ';' || a == ' ' || a == '\t')) {
+        m_state = STATE_EXTENSION;
+        return;
+      } else if(m_digits > 0 && a == '\r') {
+        m_state = STATE_SIZE_LF;
+        return;
+      } else {
+        throw HttpError(Status::CODE_400, "Invalid chunk size");
+      }
+      if(m_digits == MAX_CHUNK_SIZE_DIGITS) {
+        throw HttpError(Status::CODE_400, "Chunk size is too big");
+      }
+      m_bytesLeft = (m_bytesLeft << 4) + digit;
+      m_digits ++;
+      return;
+    }
+      
+    case STATE_EXTENSION:
+      if(a == '\r') {
+        m_state = STATE_SIZE_LF;
+      }
+      return;
+      
+    case STATE_SIZE_LF:
+      if(a != '\n') {
+        throw HttpError(Status::CODE_400, "Invalid chunk size line ending");
+      }
+      if(m_bytesLeft == 0) {
+        m_lineLength = 0;
+        m_state = STATE_TRAILER;
+        return;
+      }
+      if(m_maxBodySize >= 0 && m_progress + m_bytesLeft > m_maxBodySize) {
+        throw HttpError(Status::CODE_413, "Request body is too large");
+      }
+      m_state = STATE_DATA;
+      return;
+      
+    case STATE_DATA_CR:
+      if(a != '\r') {
+        throw HttpError(Status::CODE_400, "Chunk data is not followed by CRLF");
+      }
+      m_state = STATE_DATA_LF;
+      return;
+      
+    case STATE_DATA_LF:
+      if(a != '\n') {
+        throw HttpError(Status::CODE_400, "Chunk data is not followed by CRLF");
+      }
+      m_digits = 0;
+      m_state = STATE_SIZE;
+      return;
+      
+    case STATE_TRAILER:
+      if(a == '\r') {
+        m_state = STATE_TRAILER_LF;
+      } else if(++ m_lineLength > MAX_TRAILER_LINE_SIZE) {
+        throw HttpError(Status::CODE_400, "Too long trailer line");
+      }
+      return;
+      
+    case STATE_TRAILER_LF:
+      if(a != '\n') {
+        throw HttpError(Status::CODE_400, "Invalid trailer line ending");
+      }
+      if(m_lineLength == 0) {
+        m_state = STATE_DONE;
+      } else {
+        m_lineLength = 0;
+        m_state = STATE_TRAILER;
+      }
+      return;
+      
+    default:
+      throw std::runtime_error("[oatpp::web::protocol::http::incoming::BodyInputStream::onFramingChar()]: Invalid state");
+      
+  }
+  
+}
+  
+BodyInputStream::v_size BodyInputStream::readFraming() {
+  
+  if(m_bufferedStream) {
+    
+    auto size = m_bufferedStream->getBufferedSize();
+    if(size == 0) {
+      auto res = m_bufferedStream->fillBuffer();
+      if(res <= 0) {
+        return res;
+      }
+      size = m_bufferedStream->getBufferedSize();
+    }
+    
+    p_char8 data = m_bufferedStream->getBufferedData();
+    v_int32 i = 0;
+    while(i < size && m_state != STATE_DATA && m_state != STATE_DONE) {
+      onFramingChar(data[i ++]);
+    }
+    m_bufferedStream->consumeBuffered(i);
+    return i;
+    
+  }
+  
+  v_char8 a;
+  auto res = m_stream->read(&a, 1);
+  if(res > 0) {
+    onFramingChar(a);
+  }
+  return res;
+  
+}
+  
+BodyInputStream::v_size BodyInputStream::read(void *data, v_size count) {
+  
+  p_char8 buffer = (p_char8) data;
+  v_size progress = 0;
+  
+  while(progress < count) {
+    
+    /* Once there is some data for the caller - continue only while it doesn't touch the underlying stream */
+    bool hasBufferedData = m_bufferedStream && m_bufferedStream->getBufferedSize() > 0;
+    if(progress > 0 && !hasBufferedData) {
+      break;
+    }
+    
+    if(m_state == STATE_DATA) {
+      
+      v_size size = count - progress;
+      if(size > m_bytesLeft) {
+        size = m_bytesLeft;
+      }
+      if(progress > 0 && size > m_bufferedStream->getBufferedSize()) {
+        size = m_bufferedStream->getBufferedSize();
+      }
+      
+      auto res = m_stream->read(&buffer[progress], size);
+      if(res <= 0) {
+        if(progress > 0) {
+          break;
+        }
+        return res == 0 ? oatpp::data::stream::Errors::ERROR_IO_PIPE : res; // 0 - body is truncated
+      }
+      
+      progress += res;
+      m_bytesLeft -= res;
+      m_progress += res;
+      if(m_bytesLeft == 0) {
+        m_state = (m_mode == MODE_CHUNKED) ? STATE_DATA_CR : STATE_DONE;
+      }
+      
+    } else if(m_state == STATE_DONE) {
+      break;
+    } else {
+      auto res = readFraming();
+      if(res <= 0) {
+        return res == 0 ? oatpp::data::stream::Errors::ERROR_IO_PIPE : res; // 0 - body is truncated
+      }
+    }
+    
+  }
+  
+  return progress;
+  
+}
+  
+}}}}}
@@ -0,0 +1,128 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+#ifndef oatpp_web_protocol_http_incoming_BodyInputStream_hpp
+#define oatpp_web_protocol_http_incoming_BodyInputStream_hpp
+
+#include "oatpp/web/protocol/http/Http.hpp"
+#include "oatpp/core/data/stream/StreamBufferedProxy.hpp"
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace incoming {
+  
+/**
+ * Pull-based stream over the decoded message body.
+ * Content-Length and chunked framing are handled inline while reading - body is never materialized.
+ * When reading from InputStreamBufferedProxy, chunk headers and trailers are parsed straight from its buffer
+ * and one read() may return data of several chunks.
+ * read() returns 0 when body is over.
+ * Throws HttpError(413) as soon as body is known to exceed maxBodySize,
+ * and HttpError(400) on malformed chunked framing.
+ */
+class BodyInputStream : public oatpp::base::Controllable, public oatpp::data::stream::InputStream {
+public:
+  OBJECT_POOL(Http_Incoming_BodyInputStream_Pool, BodyInputStream, 32)
+  SHARED_OBJECT_POOL(Shared_Http_Incoming_BodyInputStream_Pool, BodyInputStream, 32)
+public:
+  typedef oatpp::os::io::Library::v_size v_size;
+public:
+  static constexpr v_int64 MAX_BODY_SIZE_UNLIMITED = -1;
+public:
+  /**
+   * Body has no framing headers - it is empty.
+   */
+  static constexpr v_int32 MODE_EMPTY = 0;
+  static constexpr v_int32 MODE_CONTENT_LENGTH = 1;
+  static constexpr v_int32 MODE_CHUNKED = 2;
+private:
+  static constexpr v_int32 STATE_SIZE = 0;
+  static constexpr v_int32 STATE_EXTENSION = 1;
+  static constexpr v_int32 STATE_SIZE_LF = 2;
+  static constexpr v_int32 STATE_DATA = 3;
+  static constexpr v_int32 STATE_DATA_CR = 4;
+  static constexpr v_int32 STATE_DATA_LF = 5;
+  static constexpr v_int32 STATE_TRAILER = 6;
+  static constexpr v_int32 STATE_TRAILER_LF = 7;
+  static constexpr v_int32 STATE_DONE = 8;
+private:
+  std::shared_ptr<oatpp::data::stream::InputStream> m_stream;
+  /**
+   * Set if m_stream is InputStreamBufferedProxy - framing is parsed straight from its buffer then.
+   */
+  std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy> m_bufferedStream;
+  v_int32 m_mode;
+  v_int64 m_maxBodySize;
+  v_int32 m_state;
+  v_size m_bytesLeft;
+  v_int64 m_progress;
+  v_int32 m_digits;
+  v_int32 m_lineLength;
+private:
+  void onFramingChar(v_char8 a);
+  /**
+   * Parse framing bytes till the next data or body end.
+   * Returns number of bytes parsed, 0 on end of stream, or stream error.
+   */
+  v_size readFraming();
+public:
+  
+  BodyInputStream(const std::shared_ptr<oatpp::data::stream::InputStream>& stream,
+                  v_int32 mode,
+                  v_size contentLength,
+                  v_int64 maxBodySize);
+  
+public:
+  
+  /**
+   * Choose framing by Transfer-Encoding and Content-Length @headers.
+   * Throws HttpError(413) if Content-Length is bigger than @maxBodySize.
+   */
+  static std::shared_ptr<BodyInputStream> createShared(const Protocol::Headers& headers,
+                                                       const std::shared_ptr<oatpp::data::stream::InputStream>& stream,
+                                                       v_int64 maxBodySize = MAX_BODY_SIZE_UNLIMITED);
+  
+  v_size read(void *data, v_size count) override;
+  
+  oatpp::async::Action getReadWaitAction() override {
+    return m_stream->getReadWaitAction();
+  }
+  
+  v_int32 getMode() const {
+    return m_mode;
+  }
+  
+  /**
+   * Number of body bytes read so far.
+   */
+  v_int64 getProgress() const {
+    return m_progress;
+  }
+  
+  bool isDone() const {
+    return m_state == STATE_DONE;
+  }
+  
+};
+  
+}}}}}
+
+#endif /* oatpp_web_protocol_http_incoming_BodyInputStream_hpp */
@@ -23,3 +23,37 @@
  ***************************************************************************/
 
 #include "Request.hpp"
+
+#include "oatpp/web/protocol/http/incoming/BodyInputStream.hpp"
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace incoming {
+  
+bool Request::isBodyDone() const {
+  
+  if(m_bodyRead) {
+    return true;
+  }
+  
+  if(m_openedBodyStream) {
+    /* Stream of a custom decoder or decompressing stream - can't tell how much of the body is left */
+    auto body = std::dynamic_pointer_cast<BodyInputStream>(m_openedBodyStream);
+    return body && body->isDone();
+  }
+  
+  if(m_headers.findById(Header::ID_TRANSFER_ENCODING) != m_headers.end()) {
+    return false;
+  }
+  
+  auto contentLengthIt = m_headers.findById(Header::ID_CONTENT_LENGTH);
+  if(contentLengthIt != m_headers.end()) {
+    bool success;
+    v_int64 contentLength = oatpp::utils::conversion::strToInt64(contentLengthIt->second.toString(), success);
+    return success && contentLength == 0;
+  }
+  
+  return true;
+  
+}
+  
+}}}}}
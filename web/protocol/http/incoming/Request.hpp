@@ -46,6 +46,16 @@ private:
    * Custom BodyDecoder can be set on demand
    */
   std::shared_ptr<const http::incoming::BodyDecoder> m_bodyDecoder;
+  
+  oatpp::base::memory::Arena* m_arena;
+  const url::mapping::Pattern* m_routePattern;
+  
+  /**
+   * Set when body is read till the end by one of streamBody/readBody methods.
+   * Async methods set it when decoding is started - decoding errors are passed to HttpProcessor which closes the connection.
+   */
+  mutable bool m_bodyRead;
+  mutable std::shared_ptr<oatpp::data::stream::InputStream> m_openedBodyStream;
 public:
   /*
   Request(const std::shared_ptr<const http::incoming::BodyDecoder>& pBodyDecoder)
@@ -63,6 +73,9 @@ public:
     , m_headers(headers)
     , m_bodyStream(bodyStream)
     , m_bodyDecoder(bodyDecoder)
+    , m_arena(nullptr)
+    , m_routePattern(nullptr)
+    , m_bodyRead(false)
   {}
 public:
   
@@ -74,6 +87,57 @@ public:
     return Shared_Incoming_Request_Pool::allocateShared(startingLine, pathVariables, headers, bodyStream, bodyDecoder);
   }
   
+  /**
+   * Allocate request on the arena of the connection. Arena is then available to endpoint via getArena()
+   * until the response is formed - see detachArena().
+   */
+  static std::shared_ptr<Request> createShared(oatpp::base::memory::Arena& arena,
+                                               const http::RequestStartingLine& startingLine,
+                                               const url::mapping::Pattern::MatchMap& pathVariables,
+                                               const http::Protocol::Headers& headers,
+                                               const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream,
+                                               const std::shared_ptr<const http::incoming::BodyDecoder>& bodyDecoder) {
+    auto request = oatpp::base::memory::arenaAllocateShared<Request>(arena, startingLine, pathVariables, headers, bodyStream, bodyDecoder);
+    request->m_arena = &arena;
+    return request;
+  }
+  
+  /**
+   * Arena of the request. Only objects explicitly created with arena overloads of createShared()
+   * (Response, StrBuffer, DTO object itself) are placed on it. Request headers, path variables and
+   * objects created by ObjectMapper or by DTO fields are allocated from their usual pools.<br>
+   * Objects placed on the arena stay valid as long as they are referenced - their memory block is
+   * released with the last of them.<br>
+   * Arena itself is owned by the connection processor and is not thread-safe - use it only in the
+   * thread handling the request, before the response is returned. Once the response is formed the
+   * processor calls detachArena(), so request retained after that returns nullptr here.
+   * @return - arena or nullptr if request wasn't created on arena or arena is detached.
+   */
+  oatpp::base::memory::Arena* getArena() const {
+    return m_arena;
+  }
+  
+  /**
+   * Forget the arena. Called by the connection processor once the response is formed -
+   * arena is reset for the next request of the connection and may be destroyed with it.
+   */
+  void detachArena() {
+    m_arena = nullptr;
+  }
+  
+  /**
+   * Pattern of the router route which the request was matched to. Owned by the router.
+   * Lets interceptors resolve per-route settings once per route instead of matching the path.
+   * nullptr if request wasn't routed.
+   */
+  const url::mapping::Pattern* getRoutePattern() const {
+    return m_routePattern;
+  }
+  
+  void setRoutePattern(const url::mapping::Pattern* routePattern) {
+    m_routePattern = routePattern;
+  }
+  
   const http::RequestStartingLine& getStartingLine() const {
     return m_startingLine;
   }
@@ -106,27 +170,52 @@ public:
     return m_pathVariables.getVariable(name);
   }
   
+  /**
+   * Get path variable by slot resolved once with Pattern::getVariableSlot().
+   */
+  oatpp::String getPathVariableAt(v_int32 slot) const {
+    return m_pathVariables.getVariableAt(slot);
+  }
+  
   oatpp::String getPathTail() const {
     return m_pathVariables.getTail();
   }
   
+  /**
+   * Pull-based stream of the decoded body. Body is not buffered - it is decoded as it is read.
+   * See BodyDecoder::openStream().
+   */
+  std::shared_ptr<oatpp::data::stream::InputStream> openBodyStream() const {
+    m_openedBodyStream = m_bodyDecoder->openStream(m_headers, m_bodyStream);
+    return m_openedBodyStream;
+  }
+  
+  /**
+   * True if request has no body or its body is read till the end.
+   * Otherwise the rest of the body is still in the connection and the connection can't be used for the next request.
+   */
+  bool isBodyDone() const;
+  
   void streamBody(const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream) const {
     m_bodyDecoder->decode(m_headers, m_bodyStream, toStream);
+    m_bodyRead = true;
   }
   
   oatpp::String readBodyToString() const {
-    return m_bodyDecoder->decodeToString(m_headers, m_bodyStream);
+    auto body = m_bodyDecoder->decodeToString(m_headers, m_bodyStream);
+    m_bodyRead = true;
+    return body;
   }
   
   template<class Type>
   typename Type::ObjectWrapper readBodyToDto(const std::shared_ptr<oatpp::data::mapping::ObjectMapper>& objectMapper) const {
-    return objectMapper->readFromString<Type>(m_bodyDecoder->decodeToString(m_headers, m_bodyStream));
+    return objectMapper->readFromString<Type>(readBodyToString());
   }
   
   template<class Type>
   void readBodyToDto(oatpp::data::mapping::type::PolymorphicWrapper<Type>& objectWrapper,
                      const std::shared_ptr<oatpp::data::mapping::ObjectMapper>& objectMapper) const {
-    objectWrapper = objectMapper->readFromString<Type>(m_bodyDecoder->decodeToString(m_headers, m_bodyStream));
+    objectWrapper = objectMapper->readFromString<Type>(readBodyToString());
   }
   
   // Async
@@ -134,12 +223,14 @@ public:
   oatpp::async::Action streamBodyAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
                                        const oatpp::async::Action& actionOnReturn,
                                        const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream) const {
+    m_bodyRead = true;
     return m_bodyDecoder->decodeAsync(parentCoroutine, actionOnReturn, m_headers, m_bodyStream, toStream);
   }
   
   template<typename ParentCoroutineType>
   oatpp::async::Action readBodyToStringAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
                                              oatpp::async::Action (ParentCoroutineType::*callback)(const oatpp::String&)) const {
+    m_bodyRead = true;
     return m_bodyDecoder->decodeToStringAsync(parentCoroutine, callback, m_headers, m_bodyStream);
   }
   
@@ -147,6 +238,7 @@ public:
   oatpp::async::Action readBodyToDtoAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
                                           oatpp::async::Action (ParentCoroutineType::*callback)(const typename DtoType::ObjectWrapper&),
                                           const std::shared_ptr<oatpp::data::mapping::ObjectMapper>& objectMapper) const {
+    m_bodyRead = true;
     return m_bodyDecoder->decodeToDtoAsync<DtoType>(parentCoroutine, callback, m_headers, m_bodyStream, objectMapper);
   }
   
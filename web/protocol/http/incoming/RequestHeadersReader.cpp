@@ -25,71 +25,85 @@
 #include "RequestHeadersReader.hpp"
 
 #include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+#include "oatpp/core/parser/CharScanner.hpp"
 
 namespace oatpp { namespace web { namespace protocol { namespace http { namespace incoming {
 
-os::io::Library::v_size RequestHeadersReader::readHeadersSection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
-                                                                 oatpp::data::stream::OutputStream* bufferStream,
-                                                                 Result& result) {
+void RequestHeadersReader::parse(const std::shared_ptr<oatpp::base::StrBuffer>& headersText,
+                                 p_char8 data,
+                                 v_int32 size,
+                                 Result& result,
+                                 http::Status& status)
+{
+  oatpp::parser::ParsingCaret caret(data, size);
+  http::Protocol::parseRequestStartingLine(result.startingLine, headersText, caret, status);
+  if(status.code == 0) {
+    http::Protocol::parseHeaders(result.headers, headersText, caret, status);
+  }
+}
+  
+RequestHeadersReader::Result RequestHeadersReader::readHeaders(const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
+                                                               http::HttpError::Info& error) {
   
-  v_word32 sectionEnd = ('\r' << 24) | ('\n' << 16) | ('\r' << 8) | ('\n');
+  RequestHeadersReader::Result result;
+  
+  p_char8 data = m_buffer->getData();
+  v_int32 bufferSize = m_buffer->getSize();
   v_word32 accumulator = 0;
-  v_int32 progress = 0;
-  os::io::Library::v_size res;
-  while (true) {
+  v_int32 progress = m_prefilledSize;
+  v_int32 bufferPos = m_prefilledSize;
+  v_int32 end = -1;
+  std::shared_ptr<oatpp::data::stream::ChunkedBuffer> spill; // only if headers don't fit the buffer
+  
+  if(bufferPos > 0) {
+    end = oatpp::parser::CharScanner::findRNRNEnd(data, 0, bufferPos, accumulator);
+    error.ioStatus = bufferPos;
+  }
+  
+  while (end < 0) {
     
-    v_int32 desiredToRead = m_bufferSize;
+    if(bufferPos == bufferSize) {
+      if(!spill) {
+        spill = oatpp::data::stream::ChunkedBuffer::createShared();
+      }
+      spill->write(data, bufferPos);
+      bufferPos = 0;
+    }
+    
+    v_int32 desiredToRead = bufferSize - bufferPos;
     if(progress + desiredToRead > m_maxHeadersSize) {
       desiredToRead = m_maxHeadersSize - progress;
       if(desiredToRead <= 0) {
-        return -1;
+        error.ioStatus = -1;
+        return result;
       }
     }
     
-    res = connection->read(m_buffer, desiredToRead);
+    auto res = connection->read(&data[bufferPos], desiredToRead);
     if(res > 0) {
-      bufferStream->write(m_buffer, res);
-      
-      for(v_int32 i = 0; i < res; i ++) {
-        accumulator <<= 8;
-        accumulator |= m_buffer[i];
-        if(accumulator == sectionEnd) {
-          result.bufferPosStart = i + 1;
-          result.bufferPosEnd = (v_int32) res;
-          return res;
-        }
-      }
-      
+      end = oatpp::parser::CharScanner::findRNRNEnd(data, bufferPos, bufferPos + (v_int32) res, accumulator);
+      progress += res;
+      bufferPos += res;
+      error.ioStatus = res;
     } else if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY || res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
       continue;
     } else {
-      break;
+      error.ioStatus = res;
+      return result;
     }
     
   }
   
-  return res;
-  
-}
-  
-RequestHeadersReader::Result RequestHeadersReader::readHeaders(const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
-                                                               http::HttpError::Info& error) {
-  
-  RequestHeadersReader::Result result;
-  
-  oatpp::data::stream::ChunkedBuffer buffer;
-  error.ioStatus = readHeadersSection(connection, &buffer, result);
-  
-  if(error.ioStatus > 0) {
-    auto headersText = buffer.toString();
-    oatpp::parser::ParsingCaret caret (headersText);
-    http::Status status;
-    http::Protocol::parseRequestStartingLine(result.startingLine, headersText.getPtr(), caret, status);
-    if(status.code == 0) {
-      http::Protocol::parseHeaders(result.headers, headersText.getPtr(), caret, status);
-    }
+  result.bufferPosStart = end;
+  result.bufferPosEnd = bufferPos;
+  http::Status status;
+  if(spill) {
+    spill->write(data, end);
+    auto headersText = spill->toString();
+    parse(headersText.getPtr(), headersText->getData(), headersText->getSize(), result, status);
+  } else {
+    parse(m_buffer, data, end, result, status);
   }
-  
   return result;
   
 }
@@ -103,28 +117,55 @@ RequestHeadersReader::Action RequestHeadersReader::readHeadersAsync(oatpp::async
   class ReaderCoroutine : public oatpp::async::CoroutineWithResult<ReaderCoroutine, const Result&> {
   private:
     std::shared_ptr<oatpp::data::stream::IOStream> m_connection;
-    p_char8 m_buffer;
-    v_int32 m_bufferSize;
+    std::shared_ptr<oatpp::base::StrBuffer> m_buffer;
     v_int32 m_maxHeadersSize;
     v_word32 m_accumulator;
     v_int32 m_progress;
+    v_int32 m_bufferPos;
+    v_int32 m_sectionEnd;
     RequestHeadersReader::Result m_result;
-    oatpp::data::stream::ChunkedBuffer m_bufferStream;
+    std::shared_ptr<oatpp::data::stream::ChunkedBuffer> m_spill;
   public:
     
     ReaderCoroutine(const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
-                    p_char8 buffer, v_int32 bufferSize, v_int32 maxHeadersSize)
+                    const std::shared_ptr<oatpp::base::StrBuffer>& buffer,
+                    v_int32 maxHeadersSize,
+                    v_int32 prefilledSize)
       : m_connection(connection)
       , m_buffer(buffer)
-      , m_bufferSize(bufferSize)
       , m_maxHeadersSize(maxHeadersSize)
       , m_accumulator(0)
-      , m_progress(0)
+      , m_progress(prefilledSize)
+      , m_bufferPos(prefilledSize)
+      , m_sectionEnd(0)
     {}
     
     Action act() override {
+      if(m_bufferPos > 0) {
+        m_sectionEnd = oatpp::parser::CharScanner::findRNRNEnd(m_buffer->getData(), 0, m_bufferPos, m_accumulator);
+        if(m_sectionEnd >= 0) {
+          m_result.bufferPosStart = m_sectionEnd;
+          m_result.bufferPosEnd = m_bufferPos;
+          return yieldTo(&ReaderCoroutine::parseHeaders);
+        }
+      }
+      return yieldTo(&ReaderCoroutine::readData);
+    }
+    
+    Action readData() {
       
-      v_int32 desiredToRead = m_bufferSize;
+      p_char8 data = m_buffer->getData();
+      v_int32 bufferSize = m_buffer->getSize();
+      
+      if(m_bufferPos == bufferSize) {
+        if(!m_spill) {
+          m_spill = oatpp::data::stream::ChunkedBuffer::createShared();
+        }
+        m_spill->write(data, m_bufferPos);
+        m_bufferPos = 0;
+      }
+      
+      v_int32 desiredToRead = bufferSize - m_bufferPos;
       if(m_progress + desiredToRead > m_maxHeadersSize) {
         desiredToRead = m_maxHeadersSize - m_progress;
         if(desiredToRead <= 0) {
@@ -132,24 +173,25 @@ RequestHeadersReader::Action RequestHeadersReader::readHeadersAsync(oatpp::async
         }
       }
       
-      auto res = m_connection->read(m_buffer, desiredToRead);
+      auto res = m_connection->read(&data[m_bufferPos], desiredToRead);
       if(res > 0) {
-        m_bufferStream.write(m_buffer, res);
         
-        for(v_int32 i = 0; i < res; i ++) {
-          m_accumulator <<= 8;
-          m_accumulator |= m_buffer[i];
-          if(m_accumulator == SECTION_END) {
-            m_result.bufferPosStart = i + 1;
-            m_result.bufferPosEnd = (v_int32) res;
-            return yieldTo(&ReaderCoroutine::parseHeaders);
-          }
+        m_sectionEnd = oatpp::parser::CharScanner::findRNRNEnd(data, m_bufferPos, m_bufferPos + (v_int32) res, m_accumulator);
+        m_progress += res;
+        m_bufferPos += res;
+        
+        if(m_sectionEnd >= 0) {
+          m_result.bufferPosStart = m_sectionEnd;
+          m_result.bufferPosEnd = m_bufferPos;
+          return yieldTo(&ReaderCoroutine::parseHeaders);
         }
         
-        return waitRetry();
+        return repeat();
         
-      } else if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY || res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
-        return waitRetry();
+      } else if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
+        return m_connection->getReadWaitAction();
+      } else if(res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
+        return repeat();
       } else {
         return abort();
       }
@@ -158,26 +200,25 @@ RequestHeadersReader::Action RequestHeadersReader::readHeadersAsync(oatpp::async
     
     Action parseHeaders() {
       
-      auto headersText = m_bufferStream.toString();
-      oatpp::parser::ParsingCaret caret (headersText);
       http::Status status;
-      http::Protocol::parseRequestStartingLine(m_result.startingLine, headersText.getPtr(), caret, status);
-      if(status.code == 0) {
-        http::Protocol::parseHeaders(m_result.headers, headersText.getPtr(), caret, status);
-        if(status.code == 0) {
-          return _return(m_result);
-        } else {
-          return error("error occurred while parsing headers");
-        }
+      if(m_spill) {
+        m_spill->write(m_buffer->getData(), m_sectionEnd);
+        auto headersText = m_spill->toString();
+        parse(headersText.getPtr(), headersText->getData(), headersText->getSize(), m_result, status);
       } else {
-        return error("can't parse starting line");
+        parse(m_buffer, m_buffer->getData(), m_sectionEnd, m_result, status);
+      }
+      
+      if(status.code == 0) {
+        return _return(m_result);
       }
+      return error("error occurred while parsing headers");
       
     }
     
   };
   
-  return parentCoroutine->startCoroutineForResult<ReaderCoroutine>(callback, connection, m_buffer, m_bufferSize, m_maxHeadersSize);
+  return parentCoroutine->startCoroutineForResult<ReaderCoroutine>(callback, connection, m_buffer, m_maxHeadersSize, m_prefilledSize);
   
 }
 
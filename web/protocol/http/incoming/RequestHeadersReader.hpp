@@ -30,36 +30,50 @@
 
 namespace oatpp { namespace web { namespace protocol { namespace http { namespace incoming {
   
+/**
+ * Reads request headers section into connection's headers buffer and parses it in place.
+ * Labels of RequestStartingLine and Protocol::Headers point into the headers buffer and hold it as memory handle.
+ * Buffer which is still referenced by labels must not be reused for the next request - see HttpProcessor::prepareHeadersBuffer().
+ * Headers section is copied only if it doesn't fit the buffer.
+ * Buffer may already hold beginning of the request - bytes of pipelined request read together with the previous one.
+ */
 class RequestHeadersReader {
 public:
   typedef oatpp::async::Action Action;
-private:
-  static constexpr v_int32 SECTION_END = ('\r' << 24) | ('\n' << 16) | ('\r' << 8) | ('\n');
-public:
   
   struct Result {
     http::RequestStartingLine startingLine;
     http::Protocol::Headers headers;
+    /**
+     * Bytes read beyond the headers section are in the headers buffer at [bufferPosStart, bufferPosEnd).
+     */
     v_int32 bufferPosStart;
     v_int32 bufferPosEnd;
   };
   
 public:
   typedef Action (oatpp::async::AbstractCoroutine::*AsyncCallback)(const Result&);
+public:
+  
+  static void parse(const std::shared_ptr<oatpp::base::StrBuffer>& headersText,
+                    p_char8 data,
+                    v_int32 size,
+                    Result& result,
+                    http::Status& status);
+  
 private:
-  os::io::Library::v_size readHeadersSection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
-                                             oatpp::data::stream::OutputStream* bufferStream,
-                                             Result& result);
-private:
-  p_char8 m_buffer;
-  v_int32 m_bufferSize;
+  std::shared_ptr<oatpp::base::StrBuffer> m_buffer;
   v_int32 m_maxHeadersSize;
+  v_int32 m_prefilledSize;
 public:
   
-  RequestHeadersReader(void* buffer, v_int32 bufferSize, v_int32 maxHeadersSize)
-    : m_buffer((p_char8) buffer)
-    , m_bufferSize(bufferSize)
+  /**
+   * @prefilledSize - bytes of the request already in the buffer at [0, prefilledSize).
+   */
+  RequestHeadersReader(const std::shared_ptr<oatpp::base::StrBuffer>& buffer, v_int32 maxHeadersSize, v_int32 prefilledSize = 0)
+    : m_buffer(buffer)
     , m_maxHeadersSize(maxHeadersSize)
+    , m_prefilledSize(prefilledSize)
   {}
   
   Result readHeaders(const std::shared_ptr<oatpp::data::stream::IOStream>& connection, http::HttpError::Info& error);
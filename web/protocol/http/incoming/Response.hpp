@@ -91,6 +91,14 @@ public:
     return m_bodyDecoder;
   }
 
+  /**
+   * Pull-based stream of the decoded body. Body is not buffered - it is decoded as it is read.
+   * See BodyDecoder::openStream().
+   */
+  std::shared_ptr<oatpp::data::stream::InputStream> openBodyStream() const {
+    return m_bodyDecoder->openStream(m_headers, m_bodyStream);
+  }
+  
   void streamBody(const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream) const {
     m_bodyDecoder->decode(m_headers, m_bodyStream, toStream);
   }
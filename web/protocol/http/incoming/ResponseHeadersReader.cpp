@@ -25,6 +25,7 @@
 #include "ResponseHeadersReader.hpp"
 
 #include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+#include "oatpp/core/parser/CharScanner.hpp"
 
 namespace oatpp { namespace web { namespace protocol { namespace http { namespace incoming {
   
@@ -32,7 +33,6 @@ os::io::Library::v_size ResponseHeadersReader::readHeadersSection(const std::sha
                                                                   oatpp::data::stream::OutputStream* bufferStream,
                                                                   Result& result) {
   
-  v_word32 sectionEnd = ('\r' << 24) | ('\n' << 16) | ('\r' << 8) | ('\n');
   v_word32 accumulator = 0;
   v_int32 progress = 0;
   os::io::Library::v_size res;
@@ -50,14 +50,11 @@ os::io::Library::v_size ResponseHeadersReader::readHeadersSection(const std::sha
     if(res > 0) {
       bufferStream->write(m_buffer, res);
       
-      for(v_int32 i = 0; i < res; i ++) {
-        accumulator <<= 8;
-        accumulator |= m_buffer[i];
-        if(accumulator == sectionEnd) {
-          result.bufferPosStart = i + 1;
-          result.bufferPosEnd = (v_int32) res;
-          return res;
-        }
+      v_int32 end = oatpp::parser::CharScanner::findRNRNEnd(m_buffer, 0, (v_int32) res, accumulator);
+      if(end >= 0) {
+        result.bufferPosStart = end;
+        result.bufferPosEnd = (v_int32) res;
+        return res;
       }
       
     } else if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY || res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
@@ -136,20 +133,19 @@ ResponseHeadersReader::Action ResponseHeadersReader::readHeadersAsync(oatpp::asy
       if(res > 0) {
         m_bufferStream.write(m_buffer, res);
         
-        for(v_int32 i = 0; i < res; i ++) {
-          m_accumulator <<= 8;
-          m_accumulator |= m_buffer[i];
-          if(m_accumulator == SECTION_END) {
-            m_result.bufferPosStart = i + 1;
-            m_result.bufferPosEnd = (v_int32) res;
-            return yieldTo(&ReaderCoroutine::parseHeaders);
-          }
+        v_int32 end = oatpp::parser::CharScanner::findRNRNEnd(m_buffer, 0, (v_int32) res, m_accumulator);
+        if(end >= 0) {
+          m_result.bufferPosStart = end;
+          m_result.bufferPosEnd = (v_int32) res;
+          return yieldTo(&ReaderCoroutine::parseHeaders);
         }
         
-        return waitRetry();
+        return repeat();
         
-      } else if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY || res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
-        return waitRetry();
+      } else if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
+        return m_connection->getReadWaitAction();
+      } else if(res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
+        return repeat();
       } else {
         return abort();
       }
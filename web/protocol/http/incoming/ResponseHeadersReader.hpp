@@ -33,9 +33,6 @@ namespace oatpp { namespace web { namespace protocol { namespace http { namespac
 class ResponseHeadersReader {
 public:
   typedef oatpp::async::Action Action;
-private:
-  static constexpr v_int32 SECTION_END = ('\r' << 24) | ('\n' << 16) | ('\r' << 8) | ('\n');
-public:
   
   struct Result {
     http::ResponseStartingLine startingLine;
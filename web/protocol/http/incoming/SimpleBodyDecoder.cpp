@@ -24,197 +24,126 @@
 
 #include "SimpleBodyDecoder.hpp"
 
-#include "oatpp/core/data/stream/StreamBufferedProxy.hpp"
 #include "oatpp/core/utils/ConversionUtils.hpp"
 
-namespace oatpp { namespace web { namespace protocol { namespace http { namespace incoming {
-  
-os::io::Library::v_size SimpleBodyDecoder::readLine(const std::shared_ptr<oatpp::data::stream::InputStream>& fromStream,
-                                                    p_char8 buffer,
-                                                    os::io::Library::v_size maxLineSize) {
-  
-  v_char8 a;
-  os::io::Library::v_size count = 0;
-  while (fromStream->read(&a, 1) > 0) {
-    if(a != '\r') {
-      if(count + 1 > maxLineSize) {
-        OATPP_LOGE("BodyDecoder", "Error - too long line");
-        return 0;
-      }
-      buffer[count++] = a;
-    } else {
-      fromStream->read(&a, 1);
-      if(a != '\n'){
-        OATPP_LOGE("BodyDecoder", "Warning - invalid line breaker");
-      }
-      return count; // size of line
-    }
-  }
-  
-  return count;
-  
-}
+#ifdef OATPP_ZLIB
+#include "oatpp/encoding/Zlib.hpp"
+#endif
 
-void SimpleBodyDecoder::doChunkedDecoding(const std::shared_ptr<oatpp::data::stream::InputStream>& fromStream,
-                                          const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream) {
-  
-  auto buffer = oatpp::data::buffer::IOBuffer::createShared();
-  
-  v_int32 maxLineSize = 8; // 0xFFFFFFFF 4Gb for chunk
-  v_char8 lineBuffer[maxLineSize + 1];
-  os::io::Library::v_size countToRead;
-  
-  do {
-    
-    auto lineSize = readLine(fromStream, lineBuffer, maxLineSize);
-    if(lineSize == 0 || lineSize >= maxLineSize) {
-      return; // error reading stream
-    }
-    lineBuffer[lineSize] = 0;
-    countToRead = std::strtol((const char*)lineBuffer, nullptr, 16);
-    
-    if(countToRead > 0) {
-      oatpp::data::stream::transfer(fromStream, toStream, countToRead, buffer->getData(), buffer->getSize());
-    }
-    
-    fromStream->read(lineBuffer, 2); // just skip "\r\n"
-    
-  } while (countToRead > 0);
-  
-}
-
-void SimpleBodyDecoder::decode(const Protocol::Headers& headers,
-                               const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream,
-                               const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream) const {
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace incoming {
   
-  auto transferEncodingIt = headers.find(Header::TRANSFER_ENCODING);
-  if(transferEncodingIt != headers.end() && transferEncodingIt->second == Header::Value::TRANSFER_ENCODING_CHUNKED) {
-    doChunkedDecoding(bodyStream, toStream);
-  } else {
-    oatpp::os::io::Library::v_size contentLength = 0;
-    auto contentLengthStrIt = headers.find(Header::CONTENT_LENGTH);
-    if(contentLengthStrIt == headers.end()) {
-      return; // DO NOTHING // it is an empty or invalid body
-    } else {
-      bool success;
-      contentLength = oatpp::utils::conversion::strToInt64(contentLengthStrIt->second.toString(), success);
-      if(!success){
-        return; // it is an invalid request/response
-      }
-      auto buffer = oatpp::data::buffer::IOBuffer::createShared();
-      if(contentLength > 0) {
-        oatpp::data::stream::transfer(bodyStream, toStream, contentLength, buffer->getData(), buffer->getSize());
-      }
-    }
-  }
+namespace {
   
-}
-
-oatpp::async::Action SimpleBodyDecoder::doChunkedDecodingAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
-                                                               const oatpp::async::Action& actionOnReturn,
-                                                               const std::shared_ptr<oatpp::data::stream::InputStream>& fromStream,
-                                                               const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream) {
+#ifdef OATPP_ZLIB
   
-  class ChunkedDecoder : public oatpp::async::Coroutine<ChunkedDecoder> {
+  /**
+   * Inflates gzip/deflate content-coding. Limits size of decompressed data with maxInflatedSize
+   * and reports corrupted data as 400.
+   */
+  class InflatedBodyStream : public oatpp::data::stream::InputStream {
   private:
-    const v_int32 MAX_LINE_SIZE = 8;
-  private:
-    std::shared_ptr<oatpp::data::stream::InputStream> m_fromStream;
-    std::shared_ptr<oatpp::data::stream::OutputStream> m_toStream;
-    std::shared_ptr<oatpp::data::buffer::IOBuffer> m_buffer = oatpp::data::buffer::IOBuffer::createShared();
-    v_int32 m_currLineLength;
-    v_char8 m_lineChar;
-    bool m_lineEnding;
-    v_char8 m_lineBuffer [16]; // used max 8
-    void* m_skipData;
-    os::io::Library::v_size m_skipSize;
-    bool m_done = false;
-  private:
-    void prepareSkipRN() {
-      m_skipData = &m_lineBuffer[0];
-      m_skipSize = 2;
-      m_currLineLength = 0;
-      m_lineEnding = false;
-    }
+    oatpp::encoding::Zlib::InflateStream m_stream;
+    v_int64 m_maxInflatedSize;
+    v_int64 m_progress;
   public:
     
-    ChunkedDecoder(const std::shared_ptr<oatpp::data::stream::InputStream>& fromStream,
-                   const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream)
-    : m_fromStream(fromStream)
-    , m_toStream(toStream)
+    InflatedBodyStream(const std::shared_ptr<oatpp::data::stream::InputStream>& stream, v_int64 maxInflatedSize)
+      : m_stream(stream)
+      , m_maxInflatedSize(maxInflatedSize)
+      , m_progress(0)
     {}
     
-    Action act() override {
-      m_currLineLength = 0;
-      m_lineEnding = false;
-      return yieldTo(&ChunkedDecoder::readLineChar);
-    }
-    
-    Action readLineChar() {
-      auto res = m_fromStream->read(&m_lineChar, 1);
-      if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
-        return oatpp::async::Action::_WAIT_RETRY;
-      } else if(res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
-        return oatpp::async::Action::_REPEAT;
-      } else if( res < 0) {
-        return error("[BodyDecoder::ChunkedDecoder] Can't read line char");
+    oatpp::os::io::Library::v_size read(void *data, oatpp::os::io::Library::v_size count) override {
+      oatpp::os::io::Library::v_size res;
+      try {
+        res = m_stream.read(data, count);
+      } catch (const oatpp::encoding::Zlib::DecodingError&) {
+        throw HttpError(Status::CODE_400, "Invalid compressed body");
       }
-      return yieldTo(&ChunkedDecoder::onLineCharRead);
-    }
-    
-    Action onLineCharRead() {
-      if(!m_lineEnding) {
-        if(m_lineChar != '\r') {
-          if(m_currLineLength + 1 > MAX_LINE_SIZE){
-            return error("[BodyDecoder::ChunkedDecoder] too long line");
-          }
-          m_lineBuffer[m_currLineLength ++] = m_lineChar;
-          return yieldTo(&ChunkedDecoder::readLineChar);
-        } else {
-          m_lineEnding = true;
-          return yieldTo(&ChunkedDecoder::readLineChar);
+      if(res > 0) {
+        m_progress += res;
+        if(m_progress > m_maxInflatedSize) {
+          throw HttpError(Status::CODE_413, "Decompressed body is too large");
         }
-      } else {
-        if(m_lineChar != '\n') {
-          OATPP_LOGD("[BodyDecoder::ChunkedDecoder]", "Warning - invalid line breaker")
-        }
-      }
-      if(m_currLineLength == 0) {
-        return error("Error reading stream. 0-length line");
       }
-      m_lineBuffer[m_currLineLength] = 0;
-      return yieldTo(&ChunkedDecoder::onLineRead);
+      return res;
     }
     
-    Action onLineRead() {
-      os::io::Library::v_size countToRead = std::strtol((const char*) m_lineBuffer, nullptr, 16);
-      if(countToRead > 0) {
-        prepareSkipRN();
-        return oatpp::data::stream::transferAsync(this, yieldTo(&ChunkedDecoder::skipRN), m_fromStream, m_toStream, countToRead, m_buffer);
-      }
-      m_done = true;
-      prepareSkipRN();
-      return yieldTo(&ChunkedDecoder::skipRN);
-    }
-    
-    Action skipRN() {
-      if(m_done) {
-        return oatpp::data::stream::readExactSizeDataAsyncInline(m_fromStream.get(),
-                                                                 m_skipData,
-                                                                 m_skipSize,
-                                                                 finish());
-      } else {
-        return oatpp::data::stream::readExactSizeDataAsyncInline(m_fromStream.get(),
-                                                                 m_skipData,
-                                                                 m_skipSize,
-                                                                 yieldTo(&ChunkedDecoder::readLineChar));
-      }
+    oatpp::async::Action getReadWaitAction() override {
+      return m_stream.getReadWaitAction();
     }
     
   };
   
-  return parentCoroutine->startCoroutine<ChunkedDecoder>(actionOnReturn, fromStream, toStream);
+#endif
+  
+}
+  
+constexpr v_int64 SimpleBodyDecoder::INFLATE_DISABLED;
+constexpr v_int64 SimpleBodyDecoder::DEFAULT_CLIENT_MAX_INFLATED_SIZE;
+  
+bool SimpleBodyDecoder::isInflated(const Protocol::Headers& headers) const {
+#ifdef OATPP_ZLIB
+  if(m_maxInflatedSize <= 0) {
+    return false;
+  }
+  auto it = headers.find(Header::CONTENT_ENCODING);
+  if(it != headers.end()) {
+    const auto& value = it->second;
+    return (value.getSize() == 4 && oatpp::base::StrBuffer::equalsCI(value.getData(), Header::Value::CONTENT_ENCODING_GZIP, 4)) ||
+           (value.getSize() == 7 && oatpp::base::StrBuffer::equalsCI(value.getData(), Header::Value::CONTENT_ENCODING_DEFLATE, 7));
+  }
+#else
+  (void) headers;
+#endif
+  return false;
+}
+  
+std::shared_ptr<oatpp::data::stream::InputStream> SimpleBodyDecoder::decodeContent(const Protocol::Headers& headers,
+                                                                                   const std::shared_ptr<BodyInputStream>& stream) const {
+#ifdef OATPP_ZLIB
+  if(!stream->isDone() && isInflated(headers)) {
+    return std::make_shared<InflatedBodyStream>(stream, m_maxInflatedSize);
+  }
+#else
+  (void) headers;
+#endif
+  return stream;
+}
+  
+std::shared_ptr<oatpp::data::stream::InputStream> SimpleBodyDecoder::openStream(const Protocol::Headers& headers,
+                                                                                const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream) const {
+  return decodeContent(headers, BodyInputStream::createShared(headers, bodyStream, m_maxBodySize));
+}
   
+v_int64 SimpleBodyDecoder::getDecodedSize(const Protocol::Headers& headers) const {
+  if(isInflated(headers)) {
+    return -1;
+  }
+  auto transferEncodingIt = headers.findById(Header::ID_TRANSFER_ENCODING);
+  if(transferEncodingIt != headers.end() && transferEncodingIt->second == Header::Value::TRANSFER_ENCODING_CHUNKED) {
+    return -1;
+  }
+  auto contentLengthIt = headers.findById(Header::ID_CONTENT_LENGTH);
+  if(contentLengthIt == headers.end()) {
+    return 0;
+  }
+  bool success;
+  v_int64 contentLength = oatpp::utils::conversion::strToInt64(contentLengthIt->second.toString(), success);
+  if(!success || contentLength < 0) {
+    return -1; // let openStream() report an error
+  }
+  return contentLength;
+}
+
+void SimpleBodyDecoder::decode(const Protocol::Headers& headers,
+                               const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream,
+                               const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream) const {
+  auto stream = BodyInputStream::createShared(headers, bodyStream, m_maxBodySize);
+  if(!stream->isDone()) {
+    auto buffer = oatpp::data::buffer::IOBuffer::createShared();
+    oatpp::data::stream::transfer(decodeContent(headers, stream), toStream, 0, buffer->getData(), buffer->getSize());
+  }
 }
 
 oatpp::async::Action SimpleBodyDecoder::decodeAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
@@ -222,32 +151,16 @@ oatpp::async::Action SimpleBodyDecoder::decodeAsync(oatpp::async::AbstractCorout
                                                     const Protocol::Headers& headers,
                                                     const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream,
                                                     const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream) const {
-  auto transferEncodingIt = headers.find(Header::TRANSFER_ENCODING);
-  if(transferEncodingIt != headers.end() && transferEncodingIt->second == Header::Value::TRANSFER_ENCODING_CHUNKED) {
-    return doChunkedDecodingAsync(parentCoroutine, actionOnReturn, bodyStream, toStream);
-  } else {
-    oatpp::os::io::Library::v_size contentLength = 0;
-    auto contentLengthStrIt = headers.find(Header::CONTENT_LENGTH);
-    if(contentLengthStrIt == headers.end()) {
-      return actionOnReturn; // DO NOTHING // it is an empty or invalid body
-    } else {
-      bool success;
-      contentLength = oatpp::utils::conversion::strToInt64(contentLengthStrIt->second.toString(), success);
-      if(!success){
-        return oatpp::async::Action(oatpp::async::Error("Invalid 'Content-Length' Header"));
-      }
-      if(contentLength > 0) {
-        return oatpp::data::stream::transferAsync(parentCoroutine,
-                                                  actionOnReturn,
-                                                  bodyStream,
-                                                  toStream,
-                                                  contentLength,
-                                                  oatpp::data::buffer::IOBuffer::createShared());
-      } else {
-        return actionOnReturn; // DO NOTHING
-      }
-    }
+  auto stream = BodyInputStream::createShared(headers, bodyStream, m_maxBodySize);
+  if(stream->isDone()) {
+    return actionOnReturn;
   }
+  return oatpp::data::stream::transferAsync(parentCoroutine,
+                                            actionOnReturn,
+                                            decodeContent(headers, stream),
+                                            toStream,
+                                            0,
+                                            oatpp::data::buffer::IOBuffer::createShared());
 }
   
 }}}}}
@@ -26,23 +26,48 @@
 #define oatpp_web_protocol_http_incoming_SimpleBodyDecoder_hpp
 
 #include "BodyDecoder.hpp"
+#include "BodyInputStream.hpp"
 
 namespace oatpp { namespace web { namespace protocol { namespace http { namespace incoming {
 
+/**
+ * Decodes Content-Length and chunked bodies with BodyInputStream.
+ * If oatpp is built with zlib, gzip and deflate Content-Encoding may be decompressed as well - see maxInflatedSize.
+ */
 class SimpleBodyDecoder : public BodyDecoder {
+public:
+  /**
+   * Compressed bodies are not decompressed - they are returned as received.
+   */
+  static constexpr v_int64 INFLATE_DISABLED = 0;
+  /**
+   * Limit of decompressed size used by HttpRequestExecutor by default.
+   */
+  static constexpr v_int64 DEFAULT_CLIENT_MAX_INFLATED_SIZE = 256 * 1024 * 1024;
 private:
-  static os::io::Library::v_size readLine(const std::shared_ptr<oatpp::data::stream::InputStream>& fromStream,
-                                          p_char8 buffer,
-                                          os::io::Library::v_size maxLineSize);
-  static void doChunkedDecoding(const std::shared_ptr<oatpp::data::stream::InputStream>& from,
-                                const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream);
-  
-  static oatpp::async::Action doChunkedDecodingAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
-                                                     const oatpp::async::Action& actionOnReturn,
-                                                     const std::shared_ptr<oatpp::data::stream::InputStream>& fromStream,
-                                                     const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream);
+  v_int64 m_maxBodySize;
+  v_int64 m_maxInflatedSize;
 public:
   
+  /**
+   * @maxBodySize - bodies bigger than that are rejected with 413 before they are read.
+   * @maxInflatedSize - gzip/deflate bodies are decompressed only if it is set. Bigger decompressed data is rejected with 413.
+   * Off by default - small compressed body may inflate to gigabytes (decompression bomb), so server has to opt in with a limit.
+   */
+  SimpleBodyDecoder(v_int64 maxBodySize = BodyInputStream::MAX_BODY_SIZE_UNLIMITED,
+                    v_int64 maxInflatedSize = INFLATE_DISABLED)
+    : m_maxBodySize(maxBodySize)
+    , m_maxInflatedSize(maxInflatedSize)
+  {}
+  
+  v_int64 getMaxBodySize() const {
+    return m_maxBodySize;
+  }
+  
+  v_int64 getMaxInflatedSize() const {
+    return m_maxInflatedSize;
+  }
+  
   void decode(const Protocol::Headers& headers,
               const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream,
               const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream) const override;
@@ -53,6 +78,15 @@ public:
                                    const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream,
                                    const std::shared_ptr<oatpp::data::stream::OutputStream>& toStream) const override;
   
+  std::shared_ptr<oatpp::data::stream::InputStream> openStream(const Protocol::Headers& headers,
+                                                               const std::shared_ptr<oatpp::data::stream::InputStream>& bodyStream) const override;
+  
+  v_int64 getDecodedSize(const Protocol::Headers& headers) const override;
+  
+private:
+  bool isInflated(const Protocol::Headers& headers) const;
+  std::shared_ptr<oatpp::data::stream::InputStream> decodeContent(const Protocol::Headers& headers,
+                                                                  const std::shared_ptr<BodyInputStream>& stream) const;
   
 };
   
@@ -28,6 +28,7 @@
 #include "oatpp/web/protocol/http/Http.hpp"
 
 #include "oatpp/core/data/stream/Stream.hpp"
+#include "oatpp/core/data/stream/IOVector.hpp"
 #include "oatpp/core/collection/ListMap.hpp"
 #include "oatpp/core/async/Coroutine.hpp"
 
@@ -39,6 +40,7 @@ protected:
 protected:
   typedef http::Protocol::Headers Headers;
   typedef oatpp::data::stream::OutputStream OutputStream;
+  typedef oatpp::data::stream::IOVector IOVector;
 public:
   
   /**
@@ -46,11 +48,30 @@ public:
    */
   virtual void declareHeaders(Headers& headers) noexcept = 0;
   
+  /**
+   * Add header lines of the body formatted beforehand ("Content-Length: 12\r\n") to @vector.
+   * Return false if body declares headers with declareHeaders().
+   * Not called if response has Content-Type or Content-Length set already - declareHeaders() is called instead.
+   * Data must stay valid while body is alive.
+   */
+  virtual bool appendPreparedHeaders(IOVector& /* vector */) noexcept {
+    return false;
+  }
+  
   /**
    * write content to stream
    */
   virtual void writeToStream(const std::shared_ptr<OutputStream>& stream) noexcept = 0;
   
+  /**
+   * Add body data to @vector so that it is written together with headers in one gather write.
+   * Return false if body has to be written with writeToStream().
+   * Data must stay valid while body is alive.
+   */
+  virtual bool appendToVector(IOVector& /* vector */) noexcept {
+    return false;
+  }
+  
   virtual Action writeToStreamAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
                                     const Action& actionOnReturn,
                                     const std::shared_ptr<OutputStream>& stream) = 0;
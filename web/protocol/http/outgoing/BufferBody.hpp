@@ -55,6 +55,11 @@ public:
     oatpp::data::stream::writeExactSizeData(stream.get(), m_buffer->getData(), m_buffer->getSize());
   }
   
+  bool appendToVector(IOVector& vector) noexcept override {
+    vector.add(m_buffer->getData(), m_buffer->getSize());
+    return true;
+  }
+  
 public:
   
   class WriteToStreamCoroutine : public oatpp::async::Coroutine<WriteToStreamCoroutine> {
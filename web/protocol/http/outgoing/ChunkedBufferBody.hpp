@@ -83,6 +83,14 @@ public:
     }
   }
   
+  bool appendToVector(IOVector& vector) noexcept override {
+    if(m_chunked) {
+      return false;
+    }
+    m_buffer->appendToVector(vector);
+    return true;
+  }
+  
 public:
   
   class WriteToStreamCoroutine : public oatpp::async::Coroutine<WriteToStreamCoroutine> {
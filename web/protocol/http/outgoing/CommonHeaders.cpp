@@ -0,0 +1,88 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "CommonHeaders.hpp"
+
+#include "oatpp/web/protocol/http/Http.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
+  
+namespace {
+  
+const char* const DAYS[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+const char* const MONTHS[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+  
+}
+  
+CommonHeaders::CommonHeaders()
+  : m_dateSize(0)
+  , m_size(0)
+  , m_time(0)
+{
+  refresh(std::time(nullptr));
+}
+  
+CommonHeaders& CommonHeaders::getThreadInstance() {
+  static thread_local CommonHeaders headers;
+  return headers;
+}
+  
+void CommonHeaders::refresh(std::time_t time) {
+  
+  std::tm t;
+  gmtime_r(&time, &t);
+  
+  /* IMF-fixdate. Not strftime - names must not depend on locale */
+  m_dateSize = std::snprintf((char*) m_data, MAX_SIZE, "%s: %s, %02d %s %04d %02d:%02d:%02d GMT\r\n",
+                             Header::DATE, DAYS[t.tm_wday], t.tm_mday, MONTHS[t.tm_mon], t.tm_year + 1900,
+                             t.tm_hour, t.tm_min, t.tm_sec);
+  
+  m_size = m_dateSize + std::snprintf((char*) &m_data[m_dateSize], MAX_SIZE - m_dateSize, "%s: %s\r\n",
+                                      Header::SERVER, Header::Value::SERVER);
+  
+  m_time = time;
+  
+}
+  
+v_int32 CommonHeaders::copyTo(p_char8 buffer, bool withDate, bool withServer) {
+  
+  std::time_t time = std::time(nullptr);
+  if(time != m_time) {
+    refresh(time);
+  }
+  
+  v_int32 start = withDate ? 0 : m_dateSize;
+  v_int32 end = withServer ? m_size : m_dateSize;
+  if(end > start) {
+    std::memcpy(buffer, &m_data[start], end - start);
+    return end - start;
+  }
+  return 0;
+  
+}
+  
+}}}}}
@@ -0,0 +1,68 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_web_protocol_http_outgoing_CommonHeaders_hpp
+#define oatpp_web_protocol_http_outgoing_CommonHeaders_hpp
+
+#include "oatpp/core/base/Environment.hpp"
+
+#include <ctime>
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
+  
+/**
+ * Pre-formatted "Date: <date>\r\nServer: <server>\r\n" block added to each response.
+ * One block per thread. Date is refreshed at most once per second.
+ */
+class CommonHeaders {
+public:
+  static constexpr v_int32 MAX_SIZE = 128;
+private:
+  v_char8 m_data[MAX_SIZE];
+  v_int32 m_dateSize;
+  v_int32 m_size;
+  std::time_t m_time;
+private:
+  void refresh(std::time_t time);
+public:
+  
+  CommonHeaders();
+  
+  /**
+   * Block of the calling thread.
+   */
+  static CommonHeaders& getThreadInstance();
+  
+  /**
+   * Copy block to @buffer of MAX_SIZE with one memcpy.
+   * @withDate, @withServer - false if response already has such header.
+   * Returns number of bytes copied.
+   */
+  v_int32 copyTo(p_char8 buffer, bool withDate, bool withServer);
+  
+};
+  
+}}}}}
+
+#endif /* oatpp_web_protocol_http_outgoing_CommonHeaders_hpp */
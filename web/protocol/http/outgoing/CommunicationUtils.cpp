@@ -34,7 +34,7 @@ bool CommunicationUtils::headerEqualsCI_FAST(const oatpp::data::share::MemoryLab
 v_int32 CommunicationUtils::considerConnectionState(const std::shared_ptr<protocol::http::incoming::Request>& request,
                                                     const std::shared_ptr<protocol::http::outgoing::Response>& response){
   
-  auto outState = response->getHeaders().find(Header::CONNECTION);
+  auto outState = response->getHeaders().findById(Header::ID_CONNECTION);
   if(outState != response->getHeaders().end() && headerEqualsCI_FAST(outState->second, Header::Value::CONNECTION_UPGRADE)) {
     return CONNECTION_STATE_UPGRADE;
   }
@@ -42,7 +42,7 @@ v_int32 CommunicationUtils::considerConnectionState(const std::shared_ptr<protoc
   if(request) {
     /* Set keep-alive to value specified in the client's request, if no Connection header present in response. */
     /* Set keep-alive to value specified in response otherwise */
-    auto it = request->getHeaders().find(Header::CONNECTION);
+    auto it = request->getHeaders().findById(Header::ID_CONNECTION);
     if(it != request->getHeaders().end() && headerEqualsCI_FAST(it->second, Header::Value::CONNECTION_KEEP_ALIVE)) {
       if(outState != response->getHeaders().end()) {
         if(headerEqualsCI_FAST(outState->second, Header::Value::CONNECTION_KEEP_ALIVE)) {
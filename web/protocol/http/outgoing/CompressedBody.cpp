@@ -0,0 +1,396 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "CompressedBody.hpp"
+
+#include "oatpp/core/data/buffer/IOBuffer.hpp"
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
+  
+namespace {
+  
+  /**
+   * Writes each portion of data as one chunk of chunked transfer-coding.
+   */
+  class ChunkedEncoderStream : public oatpp::data::stream::OutputStream {
+  private:
+    std::shared_ptr<oatpp::data::stream::OutputStream> m_stream;
+  public:
+    
+    ChunkedEncoderStream(const std::shared_ptr<oatpp::data::stream::OutputStream>& stream)
+      : m_stream(stream)
+    {}
+    
+    oatpp::os::io::Library::v_size write(const void *data, oatpp::os::io::Library::v_size count) override {
+      if(count == 0) {
+        return 0; // zero-size chunk would end the body
+      }
+      v_char8 header[24];
+      v_int32 headerSize = oatpp::utils::conversion::primitiveToCharSequence((long long) count, header, "%llX\r\n");
+      oatpp::data::stream::IOVector vector;
+      vector.add(header, headerSize);
+      vector.add(data, count);
+      vector.add("\r\n", 2);
+      oatpp::os::io::Library::v_size size = vector.getSize();
+      if(vector.writeToStream(m_stream.get()) != size) {
+        return oatpp::data::stream::Errors::ERROR_IO_PIPE;
+      }
+      return count;
+    }
+    
+  };
+  
+  /**
+   * Compresses data written to it and writes it to @stream as chunks of chunked transfer-coding - without blocking.
+   * Holds at most one chunk of compressed data. While the chunk is not sent write() accepts no data
+   * and returns ERROR_IO_WAIT_RETRY or ERROR_IO_RETRY - to be used by async writers.
+   */
+  class AsyncDeflateEncoderStream : public oatpp::data::stream::OutputStream {
+  public:
+    typedef oatpp::os::io::Library::v_size v_size;
+  private:
+    /* room for chunk size in hex and CRLF in front of compressed data */
+    static constexpr v_size CHUNK_HEADER_MAX_SIZE = 16;
+    static constexpr v_size CHUNK_TRAILER_SIZE = 2;
+  private:
+    std::shared_ptr<oatpp::data::stream::OutputStream> m_stream;
+    oatpp::encoding::Zlib::Deflater m_deflater;
+    std::shared_ptr<oatpp::data::buffer::IOBuffer> m_buffer;
+    p_char8 m_pendingData;
+    v_size m_pendingSize;
+    bool m_lastChunkQueued;
+  private:
+    
+    void queueChunk(v_size dataSize) {
+      p_char8 buffer = (p_char8) m_buffer->getData();
+      v_char8 header[CHUNK_HEADER_MAX_SIZE];
+      v_int32 headerSize = oatpp::utils::conversion::primitiveToCharSequence((long long) dataSize, header, "%llX\r\n");
+      m_pendingData = &buffer[CHUNK_HEADER_MAX_SIZE - headerSize];
+      std::memcpy(m_pendingData, header, headerSize);
+      std::memcpy(&buffer[CHUNK_HEADER_MAX_SIZE + dataSize], "\r\n", CHUNK_TRAILER_SIZE);
+      m_pendingSize = headerSize + dataSize + CHUNK_TRAILER_SIZE;
+    }
+    
+    /**
+     * Deflate to the free buffer and queue the result as a chunk. Returns number of bytes consumed or -1.
+     */
+    v_size deflate(const void* data, v_size count, bool finish) {
+      v_size produced;
+      auto consumed = m_deflater.deflate(data, count,
+                                         &((p_char8) m_buffer->getData())[CHUNK_HEADER_MAX_SIZE],
+                                         m_buffer->getSize() - CHUNK_HEADER_MAX_SIZE - CHUNK_TRAILER_SIZE,
+                                         finish, produced);
+      if(produced > 0) {
+        queueChunk(produced);
+      }
+      return consumed;
+    }
+    
+    /**
+     * Try to send pending chunk. Returns 0 if nothing is pending anymore, error code of @stream otherwise.
+     */
+    v_size flush() {
+      while(m_pendingSize > 0) {
+        auto res = m_stream->write(m_pendingData, m_pendingSize);
+        if(res <= 0) {
+          return res == 0 ? oatpp::data::stream::Errors::ERROR_IO_PIPE : res;
+        }
+        m_pendingData = &m_pendingData[res];
+        m_pendingSize -= res;
+      }
+      return 0;
+    }
+    
+  public:
+    
+    AsyncDeflateEncoderStream(const std::shared_ptr<oatpp::data::stream::OutputStream>& stream, v_int32 format, v_int32 level)
+      : m_stream(stream)
+      , m_deflater(format, level)
+      , m_buffer(oatpp::data::buffer::IOBuffer::createShared())
+      , m_pendingData(nullptr)
+      , m_pendingSize(0)
+      , m_lastChunkQueued(false)
+    {}
+    
+    v_size write(const void *data, v_size count) override {
+      
+      auto res = flush();
+      if(res != 0) {
+        return res;
+      }
+      
+      auto consumed = deflate(data, count, false);
+      if(consumed < 0) {
+        return oatpp::data::stream::Errors::ERROR_IO_PIPE;
+      }
+      
+      res = flush();
+      if(res != 0 && res != oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
+        return res;
+      }
+      if(consumed == 0) {
+        return oatpp::data::stream::Errors::ERROR_IO_RETRY;
+      }
+      return consumed;
+      
+    }
+    
+    /**
+     * Send the rest of compressed data and the last chunk. Call until it returns 0.
+     * Returns error code of @stream if it can't accept data now.
+     */
+    v_size finish() {
+      while(true) {
+        auto res = flush();
+        if(res != 0) {
+          return res;
+        }
+        if(!m_deflater.isFinished()) {
+          if(deflate(nullptr, 0, true) < 0) {
+            return oatpp::data::stream::Errors::ERROR_IO_PIPE;
+          }
+        } else if(!m_lastChunkQueued) {
+          m_lastChunkQueued = true;
+          m_pendingData = (p_char8) m_buffer->getData();
+          std::memcpy(m_pendingData, "0\r\n\r\n", 5);
+          m_pendingSize = 5;
+        } else {
+          return 0;
+        }
+      }
+    }
+    
+    oatpp::async::Action getWriteWaitAction() override {
+      return m_stream->getWriteWaitAction();
+    }
+    
+  };
+  
+  class DeflateCoroutine : public oatpp::async::Coroutine<DeflateCoroutine> {
+  private:
+    std::shared_ptr<Body> m_body;
+    std::shared_ptr<oatpp::data::stream::OutputStream> m_stream;
+    std::shared_ptr<AsyncDeflateEncoderStream> m_encoderStream;
+  public:
+    
+    DeflateCoroutine(const std::shared_ptr<Body>& body,
+                     const std::shared_ptr<oatpp::data::stream::OutputStream>& stream,
+                     v_int32 format,
+                     v_int32 level)
+      : m_body(body)
+      , m_stream(stream)
+      , m_encoderStream(std::make_shared<AsyncDeflateEncoderStream>(stream, format, level))
+    {}
+    
+    Action act() override {
+      return m_body->writeToStreamAsync(this, yieldTo(&DeflateCoroutine::finishBody), m_encoderStream);
+    }
+    
+    Action finishBody() {
+      auto res = m_encoderStream->finish();
+      if(res == 0) {
+        return finish();
+      } else if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
+        return m_stream->getWriteWaitAction();
+      } else if(res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
+        return repeat();
+      }
+      return abort();
+    }
+    
+  };
+  
+  /**
+   * q-value of Accept-Encoding entry in thousandths. 1000 if there is no q parameter.
+   */
+  v_int32 parseQValue(p_char8 data, v_int32 size) {
+    v_int32 pos = 0;
+    while(pos < size) {
+      while(pos < size && (data[pos] == ';' || data[pos] == ' ' || data[pos] == '\t')) pos ++;
+      if(pos + 1 < size && (data[pos] == 'q' || data[pos] == 'Q') && data[pos + 1] == '=') {
+        pos += 2;
+        v_int32 value = 0;
+        if(pos < size && data[pos] == '1') {
+          value = 1000;
+        } else {
+          pos ++; // "0"
+          if(pos < size && data[pos] == '.') {
+            pos ++;
+            v_int32 multiplier = 100;
+            while(pos < size && multiplier > 0 && data[pos] >= '0' && data[pos] <= '9') {
+              value += (data[pos] - '0') * multiplier;
+              multiplier /= 10;
+              pos ++;
+            }
+          }
+        }
+        return value;
+      }
+      while(pos < size && data[pos] != ';') pos ++;
+    }
+    return 1000;
+  }
+  
+  bool tokenEquals(p_char8 data, v_int32 size, const char* token) {
+    v_int32 tokenSize = (v_int32) std::strlen(token);
+    return size == tokenSize && oatpp::base::StrBuffer::equalsCI(data, token, size);
+  }
+  
+}
+  
+v_int32 CompressedBody::chooseFormat(const Protocol::Headers& requestHeaders) {
+  
+  v_int32 gzipQ = -1;
+  v_int32 deflateQ = -1;
+  v_int32 anyQ = -1;
+  
+  auto it = requestHeaders.find(Header::ACCEPT_ENCODING);
+  while(it != requestHeaders.end()) {
+    
+    p_char8 data = it->second.getData();
+    v_int32 size = it->second.getSize();
+    v_int32 pos = 0;
+    
+    while(pos < size) {
+      
+      while(pos < size && (data[pos] == ',' || data[pos] == ' ' || data[pos] == '\t')) pos ++;
+      v_int32 tokenStart = pos;
+      while(pos < size && data[pos] != ',' && data[pos] != ';' && data[pos] != ' ' && data[pos] != '\t') pos ++;
+      v_int32 tokenSize = pos - tokenStart;
+      v_int32 paramsStart = pos;
+      while(pos < size && data[pos] != ',') pos ++;
+      
+      if(tokenSize > 0) {
+        v_int32 q = parseQValue(&data[paramsStart], pos - paramsStart);
+        if(tokenEquals(&data[tokenStart], tokenSize, Header::Value::CONTENT_ENCODING_GZIP)) {
+          gzipQ = q;
+        } else if(tokenEquals(&data[tokenStart], tokenSize, Header::Value::CONTENT_ENCODING_DEFLATE)) {
+          deflateQ = q;
+        } else if(tokenSize == 1 && data[tokenStart] == '*') {
+          anyQ = q;
+        }
+      }
+      
+    }
+    
+    it = requestHeaders.findNext(it);
+  }
+  
+  /* codings not listed explicitly get q-value of "*" */
+  if(gzipQ < 0) gzipQ = anyQ;
+  if(deflateQ < 0) deflateQ = anyQ;
+  
+  if(gzipQ > 0 && gzipQ >= deflateQ) {
+    return oatpp::encoding::Zlib::FORMAT_GZIP;
+  } else if(deflateQ > 0) {
+    return oatpp::encoding::Zlib::FORMAT_DEFLATE;
+  }
+  return -1;
+  
+}
+  
+std::shared_ptr<Body> CompressedBody::createIfAccepted(const std::shared_ptr<Body>& body,
+                                                       const Protocol::Headers& requestHeaders,
+                                                       v_int32 level,
+                                                       v_int64 minSize) {
+  if(!body) {
+    return body;
+  }
+  v_int32 format = chooseFormat(requestHeaders);
+  if(format < 0) {
+    return body;
+  }
+  return createShared(body, format, level, minSize);
+}
+  
+void CompressedBody::declareHeaders(Headers& headers) noexcept {
+  
+  m_body->declareHeaders(headers);
+  
+  m_compress = false;
+  if(headers.find(Header::CONTENT_ENCODING) != headers.end() ||
+     headers.find(Header::CONTENT_RANGE) != headers.end() ||
+     headers.findById(Header::ID_TRANSFER_ENCODING) != headers.end()) {
+    return;
+  }
+  
+  auto contentLengthIt = headers.findById(Header::ID_CONTENT_LENGTH);
+  if(contentLengthIt != headers.end()) {
+    bool success;
+    v_int64 contentLength = oatpp::utils::conversion::strToInt64(contentLengthIt->second.toString(), success);
+    if(!success || contentLength < m_minSize) {
+      return;
+    }
+  }
+  
+  m_compress = true;
+  headers.erase(Header::CONTENT_LENGTH);
+  headers[Header::TRANSFER_ENCODING] = Header::Value::TRANSFER_ENCODING_CHUNKED;
+  if(m_format == oatpp::encoding::Zlib::FORMAT_GZIP) {
+    headers[Header::CONTENT_ENCODING] = Header::Value::CONTENT_ENCODING_GZIP;
+  } else {
+    headers[Header::CONTENT_ENCODING] = Header::Value::CONTENT_ENCODING_DEFLATE;
+  }
+  headers.add(Header::VARY, Header::ACCEPT_ENCODING);
+  
+}
+  
+void CompressedBody::writeToStream(const std::shared_ptr<OutputStream>& stream) noexcept {
+  
+  if(!m_compress) {
+    m_body->writeToStream(stream);
+    return;
+  }
+  
+  auto deflateStream = oatpp::encoding::Zlib::DeflateStream::createShared(std::make_shared<ChunkedEncoderStream>(stream),
+                                                                          m_format,
+                                                                          m_level);
+  m_body->writeToStream(deflateStream);
+  if(deflateStream->finish()) {
+    oatpp::data::stream::writeExactSizeData(stream.get(), "0\r\n\r\n", 5);
+  }
+  
+}
+  
+bool CompressedBody::appendToVector(IOVector& vector) noexcept {
+  if(m_compress) {
+    return false;
+  }
+  return m_body->appendToVector(vector);
+}
+  
+oatpp::async::Action CompressedBody::writeToStreamAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                                                        const Action& actionOnFinish,
+                                                        const std::shared_ptr<OutputStream>& stream) {
+  
+  if(!m_compress) {
+    return m_body->writeToStreamAsync(parentCoroutine, actionOnFinish, stream);
+  }
+  
+  return parentCoroutine->startCoroutine<DeflateCoroutine>(actionOnFinish, m_body, stream, m_format, m_level);
+  
+}
+  
+}}}}}
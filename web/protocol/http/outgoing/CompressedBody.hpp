@@ -0,0 +1,117 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_web_protocol_http_outgoing_CompressedBody_hpp
+#define oatpp_web_protocol_http_outgoing_CompressedBody_hpp
+
+#include "./Body.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+#include "oatpp/encoding/Zlib.hpp"
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
+  
+/**
+ * Body decorator compressing other body with gzip or deflate.
+ * Compressed body is sent chunked - its size is not known beforehand.
+ * Bodies smaller than minSize, bodies with Content-Encoding already set,
+ * ranges and bodies sending their own chunked framing are sent as is.
+ * Available if oatpp is built with zlib (OATPP_ZLIB is defined).
+ */
+class CompressedBody : public oatpp::base::Controllable, public Body {
+public:
+  OBJECT_POOL(Http_Outgoing_CompressedBody_Pool, CompressedBody, 32)
+  SHARED_OBJECT_POOL(Shared_Http_Outgoing_CompressedBody_Pool, CompressedBody, 32)
+public:
+  static constexpr v_int32 DEFAULT_MIN_SIZE = 1024;
+private:
+  std::shared_ptr<Body> m_body;
+  v_int32 m_format;
+  v_int32 m_level;
+  v_int64 m_minSize;
+  bool m_compress;
+public:
+  CompressedBody(const std::shared_ptr<Body>& body, v_int32 format, v_int32 level, v_int64 minSize)
+    : m_body(body)
+    , m_format(format)
+    , m_level(level)
+    , m_minSize(minSize)
+    , m_compress(false)
+  {}
+public:
+  
+  /**
+   * @format - oatpp::encoding::Zlib::FORMAT_GZIP or FORMAT_DEFLATE.
+   * @level - zlib compression level, 1..9 or Zlib::LEVEL_DEFAULT.
+   * @minSize - bodies with Content-Length less than that are not compressed.
+   */
+  static std::shared_ptr<CompressedBody> createShared(const std::shared_ptr<Body>& body,
+                                                      v_int32 format,
+                                                      v_int32 level = oatpp::encoding::Zlib::LEVEL_DEFAULT,
+                                                      v_int64 minSize = DEFAULT_MIN_SIZE) {
+    return Shared_Http_Outgoing_CompressedBody_Pool::allocateShared(body, format, level, minSize);
+  }
+  
+  /**
+   * Choose format by Accept-Encoding request headers. gzip is preferred on equal q-values.
+   * Returns -1 if neither gzip nor deflate is acceptable.
+   */
+  static v_int32 chooseFormat(const Protocol::Headers& requestHeaders);
+  
+  /**
+   * Wrap @body if client accepts gzip or deflate. Returns @body itself otherwise.
+   */
+  static std::shared_ptr<Body> createIfAccepted(const std::shared_ptr<Body>& body,
+                                                const Protocol::Headers& requestHeaders,
+                                                v_int32 level = oatpp::encoding::Zlib::LEVEL_DEFAULT,
+                                                v_int64 minSize = DEFAULT_MIN_SIZE);
+  
+  /**
+   * True if body is compressed. Known after declareHeaders().
+   */
+  bool isCompressed() const {
+    return m_compress;
+  }
+  
+  void declareHeaders(Headers& headers) noexcept override;
+  
+  /**
+   * Compresses and writes chunks on the go - memory use doesn't depend on body size.
+   */
+  void writeToStream(const std::shared_ptr<OutputStream>& stream) noexcept override;
+  
+  bool appendToVector(IOVector& vector) noexcept override;
+  
+  /**
+   * Wrapped body is written to compressing stream which sends one chunk at a time without blocking -
+   * memory use doesn't depend on body size.
+   */
+  Action writeToStreamAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                            const Action& actionOnFinish,
+                            const std::shared_ptr<OutputStream>& stream) override;
+  
+};
+  
+}}}}}
+
+#endif /* oatpp_web_protocol_http_outgoing_CompressedBody_hpp */
@@ -0,0 +1,119 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "FileBody.hpp"
+
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
+  
+FileBody::~FileBody() {
+  oatpp::os::io::Library::handle_close(m_handle);
+}
+  
+std::shared_ptr<FileBody> FileBody::createShared(const char* filename) {
+  v_handle handle = ::open(filename, O_RDONLY);
+  if(handle < 0) {
+    return nullptr;
+  }
+  struct stat info;
+  if(fstat(handle, &info) != 0 || !S_ISREG(info.st_mode)) {
+    oatpp::os::io::Library::handle_close(handle);
+    return nullptr;
+  }
+  return Shared_Http_Outgoing_FileBody_Pool::allocateShared(handle, (v_size) info.st_size);
+}
+  
+bool FileBody::setRange(const Range& range) {
+  
+  if(!range.isValid() || !range.units->equals(Range::UNIT_BYTES)) {
+    return false;
+  }
+  
+  v_size start = range.start;
+  v_size end = range.end;
+  
+  if(start < 0) { // suffix range - last "end" bytes
+    if(end <= 0) {
+      return false;
+    }
+    start = end < m_fileSize ? m_fileSize - end : 0;
+    end = m_fileSize - 1;
+  } else if(end < 0 || end >= m_fileSize) {
+    end = m_fileSize - 1;
+  }
+  
+  if(start >= m_fileSize || end < start) {
+    return false;
+  }
+  
+  m_offset = start;
+  m_size = end - start + 1;
+  return true;
+  
+}
+  
+void FileBody::declareHeaders(Headers& headers) noexcept {
+  headers[Header::CONTENT_LENGTH] = oatpp::utils::conversion::int64ToStr(m_size);
+}
+  
+void FileBody::writeToStream(const std::shared_ptr<OutputStream>& stream) noexcept {
+  v_size offset = m_offset;
+  v_size bytesLeft = m_size;
+  while(bytesLeft > 0) {
+    auto res = stream->writeFile(m_handle, offset, bytesLeft);
+    if(res > 0) {
+      bytesLeft -= res;
+    } else if(res != oatpp::data::stream::Errors::ERROR_IO_RETRY && res != oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
+      return;
+    }
+  }
+}
+  
+oatpp::async::Action FileBody::WriteToStreamCoroutine::act() {
+  
+  if(m_bytesLeft == 0) {
+    return finish();
+  }
+  
+  auto res = m_stream->writeFile(m_body->m_handle, m_offset, m_bytesLeft);
+  if(res == oatpp::data::stream::Errors::ERROR_IO_WAIT_RETRY) {
+    return m_stream->getWriteWaitAction();
+  } else if(res == oatpp::data::stream::Errors::ERROR_IO_RETRY) {
+    return repeat();
+  } else if(res == oatpp::data::stream::Errors::ERROR_IO_PIPE) {
+    return abort();
+  } else if(res <= 0) {
+    return error(oatpp::data::stream::Errors::ERROR_ASYNC_FAILED_TO_WRITE_DATA);
+  }
+  
+  m_bytesLeft -= res;
+  return repeat();
+  
+}
+  
+}}}}}
@@ -0,0 +1,123 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_web_protocol_http_outgoing_FileBody_hpp
+#define oatpp_web_protocol_http_outgoing_FileBody_hpp
+
+#include "./Body.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
+  
+/**
+ * Body sending file (or its range) straight from the file descriptor.
+ * File is not loaded to memory - connection copies it in kernel with sendfile().
+ */
+class FileBody : public oatpp::base::Controllable, public Body {
+public:
+  OBJECT_POOL(Http_Outgoing_FileBody_Pool, FileBody, 32)
+  SHARED_OBJECT_POOL(Shared_Http_Outgoing_FileBody_Pool, FileBody, 32)
+public:
+  typedef oatpp::os::io::Library::v_handle v_handle;
+  typedef oatpp::os::io::Library::v_size v_size;
+private:
+  v_handle m_handle;
+  v_size m_fileSize;
+  v_size m_offset;
+  v_size m_size;
+public:
+  /**
+   * Takes ownership of @handle.
+   */
+  FileBody(v_handle handle, v_size fileSize)
+    : m_handle(handle)
+    , m_fileSize(fileSize)
+    , m_offset(0)
+    , m_size(fileSize)
+  {}
+  
+  ~FileBody();
+public:
+  
+  /**
+   * Open file for reading. nullptr if file can't be opened.
+   */
+  static std::shared_ptr<FileBody> createShared(const char* filename);
+  
+  /**
+   * Send only the @range of the file.
+   * Returns false if range is not satisfiable - whole file is sent then.
+   */
+  bool setRange(const Range& range);
+  
+  /**
+   * Range being sent, for the Content-Range header.
+   */
+  ContentRange getContentRange() const {
+    return ContentRange(ContentRange::UNIT_BYTES, m_offset, m_offset + m_size - 1, m_fileSize, true);
+  }
+  
+  v_size getFileSize() const {
+    return m_fileSize;
+  }
+  
+  void declareHeaders(Headers& headers) noexcept override;
+  
+  void writeToStream(const std::shared_ptr<OutputStream>& stream) noexcept override;
+  
+public:
+  
+  class WriteToStreamCoroutine : public oatpp::async::Coroutine<WriteToStreamCoroutine> {
+  private:
+    std::shared_ptr<FileBody> m_body;
+    std::shared_ptr<OutputStream> m_stream;
+    v_size m_offset;
+    v_size m_bytesLeft;
+  public:
+    
+    WriteToStreamCoroutine(const std::shared_ptr<FileBody>& body,
+                           const std::shared_ptr<OutputStream>& stream)
+      : m_body(body)
+      , m_stream(stream)
+      , m_offset(body->m_offset)
+      , m_bytesLeft(body->m_size)
+    {}
+    
+    Action act() override;
+    
+  };
+  
+public:
+  
+  Action writeToStreamAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                            const Action& actionOnReturn,
+                            const std::shared_ptr<OutputStream>& stream) override {
+    return parentCoroutine->startCoroutine<WriteToStreamCoroutine>(actionOnReturn, getSharedPtr<FileBody>(), stream);
+  }
+  
+};
+  
+}}}}}
+
+#endif /* oatpp_web_protocol_http_outgoing_FileBody_hpp */
@@ -83,7 +83,7 @@ public:
   bool putHeaderIfNotExists(const oatpp::data::share::StringKeyLabelCI_FAST& key, const oatpp::data::share::StringKeyLabel& value) {
     auto it = m_headers.find(key);
     if(it == m_headers.end()) {
-      m_headers.insert({key, value});
+      m_headers.add(key, value);
       return true;
     }
     return false;
@@ -24,35 +24,69 @@
 
 #include "./Response.hpp"
 
-#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+#include "oatpp/core/utils/ConversionUtils.hpp"
 
 namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
   
-void Response::send(const std::shared_ptr<data::stream::OutputStream>& stream) {
+bool Response::prepareVector(data::stream::IOVector& vector, p_char8 headBuffer) {
   
-  if(m_body){
-    m_body->declareHeaders(m_headers);
+  auto statusLine = StatusLine::get(m_status);
+  if(statusLine) {
+    vector.add(statusLine->data, statusLine->size);
   } else {
-    m_headers[Header::CONTENT_LENGTH] = "0";
+    std::memcpy(headBuffer, "HTTP/1.1 ", 9);
+    v_int32 size = 9 + utils::conversion::int32ToCharSequence(m_status.code, &headBuffer[9]);
+    headBuffer[size ++] = ' ';
+    vector.add(headBuffer, size);
+    vector.add(m_status.description, std::strlen(m_status.description));
+    vector.add("\r\n", 2);
   }
   
-  stream->write("HTTP/1.1 ", 9);
-  stream->writeAsString(m_status.code);
-  stream->write(" ", 1);
-  stream->OutputStream::write(m_status.description);
-  stream->write("\r\n", 2);
+  /* body header lines go right after the status line. Headers set by user take precedence over prepared lines */
+  if(m_body){
+    if(m_headers.findById(Header::ID_CONTENT_TYPE) != m_headers.end() ||
+       m_headers.findById(Header::ID_CONTENT_LENGTH) != m_headers.end() ||
+       !m_body->appendPreparedHeaders(vector))
+    {
+      m_body->declareHeaders(m_headers);
+    }
+  } else if(m_status.code >= 200 && m_status.code != 204 && m_status.code != 304) {
+    /* 1xx, 204 and 304 have no body and must not declare its length (RFC 7230 3.3.2) */
+    m_headers[Header::CONTENT_LENGTH] = "0";
+  }
   
   auto it = m_headers.begin();
   while(it != m_headers.end()) {
-    stream->write(it->first.getData(), it->first.getSize());
-    stream->write(": ", 2);
-    stream->write(it->second.getData(), it->second.getSize());
-    stream->write("\r\n", 2);
+    vector.add(it->first.getData(), it->first.getSize());
+    vector.add(": ", 2);
+    vector.add(it->second.getData(), it->second.getSize());
+    vector.add("\r\n", 2);
     it ++;
   }
   
-  stream->write("\r\n", 2);
+  p_char8 commonHeaders = &headBuffer[STATUS_BUFFER_SIZE];
+  v_int32 commonHeadersSize = CommonHeaders::getThreadInstance().copyTo(commonHeaders,
+                                                                         m_headers.findById(Header::ID_DATE) == m_headers.end(),
+                                                                         m_headers.findById(Header::ID_SERVER) == m_headers.end());
+  vector.add(commonHeaders, commonHeadersSize);
+  
+  vector.add("\r\n", 2);
+  
   if(m_body) {
+    return m_body->appendToVector(vector);
+  }
+  return true;
+  
+}
+  
+void Response::send(const std::shared_ptr<data::stream::OutputStream>& stream) {
+  
+  v_char8 headBuffer[HEAD_BUFFER_SIZE];
+  data::stream::IOVector vector;
+  bool bodyInVector = prepareVector(vector, headBuffer);
+  
+  vector.writeToStream(stream.get());
+  if(!bodyInVector) {
     m_body->writeToStream(stream);
   }
   
@@ -66,51 +100,29 @@ oatpp::async::Action Response::sendAsync(oatpp::async::AbstractCoroutine* parent
   private:
     std::shared_ptr<Response> m_response;
     std::shared_ptr<data::stream::OutputStream> m_stream;
-    std::shared_ptr<oatpp::data::stream::ChunkedBuffer> m_buffer;
+    data::stream::IOVector m_vector;
+    v_char8 m_headBuffer[HEAD_BUFFER_SIZE];
+    bool m_bodyInVector;
   public:
     
     SendAsyncCoroutine(const std::shared_ptr<Response>& response,
                        const std::shared_ptr<data::stream::OutputStream>& stream)
       : m_response(response)
       , m_stream(stream)
-      , m_buffer(oatpp::data::stream::ChunkedBuffer::createShared())
+      , m_bodyInVector(false)
     {}
     
     Action act() {
-    
-      if(m_response->m_body){
-        m_response->m_body->declareHeaders(m_response->m_headers);
-      } else {
-        m_response->m_headers[Header::CONTENT_LENGTH] = "0";
-      }
-      
-      m_buffer->write("HTTP/1.1 ", 9);
-      m_buffer->writeAsString(m_response->m_status.code);
-      m_buffer->write(" ", 1);
-      m_buffer->OutputStream::write(m_response->m_status.description);
-      m_buffer->write("\r\n", 2);
-      
-      auto it = m_response->m_headers.begin();
-      while(it != m_response->m_headers.end()) {
-        m_buffer->write(it->first.getData(), it->first.getSize());
-        m_buffer->write(": ", 2);
-        m_buffer->write(it->second.getData(), it->second.getSize());
-        m_buffer->write("\r\n", 2);
-        it ++;
-      }
-      
-      m_buffer->write("\r\n", 2);
-      
-      return yieldTo(&SendAsyncCoroutine::writeHeaders);
-    
+      m_bodyInVector = m_response->prepareVector(m_vector, m_headBuffer);
+      return yieldTo(&SendAsyncCoroutine::writeVector);
     }
     
-    Action writeHeaders() {
-      return m_buffer->flushToStreamAsync(this, yieldTo(&SendAsyncCoroutine::writeBody), m_stream);
+    Action writeVector() {
+      return m_vector.writeAsyncInline(m_stream.get(), yieldTo(&SendAsyncCoroutine::writeBody));
     }
     
     Action writeBody() {
-      if(m_response->m_body) {
+      if(!m_bodyInVector) {
         return m_response->m_body->writeToStreamAsync(this, finish(), m_stream);
       }
       return finish();
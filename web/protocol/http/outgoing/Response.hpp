@@ -26,6 +26,7 @@
 #define oatpp_web_protocol_http_outgoing_Response_hpp
 
 #include "oatpp/web/protocol/http/outgoing/Body.hpp"
+#include "oatpp/web/protocol/http/outgoing/CommonHeaders.hpp"
 #include "oatpp/web/protocol/http/Http.hpp"
 #include "oatpp/network/server/ConnectionHandler.hpp"
 #include "oatpp/core/async/Coroutine.hpp"
@@ -43,6 +44,18 @@ private:
   Headers m_headers;
   std::shared_ptr<Body> m_body;
   std::shared_ptr<oatpp::network::server::ConnectionHandler> m_connectionUpgradeHandler;
+private:
+  
+  static constexpr v_int32 STATUS_BUFFER_SIZE = 32;
+  static constexpr v_int32 HEAD_BUFFER_SIZE = STATUS_BUFFER_SIZE + CommonHeaders::MAX_SIZE;
+  
+  /**
+   * Put status line, headers and, if possible, body to @vector - to be sent with one gather write.
+   * @headBuffer - HEAD_BUFFER_SIZE bytes for the formatted status code and Date/Server block. Must outlive the vector.
+   * Returns true if body was added to the vector.
+   */
+  bool prepareVector(data::stream::IOVector& vector, p_char8 headBuffer);
+  
 public:
   Response(const Status& status,
            const std::shared_ptr<Body>& body)
@@ -56,6 +69,15 @@ public:
     return Shared_Outgoing_Response_Pool::allocateShared(status, body);
   }
   
+  /**
+   * Allocate response on the request arena. See incoming::Request::getArena().
+   */
+  static std::shared_ptr<Response> createShared(oatpp::base::memory::Arena& arena,
+                                                const Status& status,
+                                                const std::shared_ptr<Body>& body) {
+    return oatpp::base::memory::arenaAllocateShared<Response>(arena, status, body);
+  }
+  
   const Status& getStatus() const {
     return m_status;
   }
@@ -64,6 +86,10 @@ public:
     return m_headers;
   }
   
+  std::shared_ptr<Body> getBody() const {
+    return m_body;
+  }
+  
   void putHeader(const oatpp::data::share::StringKeyLabelCI_FAST& key, const oatpp::data::share::StringKeyLabel& value) {
     m_headers[key] = value;
   }
@@ -71,7 +97,7 @@ public:
   bool putHeaderIfNotExists(const oatpp::data::share::StringKeyLabelCI_FAST& key, const oatpp::data::share::StringKeyLabel& value) {
     auto it = m_headers.find(key);
     if(it == m_headers.end()) {
-      m_headers.insert({key, value});
+      m_headers.add(key, value);
       return true;
     }
     return false;
@@ -27,6 +27,7 @@
 #include "./BufferBody.hpp"
 #include "./ChunkedBufferBody.hpp"
 #include "./DtoBody.hpp"
+#include "./FileBody.hpp"
 
 namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
   
@@ -46,6 +47,35 @@ ResponseFactory::createShared(const Status& status,
                         oatpp::data::mapping::ObjectMapper* objectMapper) {
   return Response::createShared(status, DtoBody::createShared(dto, objectMapper));
 }
+  
+std::shared_ptr<Response>
+ResponseFactory::createFileResponse(const char* filename, const oatpp::String& range) {
+  
+  auto body = FileBody::createShared(filename);
+  if(!body) {
+    return createShared(Status::CODE_404, "File not found");
+  }
+  
+  if(range) {
+    auto parsedRange = Range::parse(range);
+    if(body->setRange(parsedRange)) {
+      auto response = Response::createShared(Status::CODE_206, body);
+      response->putHeader(Header::CONTENT_RANGE, body->getContentRange().toString());
+      response->putHeader(Header::ACCEPT_RANGES, Range::UNIT_BYTES);
+      return response;
+    }
+    if(parsedRange.isValid() && parsedRange.units->equals(Range::UNIT_BYTES)) {
+      auto response = Response::createShared(Status::CODE_416, nullptr);
+      response->putHeader(Header::CONTENT_RANGE, oatpp::String("bytes */") + oatpp::utils::conversion::int64ToStr(body->getFileSize()));
+      return response;
+    }
+  }
+  
+  auto response = Response::createShared(Status::CODE_200, body);
+  response->putHeader(Header::ACCEPT_RANGES, Range::UNIT_BYTES);
+  return response;
+  
+}
 
   
 }}}}}
@@ -42,6 +42,13 @@ public:
                               const oatpp::data::mapping::type::AbstractObjectWrapper& dto,
                               oatpp::data::mapping::ObjectMapper* objectMapper);
   
+  /**
+   * Response with file sent by FileBody - not loaded to memory.
+   * @range - value of the request "Range" header, may be nullptr.
+   * 206 with Content-Range for satisfiable range, 416 for unsatisfiable one, 404 if file can't be opened.
+   */
+  static std::shared_ptr<Response> createFileResponse(const char* filename, const oatpp::String& range);
+  
 };
   
 }}}}}
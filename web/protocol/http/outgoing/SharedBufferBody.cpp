@@ -0,0 +1,79 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "SharedBufferBody.hpp"
+
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
+  
+SharedBufferBody::SharedBufferBody(const oatpp::String& buffer, const oatpp::String& contentType)
+  : m_buffer(buffer ? oatpp::String((const char*) buffer->getData(), buffer->getSize(), true) : oatpp::String("", 0, true))
+  , m_contentType(contentType ? oatpp::String((const char*) contentType->getData(), contentType->getSize(), true) : nullptr)
+  , m_contentLength(oatpp::utils::conversion::int64ToStr(m_buffer->getSize()))
+{
+  m_preparedHeaders = oatpp::String(Header::CONTENT_LENGTH) + ": " + m_contentLength + "\r\n";
+  if(m_contentType) {
+    m_preparedHeaders = m_preparedHeaders + Header::CONTENT_TYPE + ": " + m_contentType + "\r\n";
+  }
+}
+  
+void SharedBufferBody::declareHeaders(Headers& headers) noexcept {
+  headers[Header::CONTENT_LENGTH] = m_contentLength;
+  if(m_contentType && headers.findById(Header::ID_CONTENT_TYPE) == headers.end()) {
+    headers.add(Header::CONTENT_TYPE, m_contentType);
+  }
+}
+  
+oatpp::async::Action SharedBufferBody::writeToStreamAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                                                          const Action& actionOnReturn,
+                                                          const std::shared_ptr<OutputStream>& stream) {
+  
+  class WriteToStreamCoroutine : public oatpp::async::Coroutine<WriteToStreamCoroutine> {
+  private:
+    std::shared_ptr<SharedBufferBody> m_body;
+    std::shared_ptr<OutputStream> m_stream;
+    const void* m_currData;
+    oatpp::os::io::Library::v_size m_currDataSize;
+  public:
+    
+    WriteToStreamCoroutine(const std::shared_ptr<SharedBufferBody>& body,
+                           const std::shared_ptr<OutputStream>& stream)
+      : m_body(body)
+      , m_stream(stream)
+      , m_currData(m_body->m_buffer->getData())
+      , m_currDataSize(m_body->m_buffer->getSize())
+    {}
+    
+    Action act() override {
+      return oatpp::data::stream::writeExactSizeDataAsyncInline(m_stream.get(), m_currData, m_currDataSize, finish());
+    }
+    
+  };
+  
+  return parentCoroutine->startCoroutine<WriteToStreamCoroutine>(actionOnReturn, getSharedPtr<SharedBufferBody>(), stream);
+  
+}
+  
+}}}}}
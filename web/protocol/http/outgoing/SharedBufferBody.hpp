@@ -0,0 +1,92 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_web_protocol_http_outgoing_SharedBufferBody_hpp
+#define oatpp_web_protocol_http_outgoing_SharedBufferBody_hpp
+
+#include "./Body.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
+  
+/**
+ * Immutable body for static payloads - health checks, API docs, config blobs.
+ * Body bytes and its header lines ("Content-Length: ...\r\n") are prepared once on creation,
+ * so one instance can be sent by many responses on many threads at the same time:
+ * Response::createShared(Status::CODE_200, body).
+ */
+class SharedBufferBody : public oatpp::base::Controllable, public Body {
+private:
+  oatpp::String m_buffer;
+  oatpp::String m_contentType;
+  oatpp::String m_contentLength;
+  oatpp::String m_preparedHeaders;
+public:
+  /**
+   * @buffer is copied - changes of the original string don't affect the body.
+   * @contentType - Content-Type declared by the body. nullptr - not declared.
+   */
+  SharedBufferBody(const oatpp::String& buffer, const oatpp::String& contentType);
+public:
+  
+  static std::shared_ptr<SharedBufferBody> createShared(const oatpp::String& buffer, const oatpp::String& contentType = nullptr) {
+    return std::make_shared<SharedBufferBody>(buffer, contentType);
+  }
+  
+  const oatpp::String& getBuffer() const {
+    return m_buffer;
+  }
+  
+  /**
+   * Used by body decorators and by responses with Content-Type set by user.
+   * Otherwise Response takes prepared header lines with appendPreparedHeaders().
+   */
+  void declareHeaders(Headers& headers) noexcept override;
+  
+  bool appendPreparedHeaders(IOVector& vector) noexcept override {
+    vector.add(m_preparedHeaders->getData(), m_preparedHeaders->getSize());
+    return true;
+  }
+  
+  void writeToStream(const std::shared_ptr<OutputStream>& stream) noexcept override {
+    oatpp::data::stream::writeExactSizeData(stream.get(), m_buffer->getData(), m_buffer->getSize());
+  }
+  
+  bool appendToVector(IOVector& vector) noexcept override {
+    vector.add(m_buffer->getData(), m_buffer->getSize());
+    return true;
+  }
+  
+  /**
+   * Body is always written together with headers by appendToVector().
+   */
+  Action writeToStreamAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                            const Action& actionOnReturn,
+                            const std::shared_ptr<OutputStream>& stream) override;
+  
+};
+  
+}}}}}
+
+#endif /* oatpp_web_protocol_http_outgoing_SharedBufferBody_hpp */
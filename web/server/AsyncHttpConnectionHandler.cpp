@@ -39,19 +39,45 @@ namespace oatpp { namespace web { namespace server {
 void AsyncHttpConnectionHandler::handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection){
   
   auto ioBuffer = oatpp::data::buffer::IOBuffer::createShared();
-  auto outStream = oatpp::data::stream::OutputStreamBufferedProxy::createShared(connection, ioBuffer);
+  /* Separate buffers - bytes of pipelined request stay in the input buffer while response is written */
+  auto outStream = oatpp::data::stream::OutputStreamBufferedProxy::createShared(connection, oatpp::data::buffer::IOBuffer::createShared());
   auto inStream = oatpp::data::stream::InputStreamBufferedProxy::createShared(connection, ioBuffer);
   
   m_executor->execute<HttpProcessor::Coroutine>(m_router.get(),
                                                 m_bodyDecoder,
                                                 m_errorHandler,
                                                 &m_requestInterceptors,
+                                                &m_responseInterceptors,
                                                 connection,
+                                                HttpProcessor::createHeadersBuffer(),
                                                 ioBuffer,
                                                 outStream,
                                                 inStream);
   
 }
   
+void AsyncHttpConnectionHandler::handleConnectionOnThread(const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
+                                                          v_int32 threadIndex)
+{
+  
+  auto ioBuffer = oatpp::data::buffer::IOBuffer::createShared();
+  /* Separate buffers - bytes of pipelined request stay in the input buffer while response is written */
+  auto outStream = oatpp::data::stream::OutputStreamBufferedProxy::createShared(connection, oatpp::data::buffer::IOBuffer::createShared());
+  auto inStream = oatpp::data::stream::InputStreamBufferedProxy::createShared(connection, ioBuffer);
+  
+  m_executor->executeOn<HttpProcessor::Coroutine>(threadIndex,
+                                                  m_router.get(),
+                                                  m_bodyDecoder,
+                                                  m_errorHandler,
+                                                  &m_requestInterceptors,
+                                                  &m_responseInterceptors,
+                                                  connection,
+                                                  HttpProcessor::createHeadersBuffer(),
+                                                  ioBuffer,
+                                                  outStream,
+                                                  inStream);
+  
+}
+  
 }}}
 
@@ -49,7 +49,8 @@ private:
   std::shared_ptr<HttpRouter> m_router;
   std::shared_ptr<handler::ErrorHandler> m_errorHandler;
   HttpProcessor::RequestInterceptors m_requestInterceptors;
-  std::shared_ptr<const BodyDecoder> m_bodyDecoder; // TODO make bodyDecoder configurable here
+  HttpProcessor::ResponseInterceptors m_responseInterceptors;
+  std::shared_ptr<const BodyDecoder> m_bodyDecoder;
 public:
   
   AsyncHttpConnectionHandler(const std::shared_ptr<HttpRouter>& router,
@@ -88,12 +89,36 @@ public:
     }
   }
   
+  /**
+   * Set decoder used for request bodies. Ex.: SimpleBodyDecoder with max body size.
+   * nullptr resets to default SimpleBodyDecoder.
+   */
+  void setBodyDecoder(const std::shared_ptr<const BodyDecoder>& bodyDecoder) {
+    m_bodyDecoder = bodyDecoder;
+    if(!m_bodyDecoder) {
+      m_bodyDecoder = std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>();
+    }
+  }
+  
   void addRequestInterceptor(const std::shared_ptr<handler::RequestInterceptor>& interceptor) {
     m_requestInterceptors.pushBack(interceptor);
   }
   
+  void addResponseInterceptor(const std::shared_ptr<handler::ResponseInterceptor>& interceptor) {
+    m_responseInterceptors.pushBack(interceptor);
+  }
+  
   void handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) override;
   
+  /**
+   * Process connection on executor thread @threadIndex. See network::server::MultiAcceptorServer.
+   */
+  void handleConnectionOnThread(const std::shared_ptr<oatpp::data::stream::IOStream>& connection, v_int32 threadIndex) override;
+  
+  std::shared_ptr<oatpp::async::Executor> getExecutor() {
+    return m_executor;
+  }
+  
   void stop() {
     m_executor->stop();
   }
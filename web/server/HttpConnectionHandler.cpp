@@ -26,30 +26,44 @@
 
 #include "oatpp/web/protocol/http/outgoing/ChunkedBufferBody.hpp"
 #include "oatpp/web/protocol/http/outgoing/CommunicationUtils.hpp"
+#include "oatpp/web/protocol/http/outgoing/ResponseFactory.hpp"
 #include "oatpp/web/protocol/http/incoming/Request.hpp"
 #include "oatpp/web/protocol/http/Http.hpp"
 
+#include "oatpp/network/Connection.hpp"
+
 namespace oatpp { namespace web { namespace server {
   
 void HttpConnectionHandler::Task::run(){
   
   v_int32 bufferSize = oatpp::data::buffer::IOBuffer::BUFFER_SIZE;
   v_char8 buffer [bufferSize];
+  v_char8 outBuffer [bufferSize];
+  auto headersBuffer = HttpProcessor::createHeadersBuffer();
+  oatpp::base::memory::Arena arena;
   
-  auto outStream = oatpp::data::stream::OutputStreamBufferedProxy::createShared(m_connection, buffer, bufferSize);
+  /* Separate buffers - bytes of pipelined request stay in the input buffer while response is written */
+  auto outStream = oatpp::data::stream::OutputStreamBufferedProxy::createShared(m_connection, outBuffer, bufferSize);
   auto inStream = oatpp::data::stream::InputStreamBufferedProxy::createShared(m_connection, buffer, bufferSize);
   
   v_int32 connectionState = oatpp::web::protocol::http::outgoing::CommunicationUtils::CONNECTION_STATE_CLOSE;
   std::shared_ptr<oatpp::web::protocol::http::outgoing::Response> response;
   do {
   
-    response = HttpProcessor::processRequest(m_router, m_connection, m_bodyDecoder, m_errorHandler, m_requestInterceptors, buffer, bufferSize, inStream, connectionState);
+    /* Release previous request graph so the arena block is rewound for the next request */
+    response.reset();
+    response = HttpProcessor::processRequest(m_router, m_connection, m_bodyDecoder, m_errorHandler, m_requestInterceptors, m_responseInterceptors, headersBuffer, buffer, bufferSize, inStream, arena, connectionState);
     
     if(response) {
-      outStream->setBufferPosition(0, 0);
+      bool pipelined = connectionState == oatpp::web::protocol::http::outgoing::CommunicationUtils::CONNECTION_STATE_KEEP_ALIVE &&
+                       HttpProcessor::hasPipelinedRequest(inStream);
+      outStream->setBatching(pipelined);
       response->send(outStream);
-      outStream->flush();
+      if(!pipelined) {
+        outStream->flush();
+      }
     } else {
+      outStream->flush();
       return;
     }
     
@@ -66,10 +80,143 @@ void HttpConnectionHandler::Task::run(){
   
 }
   
+void HttpConnectionHandler::Worker::run() {
+  m_handler->runWorker(m_index);
+}
+  
+HttpConnectionHandler::HttpConnectionHandler(const std::shared_ptr<HttpRouter>& router)
+  : m_router(router)
+  , m_bodyDecoder(std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>())
+  , m_errorHandler(handler::DefaultErrorHandler::createShared())
+  , m_workersCount(0)
+  , m_queueSize(0)
+  , m_overloadPolicy(OVERLOAD_POLICY_REJECT)
+  , m_workers(nullptr)
+  , m_activeConnections(nullptr)
+  , m_waitingWorkers(0)
+  , m_isRunning(true)
+  , m_queueDepth(0)
+  , m_activeWorkers(0)
+  , m_rejectedConnections(0)
+{}
+  
+HttpConnectionHandler::HttpConnectionHandler(const std::shared_ptr<HttpRouter>& router,
+                                             v_int32 workersCount,
+                                             v_int32 queueSize,
+                                             v_int32 overloadPolicy)
+  : m_router(router)
+  , m_bodyDecoder(std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>())
+  , m_errorHandler(handler::DefaultErrorHandler::createShared())
+  , m_workersCount(workersCount)
+  , m_queueSize(queueSize)
+  , m_overloadPolicy(overloadPolicy)
+  , m_workers(new std::shared_ptr<oatpp::concurrency::Thread>[workersCount])
+  , m_activeConnections(new std::shared_ptr<oatpp::data::stream::IOStream>[workersCount])
+  , m_waitingWorkers(0)
+  , m_isRunning(true)
+  , m_queueDepth(0)
+  , m_activeWorkers(0)
+  , m_rejectedConnections(0)
+{
+  for(v_int32 i = 0; i < m_workersCount; i ++) {
+    m_workers[i] = oatpp::concurrency::Thread::createShared(std::make_shared<Worker>(this, i));
+  }
+}
+  
+HttpConnectionHandler::~HttpConnectionHandler() {
+  if(m_workers != nullptr) {
+    stop();
+    for(v_int32 i = 0; i < m_workersCount; i ++) {
+      m_workers[i]->join();
+    }
+    delete [] m_workers;
+    delete [] m_activeConnections;
+  }
+}
+  
+std::shared_ptr<oatpp::data::stream::IOStream> HttpConnectionHandler::takeConnection(v_int32 workerIndex) {
+  std::unique_lock<std::mutex> lock(m_queueMutex);
+  m_activeConnections[workerIndex].reset();
+  while(m_isRunning && m_queue.count() == 0) {
+    ++ m_waitingWorkers;
+    /* acceptor blocked by OVERLOAD_POLICY_BLOCK may now hand connection to this worker */
+    m_acceptorCondition.notify_one();
+    m_workersCondition.wait(lock);
+    -- m_waitingWorkers;
+  }
+  if(!m_isRunning) {
+    return nullptr;
+  }
+  auto connection = m_queue.popFront();
+  m_activeConnections[workerIndex] = connection;
+  m_queueDepth = m_queue.count();
+  ++ m_activeWorkers;
+  m_acceptorCondition.notify_one();
+  return connection;
+}
+  
+void HttpConnectionHandler::runWorker(v_int32 workerIndex) {
+  while(true) {
+    auto connection = takeConnection(workerIndex);
+    if(!connection) {
+      return;
+    }
+    Task task(m_router.get(), connection, m_bodyDecoder, m_errorHandler, &m_requestInterceptors, &m_responseInterceptors);
+    task.run();
+    -- m_activeWorkers;
+  }
+}
+  
+void HttpConnectionHandler::rejectConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) {
+  
+  auto response = oatpp::web::protocol::http::outgoing::ResponseFactory::createShared(oatpp::web::protocol::http::Status::CODE_503,
+                                                                                      "Service Unavailable");
+  response->putHeader(oatpp::web::protocol::http::Header::CONNECTION, oatpp::web::protocol::http::Header::Value::CONNECTION_CLOSE);
+  
+  /* Response is small. It fits the socket buffer of a fresh connection so accepting thread is not blocked here */
+  v_char8 buffer[256];
+  auto outStream = oatpp::data::stream::OutputStreamBufferedProxy::createShared(connection, buffer, 256);
+  response->send(outStream);
+  outStream->flush();
+  
+  /* Closing socket with unread request data makes OS send RST and client may lose the response */
+  auto socket = std::dynamic_pointer_cast<oatpp::network::Connection>(connection);
+  if(socket) {
+    socket->shutdownWrite();
+  }
+  
+}
+  
 void HttpConnectionHandler::handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection){
   
+  if(m_workersCount > 0) {
+    
+    {
+      std::unique_lock<std::mutex> lock(m_queueMutex);
+      /* Connections picked by waiting workers don't occupy the queue */
+      if(m_overloadPolicy == OVERLOAD_POLICY_BLOCK) {
+        while(m_isRunning && m_queue.count() >= m_queueSize + m_waitingWorkers) {
+          m_acceptorCondition.wait(lock);
+        }
+      }
+      if(m_isRunning && m_queue.count() < m_queueSize + m_waitingWorkers) {
+        m_queue.pushBack(connection);
+        m_queueDepth = m_queue.count();
+        m_workersCondition.notify_one();
+        return;
+      }
+    }
+    
+    ++ m_rejectedConnections;
+    if(m_overloadPolicy == OVERLOAD_POLICY_REJECT) {
+      rejectConnection(connection);
+    }
+    return;
+    
+  }
+  
   /* Create working thread */
-  concurrency::Thread thread(Task::createShared(m_router.get(), connection, m_bodyDecoder, m_errorHandler, &m_requestInterceptors));
+  concurrency::Thread thread(Task::createShared(m_router.get(), connection, m_bodyDecoder, m_errorHandler, &m_requestInterceptors, &m_responseInterceptors));
   
   /* Get hardware concurrency -1 in order to have 1cpu free of workers. */
   v_int32 concurrency = oatpp::concurrency::Thread::getHardwareConcurrency();
@@ -82,5 +229,20 @@ void HttpConnectionHandler::handleConnection(const std::shared_ptr<oatpp::data::
   
   thread.detach();
 }
+  
+void HttpConnectionHandler::stop() {
+  std::lock_guard<std::mutex> lock(m_queueMutex);
+  m_isRunning = false;
+  m_queue.clear();
+  m_queueDepth = 0;
+  for(v_int32 i = 0; i < m_workersCount; i ++) {
+    auto socket = std::dynamic_pointer_cast<oatpp::network::Connection>(m_activeConnections[i]);
+    if(socket) {
+      socket->shutdown();
+    }
+  }
+  m_workersCondition.notify_all();
+  m_acceptorCondition.notify_all();
+}
 
 }}}
@@ -40,6 +40,12 @@
 #include "oatpp/core/data/stream/StreamBufferedProxy.hpp"
 #include "oatpp/core/data/buffer/IOBuffer.hpp"
 
+#include "oatpp/core/collection/LinkedList.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
 namespace oatpp { namespace web { namespace server {
   
 class HttpConnectionHandler : public base::Controllable, public network::server::ConnectionHandler {
@@ -52,17 +58,20 @@ private:
     std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder> m_bodyDecoder;
     std::shared_ptr<handler::ErrorHandler> m_errorHandler;
     HttpProcessor::RequestInterceptors* m_requestInterceptors;
+    HttpProcessor::ResponseInterceptors* m_responseInterceptors;
   public:
     Task(HttpRouter* router,
          const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
          const std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder>& bodyDecoder,
          const std::shared_ptr<handler::ErrorHandler>& errorHandler,
-         HttpProcessor::RequestInterceptors* requestInterceptors)
+         HttpProcessor::RequestInterceptors* requestInterceptors,
+         HttpProcessor::ResponseInterceptors* responseInterceptors)
       : m_router(router)
       , m_connection(connection)
       , m_bodyDecoder(bodyDecoder)
       , m_errorHandler(errorHandler)
       , m_requestInterceptors(requestInterceptors)
+      , m_responseInterceptors(responseInterceptors)
     {}
   public:
     
@@ -70,31 +79,101 @@ private:
                                               const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
                                               const std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder>& bodyDecoder,
                                               const std::shared_ptr<handler::ErrorHandler>& errorHandler,
-                                              HttpProcessor::RequestInterceptors* requestInterceptors) {
-      return std::make_shared<Task>(router, connection, bodyDecoder, errorHandler, requestInterceptors);
+                                              HttpProcessor::RequestInterceptors* requestInterceptors,
+                                              HttpProcessor::ResponseInterceptors* responseInterceptors) {
+      return std::make_shared<Task>(router, connection, bodyDecoder, errorHandler, requestInterceptors, responseInterceptors);
     }
     
     void run() override;
     
   };
   
+  class Worker : public base::Controllable, public concurrency::Runnable {
+  private:
+    HttpConnectionHandler* m_handler;
+    v_int32 m_index;
+  public:
+    Worker(HttpConnectionHandler* handler, v_int32 index)
+      : m_handler(handler)
+      , m_index(index)
+    {}
+  public:
+    
+    void run() override;
+    
+  };
+  
+public:
+  /**
+   * Connection which doesn't fit the queue gets "503 Service Unavailable" response and is closed.
+   */
+  static constexpr v_int32 OVERLOAD_POLICY_REJECT = 0;
+  /**
+   * handleConnection() blocks until there is a place in the queue.
+   * Server stops accepting and new connections wait in the OS listen backlog.
+   */
+  static constexpr v_int32 OVERLOAD_POLICY_BLOCK = 1;
+  /**
+   * Connection which doesn't fit the queue is closed without response.
+   */
+  static constexpr v_int32 OVERLOAD_POLICY_CLOSE = 2;
+private:
+  std::shared_ptr<oatpp::data::stream::IOStream> takeConnection(v_int32 workerIndex);
+  void runWorker(v_int32 workerIndex);
+  void rejectConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection);
 private:
   std::shared_ptr<HttpRouter> m_router;
   std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder> m_bodyDecoder;
   std::shared_ptr<handler::ErrorHandler> m_errorHandler;
   HttpProcessor::RequestInterceptors m_requestInterceptors;
+  HttpProcessor::ResponseInterceptors m_responseInterceptors;
+private:
+  v_int32 m_workersCount; // 0 - thread per connection
+  v_int32 m_queueSize;
+  v_int32 m_overloadPolicy;
+  std::shared_ptr<oatpp::concurrency::Thread>* m_workers;
+  std::shared_ptr<oatpp::data::stream::IOStream>* m_activeConnections;
+  oatpp::collection::LinkedList<std::shared_ptr<oatpp::data::stream::IOStream>> m_queue;
+  v_int32 m_waitingWorkers;
+  bool m_isRunning;
+  std::mutex m_queueMutex;
+  std::condition_variable m_workersCondition;
+  std::condition_variable m_acceptorCondition;
+private:
+  std::atomic<v_int32> m_queueDepth;
+  std::atomic<v_int32> m_activeWorkers;
+  std::atomic<v_int64> m_rejectedConnections;
 public:
-  HttpConnectionHandler(const std::shared_ptr<HttpRouter>& router)
-    : m_router(router)
-    , m_bodyDecoder(std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>())
-    , m_errorHandler(handler::DefaultErrorHandler::createShared())
-  {}
+  
+  /**
+   * Thread per connection.
+   */
+  HttpConnectionHandler(const std::shared_ptr<HttpRouter>& router);
+  
+  /**
+   * Fixed pool of @workersCount threads.
+   * Up to @queueSize accepted connections wait for a free worker, the rest are handled according to @overloadPolicy.
+   */
+  HttpConnectionHandler(const std::shared_ptr<HttpRouter>& router,
+                        v_int32 workersCount,
+                        v_int32 queueSize = OATPP_HTTP_CONNECTION_HANDLER_QUEUE_SIZE_DEFAULT,
+                        v_int32 overloadPolicy = OVERLOAD_POLICY_REJECT);
+  
+  ~HttpConnectionHandler();
+  
 public:
   
   static std::shared_ptr<HttpConnectionHandler> createShared(const std::shared_ptr<HttpRouter>& router){
     return std::make_shared<HttpConnectionHandler>(router);
   }
   
+  static std::shared_ptr<HttpConnectionHandler> createShared(const std::shared_ptr<HttpRouter>& router,
+                                                             v_int32 workersCount,
+                                                             v_int32 queueSize = OATPP_HTTP_CONNECTION_HANDLER_QUEUE_SIZE_DEFAULT,
+                                                             v_int32 overloadPolicy = OVERLOAD_POLICY_REJECT){
+    return std::make_shared<HttpConnectionHandler>(router, workersCount, queueSize, overloadPolicy);
+  }
+  
   void setErrorHandler(const std::shared_ptr<handler::ErrorHandler>& errorHandler){
     m_errorHandler = errorHandler;
     if(!m_errorHandler) {
@@ -102,12 +181,55 @@ public:
     }
   }
   
+  /**
+   * Set decoder used for request bodies. Ex.: SimpleBodyDecoder with max body size.
+   * nullptr resets to default SimpleBodyDecoder.
+   */
+  void setBodyDecoder(const std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder>& bodyDecoder) {
+    m_bodyDecoder = bodyDecoder;
+    if(!m_bodyDecoder) {
+      m_bodyDecoder = std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>();
+    }
+  }
+  
   void addRequestInterceptor(const std::shared_ptr<handler::RequestInterceptor>& interceptor) {
     m_requestInterceptors.pushBack(interceptor);
   }
   
+  void addResponseInterceptor(const std::shared_ptr<handler::ResponseInterceptor>& interceptor) {
+    m_responseInterceptors.pushBack(interceptor);
+  }
+  
   void handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) override;
   
+  /**
+   * Stop worker threads. Queued connections are closed.
+   * Active connections backed by OS sockets (&id:oatpp::network::Connection;) are shut down so that workers return promptly.
+   * Workers finish active connections of other stream types (ex.: virtual_::Socket) before exiting.
+   */
+  void stop();
+  
+  /**
+   * Number of accepted connections waiting for a free worker.
+   */
+  v_int32 getQueueDepth() const {
+    return m_queueDepth;
+  }
+  
+  /**
+   * Number of workers currently processing connections.
+   */
+  v_int32 getActiveWorkersCount() const {
+    return m_activeWorkers;
+  }
+  
+  /**
+   * Total number of connections rejected or closed due to overload.
+   */
+  v_int64 getRejectedConnectionsCount() const {
+    return m_rejectedConnections;
+  }
+  
 };
   
 }}}
@@ -24,20 +24,81 @@
 
 #include "HttpProcessor.hpp"
 
+#include "oatpp/core/parser/CharScanner.hpp"
+
 namespace oatpp { namespace web { namespace server {
 
+void HttpProcessor::prepareHeadersBuffer(std::shared_ptr<oatpp::base::StrBuffer>& headersBuffer) {
+  if(headersBuffer.use_count() > 1) {
+    headersBuffer = createHeadersBuffer();
+  }
+}
+  
+void HttpProcessor::passBodyPrefix(const RequestHeadersReader::Result& headersReadResult,
+                                   const std::shared_ptr<oatpp::base::StrBuffer>& headersBuffer,
+                                   void* buffer,
+                                   const std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy>& inStream)
+{
+  v_int32 size = headersReadResult.bufferPosEnd - headersReadResult.bufferPosStart;
+  if(size > 0) {
+    std::memcpy(buffer, &headersBuffer->getData()[headersReadResult.bufferPosStart], size);
+  }
+  inStream->setBufferPosition(0, size);
+}
+  
+v_int32 HttpProcessor::passHeadersPrefix(const std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy>& inStream,
+                                         const std::shared_ptr<oatpp::base::StrBuffer>& headersBuffer)
+{
+  v_int32 size = inStream->getBufferedSize();
+  if(size > 0) {
+    std::memmove(headersBuffer->getData(), inStream->getBufferedData(), size);
+  } else {
+    size = 0;
+  }
+  inStream->setBufferPosition(0, 0);
+  return size;
+}
+  
+void HttpProcessor::closeConnection(const std::shared_ptr<protocol::http::outgoing::Response>& response) {
+  response->putHeader(protocol::http::Header::CONNECTION, protocol::http::Header::Value::CONNECTION_CLOSE);
+}
+  
+bool HttpProcessor::hasPipelinedRequest(const std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy>& inStream) {
+  v_int32 size = inStream->getBufferedSize();
+  return size > 0 && oatpp::parser::CharScanner::findRNRN(inStream->getBufferedData(), size) >= 0;
+}
+  
+std::shared_ptr<protocol::http::outgoing::Response>
+HttpProcessor::interceptResponse(ResponseInterceptors* responseInterceptors,
+                                 const std::shared_ptr<protocol::http::incoming::Request>& request,
+                                 const std::shared_ptr<protocol::http::outgoing::Response>& response) {
+  std::shared_ptr<protocol::http::outgoing::Response> result = response;
+  auto currInterceptor = responseInterceptors->getFirstNode();
+  while (currInterceptor != nullptr) {
+    result = currInterceptor->getData()->intercept(request, result);
+    currInterceptor = currInterceptor->getNext();
+  }
+  return result;
+}
+  
 std::shared_ptr<protocol::http::outgoing::Response>
 HttpProcessor::processRequest(HttpRouter* router,
                               const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
                               const std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder>& bodyDecoder,
                               const std::shared_ptr<handler::ErrorHandler>& errorHandler,
                               RequestInterceptors* requestInterceptors,
+                              ResponseInterceptors* responseInterceptors,
+                              std::shared_ptr<oatpp::base::StrBuffer>& headersBuffer,
                               void* buffer,
-                              v_int32 bufferSize,
+                              v_int32 /* bufferSize */,
                               const std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy>& inStream,
+                              oatpp::base::memory::Arena& arena,
                               v_int32& connectionState) {
   
-  RequestHeadersReader headersReader(buffer, bufferSize, 4096);
+  arena.reset();
+  prepareHeadersBuffer(headersBuffer);
+  
+  RequestHeadersReader headersReader(headersBuffer, 4096, passHeadersPrefix(inStream, headersBuffer));
   oatpp::web::protocol::http::HttpError::Info error;
   auto headersReadResult = headersReader.readHeaders(connection, error);
   
@@ -51,6 +112,9 @@ HttpProcessor::processRequest(HttpRouter* router,
     return nullptr; // connection is in invalid state. should be dropped
   }
   
+  auto& bodyStream = inStream;
+  passBodyPrefix(headersReadResult, headersBuffer, buffer, bodyStream);
+  
   auto route = router->getRoute(headersReadResult.startingLine.method, headersReadResult.startingLine.path);
   
   if(!route) {
@@ -58,14 +122,13 @@ HttpProcessor::processRequest(HttpRouter* router,
     return errorHandler->handleError(protocol::http::Status::CODE_404, "Current url has no mapping");
   }
   
-  auto& bodyStream = inStream;
-  bodyStream->setBufferPosition(headersReadResult.bufferPosStart, headersReadResult.bufferPosEnd);
-  
-  auto request = protocol::http::incoming::Request::createShared(headersReadResult.startingLine,
+  auto request = protocol::http::incoming::Request::createShared(arena,
+                                                                 headersReadResult.startingLine,
                                                                  route.matchMap,
                                                                  headersReadResult.headers,
                                                                  bodyStream,
                                                                  bodyDecoder);
+  request->setRoutePattern(route.getPattern());
   
   std::shared_ptr<protocol::http::outgoing::Response> response;
   try{
@@ -78,17 +141,21 @@ HttpProcessor::processRequest(HttpRouter* router,
       currInterceptor = currInterceptor->getNext();
     }
     if(!response) {
-      response = route.processUrl(request);
+      response = interceptResponse(responseInterceptors, request, route.processUrl(request));
     }
   } catch (oatpp::web::protocol::http::HttpError& error) {
-    return errorHandler->handleError(error.getInfo().status, error.getMessage());
+    response = errorHandler->handleError(error.getInfo().status, error.getMessage());
   } catch (std::exception& error) {
-    return errorHandler->handleError(protocol::http::Status::CODE_500, error.what());
+    response = errorHandler->handleError(protocol::http::Status::CODE_500, error.what());
   } catch (...) {
-    return errorHandler->handleError(protocol::http::Status::CODE_500, "Unknown error");
+    response = errorHandler->handleError(protocol::http::Status::CODE_500, "Unknown error");
   }
   
-  response->putHeaderIfNotExists(protocol::http::Header::SERVER, protocol::http::Header::Value::SERVER);
+  request->detachArena();
+  
+  if(!request->isBodyDone()) {
+    closeConnection(response);
+  }
   
   connectionState = oatpp::web::protocol::http::outgoing::CommunicationUtils::considerConnectionState(request, response);
   return response;
@@ -99,21 +166,23 @@ HttpProcessor::processRequest(HttpRouter* router,
   
 oatpp::async::Action HttpProcessor::Coroutine::onHeadersParsed(const RequestHeadersReader::Result& headersReadResult) {
   
-  m_currentRoute = m_router->getRoute(headersReadResult.startingLine.method.toString(), headersReadResult.startingLine.path.toString());
+  auto& bodyStream = m_inStream;
+  passBodyPrefix(headersReadResult, m_headersBuffer, m_ioBuffer->getData(), bodyStream);
+  
+  m_currentRoute = m_router->getRoute(headersReadResult.startingLine.method, headersReadResult.startingLine.path);
   
   if(!m_currentRoute) {
     m_currentResponse = m_errorHandler->handleError(protocol::http::Status::CODE_404, "Current url has no mapping");
     return yieldTo(&HttpProcessor::Coroutine::onResponseFormed);
   }
   
-  auto& bodyStream = m_inStream;
-  bodyStream->setBufferPosition(headersReadResult.bufferPosStart, headersReadResult.bufferPosEnd);
-  
-  m_currentRequest = protocol::http::incoming::Request::createShared(headersReadResult.startingLine,
+  m_currentRequest = protocol::http::incoming::Request::createShared(m_arena,
+                                                                     headersReadResult.startingLine,
                                                                      m_currentRoute.matchMap,
                                                                      headersReadResult.headers,
                                                                      bodyStream,
                                                                      m_bodyDecoder);
+  m_currentRequest->setRoutePattern(m_currentRoute.getPattern());
   
   auto currInterceptor = m_requestInterceptors->getFirstNode();
   while (currInterceptor != nullptr) {
@@ -129,8 +198,10 @@ oatpp::async::Action HttpProcessor::Coroutine::onHeadersParsed(const RequestHead
 }
   
 HttpProcessor::Coroutine::Action HttpProcessor::Coroutine::act() {
+  m_arena.reset();
+  prepareHeadersBuffer(m_headersBuffer);
   RequestHeadersReader::AsyncCallback callback = static_cast<RequestHeadersReader::AsyncCallback>(&HttpProcessor::Coroutine::onHeadersParsed);
-  RequestHeadersReader headersReader(m_ioBuffer->getData(), m_ioBuffer->getSize(), 4096);
+  RequestHeadersReader headersReader(m_headersBuffer, 4096, passHeadersPrefix(m_inStream, m_headersBuffer));
   return headersReader.readHeadersAsync(this, callback, m_connection);
 }
 
@@ -141,15 +212,29 @@ HttpProcessor::Coroutine::Action HttpProcessor::Coroutine::onRequestFormed() {
 }
 
 HttpProcessor::Coroutine::Action HttpProcessor::Coroutine::onResponse(const std::shared_ptr<protocol::http::outgoing::Response>& response) {
-  m_currentResponse = response;
+  m_currentResponse = interceptResponse(m_responseInterceptors, m_currentRequest, response);
   return yieldTo(&HttpProcessor::Coroutine::onResponseFormed);
 }
   
 HttpProcessor::Coroutine::Action HttpProcessor::Coroutine::onResponseFormed() {
   
-  m_currentResponse->putHeaderIfNotExists(protocol::http::Header::SERVER, protocol::http::Header::Value::SERVER);
+  if(m_currentRequest) {
+    m_currentRequest->detachArena();
+    if(!m_currentRequest->isBodyDone()) {
+      closeConnection(m_currentResponse);
+    }
+  }
+  
   m_connectionState = oatpp::web::protocol::http::outgoing::CommunicationUtils::considerConnectionState(m_currentRequest, m_currentResponse);
-  m_outStream->setBufferPosition(0, 0);
+  
+  if(m_connectionState == oatpp::web::protocol::http::outgoing::CommunicationUtils::CONNECTION_STATE_KEEP_ALIVE &&
+     hasPipelinedRequest(m_inStream))
+  {
+    m_outStream->setBatching(true);
+    return m_currentResponse->sendAsync(this, yieldTo(&HttpProcessor::Coroutine::onRequestDone), m_outStream);
+  }
+  
+  m_outStream->setBatching(false);
   return m_currentResponse->sendAsync(this,
                                       m_outStream->flushAsync(
                                                               this,
@@ -161,6 +246,10 @@ HttpProcessor::Coroutine::Action HttpProcessor::Coroutine::onResponseFormed() {
 HttpProcessor::Coroutine::Action HttpProcessor::Coroutine::onRequestDone() {
   
   if(m_connectionState == oatpp::web::protocol::http::outgoing::CommunicationUtils::CONNECTION_STATE_KEEP_ALIVE) {
+    /* Release request graph so the arena block is rewound and the headers buffer can be reused for the next request */
+    m_currentRoute = HttpRouter::BranchRouter::Route();
+    m_currentRequest.reset();
+    m_currentResponse.reset();
     return yieldTo(&HttpProcessor::Coroutine::act);
   }
   
@@ -198,6 +287,8 @@ HttpProcessor::Coroutine::Action HttpProcessor::Coroutine::handleError(const oat
   } else {
     m_currentResponse = m_errorHandler->handleError(protocol::http::Status::CODE_500, error.message);
   }
+  /* Error may come from body decoding - state of the request body is unknown */
+  closeConnection(m_currentResponse);
   return yieldTo(&HttpProcessor::Coroutine::onResponseFormed);
 }
   
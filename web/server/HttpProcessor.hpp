@@ -44,6 +44,7 @@ namespace oatpp { namespace web { namespace server {
 class HttpProcessor {
 public:
   typedef oatpp::collection::LinkedList<std::shared_ptr<oatpp::web::server::handler::RequestInterceptor>> RequestInterceptors;
+  typedef oatpp::collection::LinkedList<std::shared_ptr<oatpp::web::server::handler::ResponseInterceptor>> ResponseInterceptors;
   typedef oatpp::web::protocol::http::incoming::RequestHeadersReader RequestHeadersReader;
 public:
   
@@ -71,11 +72,14 @@ public:
     std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder> m_bodyDecoder;
     std::shared_ptr<handler::ErrorHandler> m_errorHandler;
     RequestInterceptors* m_requestInterceptors;
+    ResponseInterceptors* m_responseInterceptors;
     std::shared_ptr<oatpp::data::stream::IOStream> m_connection;
+    std::shared_ptr<oatpp::base::StrBuffer> m_headersBuffer;
     std::shared_ptr<oatpp::data::buffer::IOBuffer> m_ioBuffer;
     std::shared_ptr<oatpp::data::stream::OutputStreamBufferedProxy> m_outStream;
     std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy> m_inStream;
     v_int32 m_connectionState;
+    oatpp::base::memory::Arena m_arena;
   private:
     oatpp::web::server::HttpRouter::BranchRouter::Route m_currentRoute;
     std::shared_ptr<protocol::http::incoming::Request> m_currentRequest;
@@ -86,7 +90,9 @@ public:
               const std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder>& bodyDecoder,
               const std::shared_ptr<handler::ErrorHandler>& errorHandler,
               RequestInterceptors* requestInterceptors,
+              ResponseInterceptors* responseInterceptors,
               const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
+              const std::shared_ptr<oatpp::base::StrBuffer>& headersBuffer,
               const std::shared_ptr<oatpp::data::buffer::IOBuffer>& ioBuffer,
               const std::shared_ptr<oatpp::data::stream::OutputStreamBufferedProxy>& outStream,
               const std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy>& inStream)
@@ -94,7 +100,9 @@ public:
       , m_bodyDecoder(bodyDecoder)
       , m_errorHandler(errorHandler)
       , m_requestInterceptors(requestInterceptors)
+      , m_responseInterceptors(responseInterceptors)
       , m_connection(connection)
+      , m_headersBuffer(headersBuffer)
       , m_ioBuffer(ioBuffer)
       , m_outStream(outStream)
       , m_inStream(inStream)
@@ -116,15 +124,72 @@ public:
   
 public:
   
+  /**
+   * Create per-connection buffer for request headers.
+   * Headers are parsed in place there, so it must not be shared with body/response buffers.
+   */
+  static std::shared_ptr<oatpp::base::StrBuffer> createHeadersBuffer() {
+    return oatpp::base::StrBuffer::createShared(oatpp::data::buffer::IOBuffer::BUFFER_SIZE);
+  }
+  
+  /**
+   * Called before reading headers of the next request of the connection.
+   * If labels of the previous request are still alive somewhere (headers/path values kept by the application),
+   * they hold the headers buffer - then replace it with a fresh buffer instead of overwriting their data.
+   */
+  static void prepareHeadersBuffer(std::shared_ptr<oatpp::base::StrBuffer>& headersBuffer);
+  
+  /**
+   * Move bytes read beyond the headers section from headers buffer to the body stream buffer.
+   */
+  static void passBodyPrefix(const RequestHeadersReader::Result& headersReadResult,
+                             const std::shared_ptr<oatpp::base::StrBuffer>& headersBuffer,
+                             void* buffer,
+                             const std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy>& inStream);
+  
+  /**
+   * Move bytes left in the body stream buffer after previous request (pipelined request) to the headers buffer.
+   * Returns number of bytes moved.
+   */
+  static v_int32 passHeadersPrefix(const std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy>& inStream,
+                                   const std::shared_ptr<oatpp::base::StrBuffer>& headersBuffer);
+  
+  /**
+   * Make @response close the connection. Used when request body is not read till the end -
+   * the rest of the body would be parsed as the next request otherwise.
+   */
+  static void closeConnection(const std::shared_ptr<protocol::http::outgoing::Response>& response);
+  
+  /**
+   * True if headers of the next pipelined request are already read - response may wait in the out buffer
+   * to be flushed together with the next one.
+   */
+  static bool hasPipelinedRequest(const std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy>& inStream);
+  
+  /**
+   * Pass response formed by endpoint handler through @responseInterceptors.
+   */
+  static std::shared_ptr<protocol::http::outgoing::Response>
+  interceptResponse(ResponseInterceptors* responseInterceptors,
+                    const std::shared_ptr<protocol::http::incoming::Request>& request,
+                    const std::shared_ptr<protocol::http::outgoing::Response>& response);
+  
+  /**
+   * Process one request of the connection. @arena is reset here - objects it gave to the previous
+   * request of the connection should be already released by the caller.
+   */
   static std::shared_ptr<protocol::http::outgoing::Response>
   processRequest(HttpRouter* router,
                  const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
                  const std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder>& bodyDecoder,
                  const std::shared_ptr<handler::ErrorHandler>& errorHandler,
                  RequestInterceptors* requestInterceptors,
+                 ResponseInterceptors* responseInterceptors,
+                 std::shared_ptr<oatpp::base::StrBuffer>& headersBuffer,
                  void* buffer,
                  v_int32 bufferSize,
                  const std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy>& inStream,
+                 oatpp::base::memory::Arena& arena,
                  v_int32& connectionState);
   
 };
@@ -72,11 +72,23 @@ public:
                                const StringKeyLabel& url){
     auto it = m_branchMap.find(method);
     if(it != m_branchMap.end()) {
-      return m_branchMap[method]->getRoute(url);
+      return it->second->getRoute(url);
     }
     return BranchRouter::Route();
   }
   
+  /**
+   * Registered pattern of route @method @urlPattern. nullptr if there is no such route.
+   */
+  std::shared_ptr<oatpp::web::url::mapping::Pattern> getPattern(const StringKeyLabel& method,
+                                                               const oatpp::String& urlPattern) {
+    auto it = m_branchMap.find(method);
+    if(it != m_branchMap.end()) {
+      return it->second->getPattern(urlPattern);
+    }
+    return nullptr;
+  }
+  
   void logRouterMappings() {
     for(auto it : m_branchMap) {
       it.second->logRouterMappings();
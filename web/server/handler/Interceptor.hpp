@@ -53,6 +53,28 @@ public:
   
 };
   
+class ResponseInterceptor {
+public:
+  typedef oatpp::web::protocol::http::incoming::Request IncomingRequest;
+  typedef oatpp::web::protocol::http::outgoing::Response OutgoingResponse;
+public:
+  
+  /**
+   *
+   *  Called with response formed by endpoint handler before it is sent.
+   *  Same as RequestInterceptor - NOT FOR I/O operations!!!
+   *
+   *  - return @response to continue.
+   *  - return another OutgoingResponse to send it instead
+   *
+   *  possible usage ex: cache response, add headers
+   *
+   */
+  virtual std::shared_ptr<OutgoingResponse> intercept(const std::shared_ptr<IncomingRequest>& request,
+                                                      const std::shared_ptr<OutgoingResponse>& response) = 0;
+  
+};
+  
 }}}}
 
 #endif /* oatpp_web_server_handler_Interceptor_hpp */
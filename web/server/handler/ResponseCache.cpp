@@ -0,0 +1,360 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ResponseCache.hpp"
+
+#include "oatpp/web/protocol/http/outgoing/SharedBufferBody.hpp"
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+#include "oatpp/core/utils/ConversionUtils.hpp"
+#include "oatpp/algorithm/CRC.hpp"
+
+namespace oatpp { namespace web { namespace server { namespace handler {
+  
+namespace {
+  
+  typedef oatpp::web::protocol::http::Header Header;
+  typedef oatpp::web::protocol::http::Headers Headers;
+  typedef oatpp::web::protocol::http::Status Status;
+  
+  /**
+   * Body with headers already declared to the response. Used to send response which turned out not cacheable
+   * after its body had declared headers - body must not declare them twice (DtoBody serializes dto there).
+   */
+  class DeclaredBody : public oatpp::web::protocol::http::outgoing::Body {
+  private:
+    std::shared_ptr<Body> m_body;
+  public:
+    
+    DeclaredBody(const std::shared_ptr<Body>& body)
+      : m_body(body)
+    {}
+    
+    void declareHeaders(Headers& /* headers */) noexcept override {
+      // headers are already declared
+    }
+    
+    void writeToStream(const std::shared_ptr<OutputStream>& stream) noexcept override {
+      m_body->writeToStream(stream);
+    }
+    
+    bool appendToVector(IOVector& vector) noexcept override {
+      return m_body->appendToVector(vector);
+    }
+    
+    Action writeToStreamAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                              const Action& actionOnFinish,
+                              const std::shared_ptr<OutputStream>& stream) override {
+      return m_body->writeToStreamAsync(parentCoroutine, actionOnFinish, stream);
+    }
+    
+  };
+  
+  bool containsToken(const Headers::Value& value, const char* token) {
+    v_int32 tokenSize = (v_int32) std::strlen(token);
+    p_char8 data = value.getData();
+    for(v_int32 i = 0; i + tokenSize <= value.getSize(); i ++) {
+      if(oatpp::base::StrBuffer::equalsCI(&data[i], token, tokenSize)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  
+  /**
+   * If-None-Match: "etag1", W/"etag2" or *
+   */
+  bool matchesETag(const Headers& requestHeaders, const oatpp::String& etag) {
+    auto it = requestHeaders.find(Header::IF_NONE_MATCH);
+    while(it != requestHeaders.end()) {
+      p_char8 data = it->second.getData();
+      v_int32 size = it->second.getSize();
+      v_int32 pos = 0;
+      while(pos < size) {
+        while(pos < size && (data[pos] == ',' || data[pos] == ' ' || data[pos] == '\t')) pos ++;
+        v_int32 start = pos;
+        while(pos < size && data[pos] != ',') pos ++;
+        v_int32 end = pos;
+        while(end > start && (data[end - 1] == ' ' || data[end - 1] == '\t')) end --;
+        if(end - start > 2 && data[start] == 'W' && data[start + 1] == '/') {
+          start += 2;
+        }
+        if((end - start == 1 && data[start] == '*') ||
+           (end - start == etag->getSize() && std::memcmp(&data[start], etag->getData(), end - start) == 0)) {
+          return true;
+        }
+      }
+      it = requestHeaders.findNext(it);
+    }
+    return false;
+  }
+  
+}
+  
+ResponseCache::ResponseCache(v_int64 maxMemory, v_int32 shardsCount)
+  : m_maxMemory(maxMemory)
+  , m_shardsCount(shardsCount > 0 ? shardsCount : 1)
+  , m_shards(new Shard[m_shardsCount])
+  , m_hits(0)
+  , m_misses(0)
+{}
+  
+ResponseCache::~ResponseCache() {
+  delete [] m_shards;
+}
+  
+void ResponseCache::addEndpoint(const std::shared_ptr<oatpp::web::server::HttpRouter>& router,
+                                const oatpp::String& method,
+                                const oatpp::String& pathPattern,
+                                const Clock::duration& ttl) {
+  auto pattern = router->getPattern(method, pathPattern);
+  if(!pattern) {
+    throw std::runtime_error("[oatpp::web::server::handler::ResponseCache::addEndpoint()]: Error. Router has no such route");
+  }
+  m_endpoints[pattern.get()] = {pattern, ttl};
+}
+  
+const ResponseCache::Endpoint* ResponseCache::findEndpoint(const std::shared_ptr<IncomingRequest>& request) const {
+  auto it = m_endpoints.find(request->getRoutePattern());
+  if(it == m_endpoints.end()) {
+    return nullptr;
+  }
+  /* response may depend on credentials - it is not shared between users */
+  const auto& headers = request->getHeaders();
+  if(headers.find(Header::AUTHORIZATION) != headers.end() || headers.find(Header::COOKIE) != headers.end()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+  
+std::string ResponseCache::createKey(const std::shared_ptr<IncomingRequest>& request) {
+  const auto& startingLine = request->getStartingLine();
+  std::string key;
+  key.reserve(startingLine.method.getSize() + 1 + startingLine.path.getSize());
+  key.append((const char*) startingLine.method.getData(), startingLine.method.getSize());
+  key.push_back(' ');
+  key.append((const char*) startingLine.path.getData(), startingLine.path.getSize());
+  return key;
+}
+  
+ResponseCache::Shard& ResponseCache::getShard(const std::string& key) {
+  return m_shards[std::hash<std::string>()(key) % m_shardsCount];
+}
+  
+void ResponseCache::removeEntry(Shard& shard, std::list<std::shared_ptr<const Entry>>::iterator it) {
+  shard.memoryUsage -= (*it)->memorySize;
+  shard.map.erase((*it)->key);
+  shard.lru.erase(it);
+}
+  
+std::shared_ptr<const ResponseCache::Entry> ResponseCache::get(const std::string& key) {
+  Shard& shard = getShard(key);
+  std::lock_guard<std::mutex> lock(shard.lock);
+  auto it = shard.map.find(key);
+  if(it == shard.map.end()) {
+    return nullptr;
+  }
+  if((*it->second)->expiresAt <= Clock::now()) {
+    removeEntry(shard, it->second);
+    return nullptr;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  return *it->second;
+}
+  
+void ResponseCache::put(const std::shared_ptr<const Entry>& entry) {
+  Shard& shard = getShard(entry->key);
+  v_int64 shardLimit = m_maxMemory / m_shardsCount;
+  std::lock_guard<std::mutex> lock(shard.lock);
+  auto it = shard.map.find(entry->key);
+  if(it != shard.map.end()) {
+    removeEntry(shard, it->second);
+  }
+  if(entry->memorySize > shardLimit) {
+    return;
+  }
+  while(!shard.lru.empty() && shard.memoryUsage + entry->memorySize > shardLimit) {
+    removeEntry(shard, std::prev(shard.lru.end()));
+  }
+  shard.lru.push_front(entry);
+  shard.map[entry->key] = shard.lru.begin();
+  shard.memoryUsage += entry->memorySize;
+}
+  
+std::shared_ptr<const ResponseCache::Entry> ResponseCache::createEntry(std::string&& key,
+                                                                       const std::shared_ptr<OutgoingResponse>& response,
+                                                                       const Headers& headers,
+                                                                       v_int64 maxBodySize,
+                                                                       Clock::time_point expiresAt) {
+  
+  auto contentLengthIt = headers.findById(Header::ID_CONTENT_LENGTH);
+  if(contentLengthIt == headers.end() || headers.findById(Header::ID_TRANSFER_ENCODING) != headers.end()) {
+    return nullptr;
+  }
+  bool success;
+  v_int64 contentLength = oatpp::utils::conversion::strToInt64(contentLengthIt->second.toString(), success);
+  if(!success || contentLength > maxBodySize) {
+    return nullptr;
+  }
+  
+  auto buffer = oatpp::data::stream::ChunkedBuffer::createShared();
+  response->getBody()->writeToStream(buffer);
+  if(buffer->getSize() != contentLength) {
+    return nullptr;
+  }
+  
+  auto entry = std::make_shared<Entry>();
+  entry->key = std::move(key);
+  entry->status = response->getStatus();
+  entry->body = oatpp::web::protocol::http::outgoing::SharedBufferBody::createShared(buffer->toString());
+  entry->expiresAt = expiresAt;
+  entry->memorySize = sizeof(Entry) + entry->key.size() + contentLength;
+  
+  entry->headers.reserve(headers.size() + 1);
+  for(const auto& header : headers) {
+    if(header.id != Header::ID_CONTENT_LENGTH) {
+      entry->headers.push_back({header.first.toString(), header.second.toString()});
+      entry->memorySize += header.first.getSize() + header.second.getSize();
+    }
+  }
+  
+  auto etagIt = headers.find(Header::ETAG);
+  if(etagIt != headers.end()) {
+    entry->etag = etagIt->second.toString();
+  } else {
+    v_char8 etag[32];
+    v_int32 etagSize = oatpp::utils::conversion::primitiveToCharSequence(
+      oatpp::algorithm::CRC32::calc(entry->body->getBuffer()->getData(), (v_int32) contentLength), etag, "\"%08X");
+    etagSize += oatpp::utils::conversion::primitiveToCharSequence((long long) contentLength, &etag[etagSize], "-%llX\"");
+    entry->etag = oatpp::String((const char*) etag, etagSize, true);
+    entry->headers.push_back({Header::ETAG, entry->etag});
+    entry->memorySize += 4 + etagSize;
+  }
+  
+  return entry;
+  
+}
+  
+std::shared_ptr<ResponseCache::OutgoingResponse> ResponseCache::createResponse(const std::shared_ptr<IncomingRequest>& request,
+                                                                               const std::shared_ptr<const Entry>& entry) {
+  
+  if(matchesETag(request->getHeaders(), entry->etag)) {
+    auto response = OutgoingResponse::createShared(Status::CODE_304, nullptr);
+    for(const auto& header : entry->headers) {
+      if(oatpp::base::StrBuffer::equalsCI_FAST(header.first.get(), Header::ETAG) ||
+         oatpp::base::StrBuffer::equalsCI_FAST(header.first.get(), Header::CACHE_CONTROL)) {
+        response->getHeaders().add(header.first, header.second);
+      }
+    }
+    return response;
+  }
+  
+  auto response = OutgoingResponse::createShared(entry->status,
+                                                  entry->body);
+  for(const auto& header : entry->headers) {
+    response->getHeaders().add(header.first, header.second);
+  }
+  return response;
+  
+}
+  
+void ResponseCache::clear() {
+  for(v_int32 i = 0; i < m_shardsCount; i ++) {
+    Shard& shard = m_shards[i];
+    std::lock_guard<std::mutex> lock(shard.lock);
+    shard.map.clear();
+    shard.lru.clear();
+    shard.memoryUsage = 0;
+  }
+}
+  
+std::shared_ptr<ResponseCache::OutgoingResponse> ResponseCache::intercept(std::shared_ptr<IncomingRequest>& request) {
+  if(findEndpoint(request) == nullptr) {
+    return nullptr;
+  }
+  auto entry = get(createKey(request));
+  if(!entry) {
+    m_misses ++;
+    return nullptr;
+  }
+  m_hits ++;
+  return createResponse(request, entry);
+}
+  
+std::shared_ptr<ResponseCache::OutgoingResponse> ResponseCache::intercept(const std::shared_ptr<IncomingRequest>& request,
+                                                                          const std::shared_ptr<OutgoingResponse>& response) {
+  
+  if(!response || !response->getBody() || response->getStatus().code != 200 || response->getConnectionUpgradeHandler()) {
+    return response;
+  }
+  
+  const Endpoint* endpoint = findEndpoint(request);
+  if(endpoint == nullptr) {
+    return response;
+  }
+  
+  auto& headers = response->getHeaders();
+  auto cacheControlIt = headers.find(Header::CACHE_CONTROL);
+  if(headers.find(Header::VARY) != headers.end() ||
+     headers.find(Header::SET_COOKIE) != headers.end() ||
+     (cacheControlIt != headers.end() && (containsToken(cacheControlIt->second, "no-store") ||
+                                          containsToken(cacheControlIt->second, "private"))))
+  {
+    return response;
+  }
+  
+  Headers declaredHeaders = headers;
+  response->getBody()->declareHeaders(declaredHeaders);
+  
+  auto entry = createEntry(createKey(request), response, declaredHeaders, m_maxMemory / m_shardsCount, Clock::now() + endpoint->ttl);
+  if(!entry) {
+    /* body has declared its headers already - send them as they are */
+    auto result = OutgoingResponse::createShared(response->getStatus(), std::make_shared<DeclaredBody>(response->getBody()));
+    result->getHeaders() = declaredHeaders;
+    return result;
+  }
+  
+  put(entry);
+  return createResponse(request, entry);
+  
+}
+  
+v_int64 ResponseCache::getMemoryUsage() {
+  v_int64 result = 0;
+  for(v_int32 i = 0; i < m_shardsCount; i ++) {
+    std::lock_guard<std::mutex> lock(m_shards[i].lock);
+    result += m_shards[i].memoryUsage;
+  }
+  return result;
+}
+  
+v_int64 ResponseCache::getEntriesCount() {
+  v_int64 result = 0;
+  for(v_int32 i = 0; i < m_shardsCount; i ++) {
+    std::lock_guard<std::mutex> lock(m_shards[i].lock);
+    result += m_shards[i].lru.size();
+  }
+  return result;
+}
+  
+}}}}
@@ -0,0 +1,172 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_web_server_handler_ResponseCache_hpp
+#define oatpp_web_server_handler_ResponseCache_hpp
+
+#include "./Interceptor.hpp"
+
+#include "oatpp/web/server/HttpRouter.hpp"
+#include "oatpp/web/protocol/http/outgoing/SharedBufferBody.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace oatpp { namespace web { namespace server { namespace handler {
+  
+/**
+ * In-process cache of serialized responses (status, headers and body bytes) of GET endpoints.
+ * Key is method + path with query. Only routes added with addEndpoint() are cached - each with its own TTL.
+ * Route is resolved by the router already - cache finds its settings by the route pattern of the request.
+ * Cache hits skip endpoint handler and body serialization. ETag is added to cached responses,
+ * requests with matching If-None-Match get "304 Not Modified".
+ * Requests with Authorization or Cookie headers are neither served from cache nor cached.
+ *
+ * Register the same instance as request and response interceptor:
+ * handler->addRequestInterceptor(cache); handler->addResponseInterceptor(cache);
+ *
+ * Entries are kept in shards - each with its own lock and LRU list - bounded by memory.
+ * Only "200 OK" responses with Content-Length are cached.
+ * Responses with Vary, Set-Cookie or Cache-Control no-store/private are not cached.
+ */
+class ResponseCache : public oatpp::base::Controllable, public RequestInterceptor, public ResponseInterceptor {
+public:
+  typedef oatpp::web::protocol::http::incoming::Request IncomingRequest;
+  typedef oatpp::web::protocol::http::outgoing::Response OutgoingResponse;
+  typedef std::chrono::steady_clock Clock;
+public:
+  static constexpr v_int32 DEFAULT_SHARDS_COUNT = 16;
+private:
+  
+  struct Entry {
+    std::string key;
+    oatpp::web::protocol::http::Status status;
+    std::vector<std::pair<oatpp::String, oatpp::String>> headers;
+    std::shared_ptr<oatpp::web::protocol::http::outgoing::SharedBufferBody> body;
+    oatpp::String etag;
+    Clock::time_point expiresAt;
+    v_int64 memorySize;
+  };
+  
+  struct Shard {
+    std::mutex lock;
+    std::list<std::shared_ptr<const Entry>> lru; // most recently used first
+    std::unordered_map<std::string, std::list<std::shared_ptr<const Entry>>::iterator> map;
+    v_int64 memoryUsage = 0;
+  };
+  
+  struct Endpoint {
+    std::shared_ptr<oatpp::web::url::mapping::Pattern> pattern;
+    Clock::duration ttl;
+  };
+  
+private:
+  v_int64 m_maxMemory;
+  v_int32 m_shardsCount;
+  Shard* m_shards;
+  std::unordered_map<const oatpp::web::url::mapping::Pattern*, Endpoint> m_endpoints;
+  std::atomic<v_int64> m_hits;
+  std::atomic<v_int64> m_misses;
+private:
+  const Endpoint* findEndpoint(const std::shared_ptr<IncomingRequest>& request) const;
+  static std::string createKey(const std::shared_ptr<IncomingRequest>& request);
+  Shard& getShard(const std::string& key);
+  std::shared_ptr<const Entry> get(const std::string& key);
+  void put(const std::shared_ptr<const Entry>& entry);
+  static void removeEntry(Shard& shard, std::list<std::shared_ptr<const Entry>>::iterator it);
+  static std::shared_ptr<const Entry> createEntry(std::string&& key,
+                                                  const std::shared_ptr<OutgoingResponse>& response,
+                                                  const oatpp::web::protocol::http::Headers& headers,
+                                                  v_int64 maxBodySize,
+                                                  Clock::time_point expiresAt);
+  static std::shared_ptr<OutgoingResponse> createResponse(const std::shared_ptr<IncomingRequest>& request,
+                                                          const std::shared_ptr<const Entry>& entry);
+public:
+  
+  /**
+   * @maxMemory - limit of memory used by cached entries, split evenly between shards.
+   * Response bigger than shard limit is not cached.
+   */
+  ResponseCache(v_int64 maxMemory, v_int32 shardsCount = DEFAULT_SHARDS_COUNT);
+  ~ResponseCache();
+  
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+  
+  static std::shared_ptr<ResponseCache> createShared(v_int64 maxMemory, v_int32 shardsCount = DEFAULT_SHARDS_COUNT) {
+    return std::make_shared<ResponseCache>(maxMemory, shardsCount);
+  }
+  
+  /**
+   * Cache responses of route @method @pathPattern of @router for @ttl.
+   * @pathPattern is the same as the route was added to the router with - "/users/{userId}".
+   * Endpoints should be added before cache is used by the server.
+   * Throws std::runtime_error if @router has no such route.
+   */
+  void addEndpoint(const std::shared_ptr<oatpp::web::server::HttpRouter>& router,
+                   const oatpp::String& method,
+                   const oatpp::String& pathPattern,
+                   const Clock::duration& ttl);
+  
+  /**
+   * Remove all entries.
+   */
+  void clear();
+  
+  /**
+   * Cache lookup. Returns cached response or nullptr to continue with endpoint handler.
+   */
+  std::shared_ptr<OutgoingResponse> intercept(std::shared_ptr<IncomingRequest>& request) override;
+  
+  /**
+   * Store response of cached endpoint. Returns response sending stored bytes.
+   */
+  std::shared_ptr<OutgoingResponse> intercept(const std::shared_ptr<IncomingRequest>& request,
+                                              const std::shared_ptr<OutgoingResponse>& response) override;
+  
+  v_int64 getHitsCount() const {
+    return m_hits;
+  }
+  
+  v_int64 getMissesCount() const {
+    return m_misses;
+  }
+  
+  /**
+   * Memory used by cached entries - bodies, headers and keys.
+   */
+  v_int64 getMemoryUsage();
+  
+  v_int64 getEntriesCount();
+  
+};
+  
+}}}}
+
+#endif /* oatpp_web_server_handler_ResponseCache_hpp */
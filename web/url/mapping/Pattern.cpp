@@ -77,9 +77,11 @@ std::shared_ptr<Pattern> Pattern::parse(p_char8 data, v_int32 size){
       if(i > lastPos){
         auto part = Part::createShared(Part::FUNCTION_VAR, oatpp::String((const char*)&data[lastPos], i - lastPos, true));
         result->m_parts->pushBack(part);
+        result->m_variablesCount ++;
       }else{
         auto part = Part::createShared(Part::FUNCTION_VAR, oatpp::String(0));
         result->m_parts->pushBack(part);
+        result->m_variablesCount ++;
       }
       
       lastPos = i + 1;
@@ -134,6 +136,7 @@ bool Pattern::match(const StringKeyLabel& url, MatchMap& matchMap) {
   }
   
   auto curr = m_parts->getFirstNode();
+  v_int32 slot = 0;
   
   while(curr != nullptr){
     const std::shared_ptr<Part>& part = curr->getData();
@@ -169,14 +172,15 @@ bool Pattern::match(const StringKeyLabel& url, MatchMap& matchMap) {
       v_char8 a = findSysChar(caret);
       if(a == '?') {
         if(curr == nullptr || curr->getData()->function == Part::FUNCTION_ANY_END) {
-          matchMap.m_variables[part->text] = StringKeyLabel(url.getMemoryHandle(), label.getData(), label.getSize());
+          matchMap.setVariable(slot, part->text, StringKeyLabel(url.getMemoryHandle(), label.getData(), label.getSize()));
           matchMap.m_tail = StringKeyLabel(url.getMemoryHandle(), caret.getCurrData(), caret.getSize() - caret.getPosition());
           return true;
         }
         caret.findChar('/');
       }
       
-      matchMap.m_variables[part->text] = StringKeyLabel(url.getMemoryHandle(), label.getData(), label.getSize());
+      matchMap.setVariable(slot, part->text, StringKeyLabel(url.getMemoryHandle(), label.getData(), label.getSize()));
+      slot ++;
       
     }
     
@@ -191,6 +195,23 @@ bool Pattern::match(const StringKeyLabel& url, MatchMap& matchMap) {
   
 }
 
+v_int32 Pattern::getVariableSlot(const StringKeyLabel& name) const {
+  v_int32 result = -1;
+  v_int32 slot = 0;
+  auto curr = m_parts->getFirstNode();
+  while(curr != nullptr && slot < MatchMap::INLINE_CAPACITY) {
+    const std::shared_ptr<Part>& part = curr->getData();
+    curr = curr->getNext();
+    if(part->function == Part::FUNCTION_VAR) {
+      if(name == StringKeyLabel(part->text)) {
+        result = slot;
+      }
+      slot ++;
+    }
+  }
+  return result;
+}
+
 oatpp::String Pattern::toString() {
   auto stream = oatpp::data::stream::ChunkedBuffer::createShared();
   auto curr = m_parts->getFirstNode();
@@ -35,31 +35,85 @@
 
 namespace oatpp { namespace web { namespace url { namespace mapping {
   
+class PatternTree; // FWD
+  
 class Pattern : public base::Controllable{
+  friend PatternTree;
 private:
   typedef oatpp::data::share::StringKeyLabel StringKeyLabel;
 public:
   
+  /**
+   * Path variables and url tail captured by Pattern::match().
+   * Up to INLINE_CAPACITY variables are stored inline - in order of appearance in the pattern (slots).
+   * No heap allocations are made for them, and copying MatchMap is allocation-free as well.
+   * Patterns with more variables keep the extra ones in the overflow map.
+   */
   class MatchMap {
     friend Pattern;
   public:
     typedef std::unordered_map<StringKeyLabel, StringKeyLabel> Variables;
+  public:
+    static constexpr v_int32 INLINE_CAPACITY = 8;
   private:
-    Variables m_variables;
+    StringKeyLabel m_names[INLINE_CAPACITY];
+    StringKeyLabel m_values[INLINE_CAPACITY];
+    v_int32 m_count;
+    Variables m_overflow;
     StringKeyLabel m_tail;
+  private:
+    
+    void setVariable(v_int32 slot, const StringKeyLabel& name, const StringKeyLabel& value) {
+      if(slot < INLINE_CAPACITY) {
+        m_names[slot] = name;
+        m_values[slot] = value;
+        if(slot >= m_count) {
+          m_count = slot + 1;
+        }
+      } else {
+        m_overflow[name] = value;
+      }
+    }
+    
   public:
     
-    MatchMap() {}
+    MatchMap()
+      : m_count(0)
+    {}
     
     MatchMap(const Variables& vars, const StringKeyLabel& urlTail)
-      : m_variables(vars)
+      : m_count(0)
       , m_tail(urlTail)
-    {}
+    {
+      for(auto& pair : vars) {
+        setVariable(m_count, pair.first, pair.second);
+      }
+    }
     
+    /**
+     * Get variable by name. If pattern has the same name more than once, the last one is returned.
+     */
     oatpp::String getVariable(const StringKeyLabel& key) const {
-      auto it = m_variables.find(key);
-      if(it != m_variables.end()) {
-        return it->second.toString();
+      if(!m_overflow.empty()) {
+        auto it = m_overflow.find(key);
+        if(it != m_overflow.end()) {
+          return it->second.toString();
+        }
+      }
+      for(v_int32 i = m_count - 1; i >= 0; i --) {
+        if(m_names[i] == key) {
+          return m_values[i].toString();
+        }
+      }
+      return nullptr;
+    }
+    
+    /**
+     * Get variable by slot resolved with Pattern::getVariableSlot().
+     */
+    oatpp::String getVariableAt(v_int32 slot) const {
+      if(slot >= 0 && slot < m_count) {
+        return m_values[slot].toString();
       }
       return nullptr;
     }
@@ -95,11 +149,13 @@ private:
   
 private:
   std::shared_ptr<oatpp::collection::LinkedList<std::shared_ptr<Part>>> m_parts;
+  v_int32 m_variablesCount;
 private:
   v_char8 findSysChar(oatpp::parser::ParsingCaret& caret);
 public:
   Pattern()
     : m_parts(oatpp::collection::LinkedList<std::shared_ptr<Part>>::createShared())
+    , m_variablesCount(0)
   {}
 public:
   
@@ -113,6 +169,19 @@ public:
   
   bool match(const StringKeyLabel& url, MatchMap& matchMap);
   
+  /**
+   * Number of {var} parts in the pattern.
+   */
+  v_int32 getVariablesCount() const {
+    return m_variablesCount;
+  }
+  
+  /**
+   * Resolve variable slot for MatchMap::getVariableAt(). Should be done once - when endpoint is registered.
+   * Returns -1 if there is no such variable or if it doesn't fit MatchMap inline storage.
+   */
+  v_int32 getVariableSlot(const StringKeyLabel& name) const;
+  
   oatpp::String toString();
   
 };
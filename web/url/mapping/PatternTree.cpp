@@ -0,0 +1,207 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "PatternTree.hpp"
+
+namespace oatpp { namespace web { namespace url { namespace mapping {
+
+namespace {
+  
+  bool textEquals(const oatpp::String& a, const oatpp::String& b) {
+    v_int32 sizeA = a ? a->getSize() : 0;
+    v_int32 sizeB = b ? b->getSize() : 0;
+    return sizeA == sizeB && (sizeA == 0 || std::memcmp(a->getData(), b->getData(), sizeA) == 0);
+  }
+  
+}
+  
+PatternTree::PatternTree()
+  : m_root(nullptr, nullptr, 0)
+  , m_count(0)
+{}
+
+v_int32 PatternTree::add(const std::shared_ptr<Pattern>& pattern) {
+  
+  v_int32 index = m_count ++;
+  if(!pattern) {
+    return index; // never matches
+  }
+  Node* node = &m_root;
+  
+  auto curr = pattern->m_parts->getFirstNode();
+  while(curr != nullptr) {
+    const std::shared_ptr<Pattern::Part>& part = curr->getData();
+    Node* next = nullptr;
+    for(Node* child : node->children) {
+      if(child->function == part->function && textEquals(child->text, part->text)) {
+        next = child;
+        break;
+      }
+    }
+    if(next == nullptr) {
+      next = new Node(part->function, part->text, index);
+      node->children.push_back(next);
+      if(part->function == Pattern::Part::FUNCTION_CONST && std::memchr(part->text->getData(), '?', part->text->getSize()) == nullptr) {
+        node->segments[oatpp::data::share::StringKeyLabel(next->text)] = next;
+      } else {
+        node->scanned.push_back(next);
+      }
+    }
+    node = next;
+    curr = curr->getNext();
+  }
+  
+  if(node->index < 0) {
+    node->index = index;
+  }
+  
+  return index;
+  
+}
+
+v_int32 PatternTree::chooseIndex(v_int32 best, v_int32 candidate) {
+  if(candidate >= 0 && (best < 0 || candidate < best)) {
+    return candidate;
+  }
+  return best;
+}
+
+v_int32 PatternTree::skipSlashes(p_char8 data, v_int32 size, v_int32 pos) {
+  while(pos < size && data[pos] == '/') {
+    pos ++;
+  }
+  return pos;
+}
+
+v_int32 PatternTree::matchQueryTail(const Node* node, v_int32 best) {
+  // Url reached '?' right after this node's part.
+  // Only patterns ending here or continuing with a tail accept the query string.
+  best = chooseIndex(best, node->index);
+  for(const Node* child : node->children) {
+    if(child->function == Pattern::Part::FUNCTION_ANY_END) {
+      best = chooseIndex(best, child->index);
+    }
+  }
+  return best;
+}
+
+v_int32 PatternTree::matchEnd(const Node* node, p_char8 data, v_int32 size, v_int32 pos, v_int32 best) {
+  if(node->index >= 0 && skipSlashes(data, size, pos) == size) {
+    return chooseIndex(best, node->index);
+  }
+  return best;
+}
+
+v_int32 PatternTree::matchChild(const Node* child, p_char8 data, v_int32 size, v_int32 start, v_int32 best) {
+  
+  if(child->function == Pattern::Part::FUNCTION_CONST) {
+    
+    v_int32 textSize = child->text->getSize();
+    if(textSize > size - start || std::memcmp(&data[start], child->text->getData(), textSize) != 0) {
+      return best;
+    }
+    v_int32 end = start + textSize;
+    if(end < size && data[end] != '/') {
+      if(data[end] == '?') {
+        best = matchQueryTail(child, best);
+      }
+      return best;
+    }
+    best = matchEnd(child, data, size, end, best);
+    return matchChildren(child, data, size, end, best);
+    
+  } else if(child->function == Pattern::Part::FUNCTION_VAR) {
+    
+    if(start >= size) {
+      return best;
+    }
+    v_int32 end = start;
+    while(end < size && data[end] != '/' && data[end] != '?') {
+      end ++;
+    }
+    if(end < size && data[end] == '?') {
+      best = matchQueryTail(child, best);
+      while(end < size && data[end] != '/') {
+        end ++;
+      }
+    } else {
+      best = matchEnd(child, data, size, end, best);
+    }
+    return matchChildren(child, data, size, end, best);
+    
+  } else if(child->function == Pattern::Part::FUNCTION_ANY_END) {
+    return chooseIndex(best, child->index);
+  }
+  
+  return best;
+  
+}
+
+v_int32 PatternTree::matchChildren(const Node* node, p_char8 data, v_int32 size, v_int32 pos, v_int32 best) {
+  
+  v_int32 start = skipSlashes(data, size, pos);
+  
+  const Node* segmentChild = nullptr;
+  if(!node->segments.empty()) {
+    v_int32 end = start;
+    while(end < size && data[end] != '/' && data[end] != '?') {
+      end ++;
+    }
+    auto it = node->segments.find(oatpp::data::share::StringKeyLabel(nullptr, &data[start], end - start));
+    if(it != node->segments.end()) {
+      segmentChild = it->second;
+    }
+  }
+  
+  /* scanned children and the segment child are tried in order of minIndex */
+  for(const Node* child : node->scanned) {
+    if(segmentChild != nullptr && segmentChild->minIndex < child->minIndex) {
+      if(best >= 0 && segmentChild->minIndex >= best) {
+        return best;
+      }
+      best = matchChild(segmentChild, data, size, start, best);
+      segmentChild = nullptr;
+    }
+    if(best >= 0 && child->minIndex >= best) {
+      return best; // nothing better left
+    }
+    best = matchChild(child, data, size, start, best);
+  }
+  
+  if(segmentChild != nullptr && (best < 0 || segmentChild->minIndex < best)) {
+    best = matchChild(segmentChild, data, size, start, best);
+  }
+  
+  return best;
+  
+}
+
+v_int32 PatternTree::match(const oatpp::data::share::StringKeyLabel& url) const {
+  p_char8 data = url.getData();
+  v_int32 size = url.getSize();
+  v_int32 best = matchEnd(&m_root, data, size, 0, -1);
+  return matchChildren(&m_root, data, size, 0, best);
+}
+  
+}}}}
@@ -0,0 +1,127 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi, <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_web_url_mapping_PatternTree_hpp
+#define oatpp_web_url_mapping_PatternTree_hpp
+
+#include "./Pattern.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace oatpp { namespace web { namespace url { namespace mapping {
+
+/**
+ * Prefix tree of url patterns. Patterns sharing leading parts share tree nodes.
+ * Const segments, {var} captures and * tails are matched in one pass over the url, without allocations.
+ * Matching is equivalent to calling Pattern::match() for each added pattern in the order of addition,
+ * and taking the first one which matches.
+ */
+class PatternTree {
+private:
+  
+  class Node {
+  public:
+    
+    Node(const char* pFunction, const oatpp::String& pText, v_int32 pMinIndex)
+      : function(pFunction)
+      , text(pText)
+      , index(-1)
+      , minIndex(pMinIndex)
+    {}
+    
+    ~Node() {
+      for(Node* child : children) {
+        delete child;
+      }
+    }
+    
+    const char* function;
+    oatpp::String text;
+    
+    /**
+     * Index of the first added pattern ending at this node. -1 if none.
+     */
+    v_int32 index;
+    
+    /**
+     * Smallest index of patterns in this subtree.
+     * Children are created in order of addition, so they are sorted by minIndex.
+     */
+    v_int32 minIndex;
+    
+    /**
+     * All children. Owned by this node.
+     */
+    std::vector<Node*> children;
+    
+    /**
+     * Const children matching whole url segment, by segment text.
+     */
+    std::unordered_map<oatpp::data::share::StringKeyLabel, Node*> segments;
+    
+    /**
+     * Children which have to be tried one by one - vars, tails and consts containing '?'.
+     */
+    std::vector<Node*> scanned;
+    
+  };
+  
+private:
+  static v_int32 chooseIndex(v_int32 best, v_int32 candidate);
+  static v_int32 skipSlashes(p_char8 data, v_int32 size, v_int32 pos);
+  static v_int32 matchQueryTail(const Node* node, v_int32 best);
+  static v_int32 matchEnd(const Node* node, p_char8 data, v_int32 size, v_int32 pos, v_int32 best);
+  static v_int32 matchChild(const Node* child, p_char8 data, v_int32 size, v_int32 start, v_int32 best);
+  static v_int32 matchChildren(const Node* node, p_char8 data, v_int32 size, v_int32 pos, v_int32 best);
+private:
+  Node m_root;
+  v_int32 m_count;
+public:
+  
+  PatternTree();
+  
+  PatternTree(const PatternTree& other) = delete;
+  PatternTree& operator=(const PatternTree& other) = delete;
+  
+  /**
+   * Add pattern. Patterns get indexes 0, 1, 2... in order of addition.
+   * Returns index of the pattern.
+   */
+  v_int32 add(const std::shared_ptr<Pattern>& pattern);
+  
+  /**
+   * Index of the first added pattern matching @url, or -1 if there is no match.
+   */
+  v_int32 match(const oatpp::data::share::StringKeyLabel& url) const;
+  
+  v_int32 getCount() const {
+    return m_count;
+  }
+  
+};
+  
+}}}}
+
+#endif /* oatpp_web_url_mapping_PatternTree_hpp */
@@ -27,8 +27,7 @@
 
 #include "./Subscriber.hpp"
 #include "./Pattern.hpp"
-
-#include "oatpp/core/collection/LinkedList.hpp"
+#include "./PatternTree.hpp"
 
 #include "oatpp/core/Types.hpp"
 
@@ -36,6 +35,8 @@
 #include "oatpp/core/base/Controllable.hpp"
 #include "oatpp/core/base/Environment.hpp"
 
+#include <vector>
+
 namespace oatpp { namespace web { namespace url { namespace mapping {
   
 template<class Param, class ReturnType>
@@ -49,14 +50,17 @@ public:
   class Route {
   private:
     UrlSubscriber* m_subscriber;
+    const Pattern* m_pattern;
   public:
     
     Route()
       : m_subscriber(nullptr)
+      , m_pattern(nullptr)
     {}
     
-    Route(UrlSubscriber* subscriber, const Pattern::MatchMap& pMatchMap)
+    Route(UrlSubscriber* subscriber, const Pattern* pattern, const Pattern::MatchMap& pMatchMap)
       : m_subscriber(subscriber)
+      , m_pattern(pattern)
       , matchMap(pMatchMap)
     {}
     
@@ -70,6 +74,14 @@ public:
       return m_subscriber->processUrlAsync(parentCoroutine, callback, param);
     }
     
+    /**
+     * Pattern of the route as registered in the router - it identifies the route.
+     * Owned by the router.
+     */
+    const Pattern* getPattern() const {
+      return m_pattern;
+    }
+    
     explicit operator bool() const {
       return m_subscriber != nullptr;
     }
@@ -98,10 +110,13 @@ public:
   };
   
 private:
-  std::shared_ptr<oatpp::collection::LinkedList<std::shared_ptr<Pair>>> m_subscribers;
+  /**
+   * Pairs in order of registration. Index in this vector is the pattern index in m_tree.
+   */
+  std::vector<std::shared_ptr<Pair>> m_subscribers;
+  PatternTree m_tree;
 public:
   Router()
-    : m_subscribers(oatpp::collection::LinkedList<std::shared_ptr<Pair>>::createShared())
   {}
 public:
   
@@ -113,27 +128,41 @@ public:
                      const std::shared_ptr<UrlSubscriber>& subscriber){
     auto pattern = Pattern::parse(urlPattern);
     auto pair = Pair::createShared(pattern, subscriber);
-    m_subscribers->pushBack(pair);
+    m_tree.add(pattern);
+    m_subscribers.push_back(pair);
   }
   
+  /**
+   * Find the first registered subscriber whose pattern matches the url.
+   * Lookup walks the compiled pattern tree and allocates nothing on a miss.
+   * Variables are captured only for the matched pattern.
+   */
   Route getRoute(const StringKeyLabel& url){
-    auto curr = m_subscribers->getFirstNode();
-    while(curr != nullptr) {
-      const std::shared_ptr<Pair>& pair = curr->getData();
-      curr = curr->getNext();
-      Pattern::MatchMap match;
-      if(pair->pattern->match(url, match)) {
-        return Route(pair->subscriber.get(), match);
+    v_int32 index = m_tree.match(url);
+    if(index < 0) {
+      return Route();
+    }
+    const std::shared_ptr<Pair>& pair = m_subscribers[index];
+    Pattern::MatchMap match;
+    pair->pattern->match(url, match);
+    return Route(pair->subscriber.get(), pair->pattern.get(), match);
+  }
+  
+  /**
+   * Registered pattern equal to @urlPattern. nullptr if there is no such route.
+   */
+  std::shared_ptr<Pattern> getPattern(const oatpp::String& urlPattern) {
+    auto text = Pattern::parse(urlPattern)->toString();
+    for(const std::shared_ptr<Pair>& pair : m_subscribers) {
+      if(pair->pattern->toString()->equals(text.get())) {
+        return pair->pattern;
       }
     }
-    return Route();
+    return nullptr;
   }
   
   void logRouterMappings() {
-    auto curr = m_subscribers->getFirstNode();
-    while(curr != nullptr){
-      const std::shared_ptr<Pair>& pair = curr->getData();
-      curr = curr->getNext();
+    for(const std::shared_ptr<Pair>& pair : m_subscribers) {
       auto mapping = pair->pattern->toString();
       OATPP_LOGD("Router", "url '%s' -> mapped", (const char*) mapping->getData());
     }